@@ -0,0 +1,483 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+// Asset cooker converts source images of the samples into DDS files that can be loaded
+// without decoding and generating mip levels at run time. It is run by the build for every
+// image in the assets folder of a sample, see add_sample_app().
+//
+// Usage: Diligent-AssetCooker [-compress] <source image> <cooked texture> [<cooked sRGB texture>]
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Image.hpp"
+#include "TextureUtilities.h"
+#include "RefCntAutoPtr.hpp"
+#include "FileWrapper.hpp"
+#include "Errors.hpp"
+#include "BlockCompression.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+// DXGI formats used by the cooked textures. Every image is cooked into a linear texture and an sRGB
+// texture; the application selects one of them at load time. Only RGBA images have sRGB formats,
+// so for other images the two textures are the same.
+constexpr Uint32 DXGIFormat_RGBA16_UNORM     = 11;
+constexpr Uint32 DXGIFormat_RGBA8_UNORM      = 28;
+constexpr Uint32 DXGIFormat_RGBA8_UNORM_SRGB = 29;
+constexpr Uint32 DXGIFormat_RG16_UNORM       = 35;
+constexpr Uint32 DXGIFormat_RG8_UNORM        = 49;
+constexpr Uint32 DXGIFormat_R16_UNORM        = 56;
+constexpr Uint32 DXGIFormat_R8_UNORM         = 61;
+constexpr Uint32 DXGIFormat_BC1_UNORM        = 71;
+constexpr Uint32 DXGIFormat_BC1_UNORM_SRGB   = 72;
+constexpr Uint32 DXGIFormat_BC3_UNORM        = 77;
+constexpr Uint32 DXGIFormat_BC3_UNORM_SRGB   = 78;
+constexpr Uint32 DXGIFormat_BC4_UNORM        = 80;
+constexpr Uint32 DXGIFormat_BC5_UNORM        = 83;
+
+struct DDSPixelFormat
+{
+    Uint32 Size;
+    Uint32 Flags;
+    Uint32 FourCC;
+    Uint32 RGBBitCount;
+    Uint32 RBitMask;
+    Uint32 GBitMask;
+    Uint32 BBitMask;
+    Uint32 ABitMask;
+};
+
+struct DDSHeader
+{
+    Uint32         Size;
+    Uint32         Flags;
+    Uint32         Height;
+    Uint32         Width;
+    Uint32         PitchOrLinearSize;
+    Uint32         Depth;
+    Uint32         MipMapCount;
+    Uint32         Reserved1[11];
+    DDSPixelFormat PixelFormat;
+    Uint32         Caps;
+    Uint32         Caps2;
+    Uint32         Caps3;
+    Uint32         Caps4;
+    Uint32         Reserved2;
+};
+static_assert(sizeof(DDSHeader) == 124, "Unexpected DDS header size");
+
+struct DDSHeaderDX10
+{
+    Uint32 DXGIFormat;
+    Uint32 ResourceDimension;
+    Uint32 MiscFlag;
+    Uint32 ArraySize;
+    Uint32 MiscFlags2;
+};
+
+constexpr Uint32 DDSMagic      = 0x20534444; // "DDS "
+constexpr Uint32 DDSFourCCDX10 = 0x30315844; // "DX10"
+
+struct MipLevel
+{
+    Uint32             Width  = 0;
+    Uint32             Height = 0;
+    std::vector<Uint8> Data;
+};
+
+struct CookedTexture
+{
+    Uint32                DXGIFormat     = 0;
+    Uint32                BlockSize      = 0; // Size of a 4x4 block for compressed formats, 0 otherwise
+    Uint32                BytesPerPixel  = 0;
+    std::vector<MipLevel> Mips;
+};
+
+// Converts the image into tightly packed pixels with 1, 2 or 4 components.
+// RGB images are expanded to RGBA as there are no three-component texture formats.
+template <typename ComponentType>
+MipLevel ConvertImage(Image& Img, Uint32 NumDstComponents)
+{
+    const auto& ImgDesc = Img.GetDesc();
+    const auto* pSrc    = reinterpret_cast<const Uint8*>(Img.GetData()->GetDataPtr());
+
+    MipLevel Mip;
+    Mip.Width  = ImgDesc.Width;
+    Mip.Height = ImgDesc.Height;
+    Mip.Data.resize(size_t{Mip.Width} * Mip.Height * NumDstComponents * sizeof(ComponentType));
+
+    auto* pDst = reinterpret_cast<ComponentType*>(Mip.Data.data());
+    for (Uint32 y = 0; y < Mip.Height; ++y)
+    {
+        const auto* pSrcRow = reinterpret_cast<const ComponentType*>(pSrc + size_t{y} * ImgDesc.RowStride);
+        for (Uint32 x = 0; x < Mip.Width; ++x)
+        {
+            auto* pDstPixel = pDst + (size_t{y} * Mip.Width + x) * NumDstComponents;
+            for (Uint32 c = 0; c < NumDstComponents; ++c)
+            {
+                pDstPixel[c] = c < ImgDesc.NumComponents ?
+                    pSrcRow[x * ImgDesc.NumComponents + c] :
+                    std::numeric_limits<ComponentType>::max();
+            }
+        }
+    }
+
+    return Mip;
+}
+
+// Computes the next mip level with a 2x2 box filter. When a dimension of the fine level is odd and
+// greater than 1, its last row or column is not sampled. A dimension of 1 is kept as is.
+template <typename ComponentType>
+MipLevel ComputeCoarseMip(const MipLevel& FineMip, Uint32 NumComponents)
+{
+    MipLevel Mip;
+    Mip.Width  = std::max(FineMip.Width / 2, 1u);
+    Mip.Height = std::max(FineMip.Height / 2, 1u);
+    Mip.Data.resize(size_t{Mip.Width} * Mip.Height * NumComponents * sizeof(ComponentType));
+
+    const auto* pSrc = reinterpret_cast<const ComponentType*>(FineMip.Data.data());
+    auto*       pDst = reinterpret_cast<ComponentType*>(Mip.Data.data());
+    for (Uint32 y = 0; y < Mip.Height; ++y)
+    {
+        const Uint32 y0 = std::min(y * 2, FineMip.Height - 1);
+        const Uint32 y1 = std::min(y * 2 + 1, FineMip.Height - 1);
+        for (Uint32 x = 0; x < Mip.Width; ++x)
+        {
+            const Uint32 x0 = std::min(x * 2, FineMip.Width - 1);
+            const Uint32 x1 = std::min(x * 2 + 1, FineMip.Width - 1);
+            for (Uint32 c = 0; c < NumComponents; ++c)
+            {
+                const Uint32 Sum =
+                    Uint32{pSrc[(size_t{y0} * FineMip.Width + x0) * NumComponents + c]} +
+                    Uint32{pSrc[(size_t{y0} * FineMip.Width + x1) * NumComponents + c]} +
+                    Uint32{pSrc[(size_t{y1} * FineMip.Width + x0) * NumComponents + c]} +
+                    Uint32{pSrc[(size_t{y1} * FineMip.Width + x1) * NumComponents + c]};
+
+                pDst[(size_t{y} * Mip.Width + x) * NumComponents + c] = static_cast<ComponentType>((Sum + 2) / 4);
+            }
+        }
+    }
+
+    return Mip;
+}
+
+float SRGBToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float c)
+{
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+}
+
+// Computes the next mip level of an 8-bit RGBA texture in sRGB color space. Color components
+// are averaged in linear space, and alpha is averaged as is. Texels are sampled in the same
+// way as in ComputeCoarseMip().
+MipLevel ComputeCoarseMipSRGB(const MipLevel& FineMip)
+{
+    static const auto ToLinear = [] {
+        std::vector<float> Table(256);
+        for (Uint32 i = 0; i < 256; ++i)
+            Table[i] = SRGBToLinear(static_cast<float>(i) / 255.f);
+        return Table;
+    }();
+
+    MipLevel Mip;
+    Mip.Width  = std::max(FineMip.Width / 2, 1u);
+    Mip.Height = std::max(FineMip.Height / 2, 1u);
+    Mip.Data.resize(size_t{Mip.Width} * Mip.Height * 4);
+
+    const auto* pSrc = FineMip.Data.data();
+    auto*       pDst = Mip.Data.data();
+    for (Uint32 y = 0; y < Mip.Height; ++y)
+    {
+        const Uint32 y0 = std::min(y * 2, FineMip.Height - 1);
+        const Uint32 y1 = std::min(y * 2 + 1, FineMip.Height - 1);
+        for (Uint32 x = 0; x < Mip.Width; ++x)
+        {
+            const Uint32 x0 = std::min(x * 2, FineMip.Width - 1);
+            const Uint32 x1 = std::min(x * 2 + 1, FineMip.Width - 1);
+
+            const Uint8* Texels[] = {
+                pSrc + (size_t{y0} * FineMip.Width + x0) * 4,
+                pSrc + (size_t{y0} * FineMip.Width + x1) * 4,
+                pSrc + (size_t{y1} * FineMip.Width + x0) * 4,
+                pSrc + (size_t{y1} * FineMip.Width + x1) * 4,
+            };
+
+            auto* pDstTexel = pDst + (size_t{y} * Mip.Width + x) * 4;
+            for (Uint32 c = 0; c < 3; ++c)
+            {
+                const float Linear = (ToLinear[Texels[0][c]] + ToLinear[Texels[1][c]] + ToLinear[Texels[2][c]] + ToLinear[Texels[3][c]]) * 0.25f;
+                pDstTexel[c]       = static_cast<Uint8>(std::min(LinearToSRGB(Linear) * 255.f + 0.5f, 255.f));
+            }
+            pDstTexel[3] = static_cast<Uint8>((Uint32{Texels[0][3]} + Texels[1][3] + Texels[2][3] + Texels[3][3] + 2) / 4);
+        }
+    }
+
+    return Mip;
+}
+
+template <typename ComponentType>
+void GenerateMips(CookedTexture& Tex, Image& Img, Uint32 NumComponents, bool SRGB)
+{
+    Tex.Mips.emplace_back(ConvertImage<ComponentType>(Img, NumComponents));
+    while (Tex.Mips.back().Width > 1 || Tex.Mips.back().Height > 1)
+    {
+        if (SRGB)
+            Tex.Mips.emplace_back(ComputeCoarseMipSRGB(Tex.Mips.back()));
+        else
+            Tex.Mips.emplace_back(ComputeCoarseMip<ComponentType>(Tex.Mips.back(), NumComponents));
+    }
+}
+
+bool IsOpaque(const MipLevel& Mip)
+{
+    for (size_t i = 3; i < Mip.Data.size(); i += 4)
+    {
+        if (Mip.Data[i] != 0xFF)
+            return false;
+    }
+    return true;
+}
+
+// Compresses all mip levels of an 8-bit texture in place. Blocks that extend past
+// the edge of small mip levels are padded by repeating the last row and column.
+void CompressMips(CookedTexture& Tex, Uint32 NumComponents, void (*CompressBlock)(const Uint8*, Uint8*))
+{
+    for (auto& Mip : Tex.Mips)
+    {
+        const Uint32 NumBlocksX = (Mip.Width + 3) / 4;
+        const Uint32 NumBlocksY = (Mip.Height + 3) / 4;
+
+        std::vector<Uint8> Blocks(size_t{NumBlocksX} * NumBlocksY * Tex.BlockSize);
+        Uint8              BlockPixels[16 * 4];
+        for (Uint32 by = 0; by < NumBlocksY; ++by)
+        {
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                for (Uint32 i = 0; i < 16; ++i)
+                {
+                    const Uint32 x = std::min(bx * 4 + i % 4, Mip.Width - 1);
+                    const Uint32 y = std::min(by * 4 + i / 4, Mip.Height - 1);
+                    memcpy(BlockPixels + i * NumComponents, &Mip.Data[(size_t{y} * Mip.Width + x) * NumComponents], NumComponents);
+                }
+                CompressBlock(BlockPixels, &Blocks[(size_t{by} * NumBlocksX + bx) * Tex.BlockSize]);
+            }
+        }
+        Mip.Data.swap(Blocks);
+    }
+}
+
+// When SRGB is true, RGBA images are cooked into a texture with sRGB format whose mip levels
+// are filtered in linear space. Other images are cooked in the same way as when SRGB is false.
+bool CookTexture(Image& Img, const Char* SrcPath, bool Compress, bool SRGB, CookedTexture& Tex)
+{
+    const auto& ImgDesc       = Img.GetDesc();
+    const auto  NumComponents = ImgDesc.NumComponents == 3 ? 4 : ImgDesc.NumComponents;
+    if (NumComponents < 1 || NumComponents > 4)
+    {
+        LOG_ERROR_MESSAGE("Image '", SrcPath, "' has unsupported number of components (", ImgDesc.NumComponents, ")");
+        return false;
+    }
+
+    if (ImgDesc.ComponentType == VT_UINT8)
+    {
+        static constexpr Uint32 Formats[] = {DXGIFormat_R8_UNORM, DXGIFormat_RG8_UNORM, 0, DXGIFormat_RGBA8_UNORM};
+
+        SRGB = SRGB && NumComponents == 4;
+        GenerateMips<Uint8>(Tex, Img, NumComponents, SRGB);
+        Tex.DXGIFormat    = SRGB ? DXGIFormat_RGBA8_UNORM_SRGB : Formats[NumComponents - 1];
+        Tex.BytesPerPixel = NumComponents;
+
+        // Block compressed textures must have dimensions that are multiples of 4
+        if (Compress && ImgDesc.Width % 4 == 0 && ImgDesc.Height % 4 == 0)
+        {
+            switch (NumComponents)
+            {
+                case 1:
+                    Tex.DXGIFormat = DXGIFormat_BC4_UNORM;
+                    Tex.BlockSize  = 8;
+                    CompressMips(Tex, NumComponents, CompressBlockBC4);
+                    break;
+
+                case 2:
+                    Tex.DXGIFormat = DXGIFormat_BC5_UNORM;
+                    Tex.BlockSize  = 16;
+                    CompressMips(Tex, NumComponents, CompressBlockBC5);
+                    break;
+
+                case 4:
+                    if (IsOpaque(Tex.Mips[0]))
+                    {
+                        Tex.DXGIFormat = SRGB ? DXGIFormat_BC1_UNORM_SRGB : DXGIFormat_BC1_UNORM;
+                        Tex.BlockSize  = 8;
+                        CompressMips(Tex, NumComponents, CompressBlockBC1);
+                    }
+                    else
+                    {
+                        Tex.DXGIFormat = SRGB ? DXGIFormat_BC3_UNORM_SRGB : DXGIFormat_BC3_UNORM;
+                        Tex.BlockSize  = 16;
+                        CompressMips(Tex, NumComponents, CompressBlockBC3);
+                    }
+                    break;
+            }
+        }
+    }
+    else if (ImgDesc.ComponentType == VT_UINT16)
+    {
+        static constexpr Uint32 Formats[] = {DXGIFormat_R16_UNORM, DXGIFormat_RG16_UNORM, 0, DXGIFormat_RGBA16_UNORM};
+
+        // 16-bit images are typically height maps and are never compressed
+        GenerateMips<Uint16>(Tex, Img, NumComponents, false);
+        Tex.DXGIFormat    = Formats[NumComponents - 1];
+        Tex.BytesPerPixel = NumComponents * 2;
+    }
+    else
+    {
+        LOG_ERROR_MESSAGE("Image '", SrcPath, "' has unsupported component type");
+        return false;
+    }
+
+    return true;
+}
+
+bool WriteDDS(const Char* DstPath, const CookedTexture& Tex)
+{
+    const auto& Mip0 = Tex.Mips[0];
+
+    DDSHeader Header;
+    memset(&Header, 0, sizeof(Header));
+    Header.Size        = sizeof(DDSHeader);
+    Header.Flags       = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; // CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT
+    Header.Height      = Mip0.Height;
+    Header.Width       = Mip0.Width;
+    Header.Depth       = 1;
+    Header.MipMapCount = static_cast<Uint32>(Tex.Mips.size());
+    if (Tex.BlockSize != 0)
+    {
+        Header.Flags |= 0x80000; // LINEARSIZE
+        Header.PitchOrLinearSize = static_cast<Uint32>(Mip0.Data.size());
+    }
+    else
+    {
+        Header.Flags |= 0x8; // PITCH
+        Header.PitchOrLinearSize = Mip0.Width * Tex.BytesPerPixel;
+    }
+    Header.PixelFormat.Size   = sizeof(DDSPixelFormat);
+    Header.PixelFormat.Flags  = 0x4; // FOURCC
+    Header.PixelFormat.FourCC = DDSFourCCDX10;
+    Header.Caps               = 0x1000 | 0x400000 | 0x8; // TEXTURE | MIPMAP | COMPLEX
+
+    DDSHeaderDX10 HeaderDX10;
+    memset(&HeaderDX10, 0, sizeof(HeaderDX10));
+    HeaderDX10.DXGIFormat        = Tex.DXGIFormat;
+    HeaderDX10.ResourceDimension = 3; // TEXTURE2D
+    HeaderDX10.ArraySize         = 1;
+
+    FileWrapper pFile(DstPath, EFileAccessMode::Overwrite);
+    if (!pFile)
+    {
+        LOG_ERROR_MESSAGE("Failed to create file '", DstPath, "'");
+        return false;
+    }
+
+    bool Res = pFile->Write(&DDSMagic, sizeof(DDSMagic)) &&
+        pFile->Write(&Header, sizeof(Header)) &&
+        pFile->Write(&HeaderDX10, sizeof(HeaderDX10));
+    for (const auto& Mip : Tex.Mips)
+        Res = Res && pFile->Write(Mip.Data.data(), Mip.Data.size());
+
+    if (!Res)
+        LOG_ERROR_MESSAGE("Failed to write file '", DstPath, "'");
+
+    return Res;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool        Compress    = false;
+    const Char* SrcPath     = nullptr;
+    const Char* DstPath     = nullptr;
+    const Char* SRGBDstPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-compress") == 0)
+            Compress = true;
+        else if (SrcPath == nullptr)
+            SrcPath = argv[i];
+        else if (DstPath == nullptr)
+            DstPath = argv[i];
+        else if (SRGBDstPath == nullptr)
+            SRGBDstPath = argv[i];
+    }
+    if (SrcPath == nullptr || DstPath == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Usage: Diligent-AssetCooker [-compress] <source image> <cooked texture> [<cooked sRGB texture>]");
+        return 1;
+    }
+
+    try
+    {
+        RefCntAutoPtr<Image> pImage;
+        CreateImageFromFile(SrcPath, &pImage, nullptr);
+        if (!pImage)
+        {
+            LOG_ERROR_MESSAGE("Failed to load image '", SrcPath, "'");
+            return 1;
+        }
+
+        CookedTexture Tex;
+        if (!CookTexture(*pImage, SrcPath, Compress, false, Tex) || !WriteDDS(DstPath, Tex))
+            return 1;
+
+        if (SRGBDstPath != nullptr)
+        {
+            CookedTexture SRGBTex;
+            if (!CookTexture(*pImage, SrcPath, Compress, true, SRGBTex) || !WriteDDS(SRGBDstPath, SRGBTex))
+                return 1;
+        }
+    }
+    catch (...)
+    {
+        // The error has been logged by the image loader
+        return 1;
+    }
+
+    return 0;
+}
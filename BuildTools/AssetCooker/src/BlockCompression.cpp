@@ -0,0 +1,213 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include "BlockCompression.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+Uint16 PackRGB565(const int Color[3])
+{
+    return static_cast<Uint16>(((Color[0] >> 3) << 11) | ((Color[1] >> 2) << 5) | (Color[2] >> 3));
+}
+
+void UnpackRGB565(Uint16 Packed, int Color[3])
+{
+    const int R = (Packed >> 11) & 0x1F;
+    const int G = (Packed >> 5) & 0x3F;
+    const int B = Packed & 0x1F;
+
+    Color[0] = (R << 3) | (R >> 2);
+    Color[1] = (G << 2) | (G >> 4);
+    Color[2] = (B << 3) | (B >> 2);
+}
+
+// Writes Value as a little-endian integer of NumBytes bytes
+void WriteLE(Uint8* pDst, Uint64 Value, int NumBytes)
+{
+    for (int i = 0; i < NumBytes; ++i)
+        pDst[i] = static_cast<Uint8>(Value >> (i * 8));
+}
+
+void CompressColorBlock(const Uint8* pRGBA, Uint8* pDst)
+{
+    // Use the bounding box of the block colors, slightly inset to reduce the error in the middle of the box
+    int MinColor[3] = {255, 255, 255};
+    int MaxColor[3] = {0, 0, 0};
+    int AvgColor[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            MinColor[c] = std::min(MinColor[c], int{pRGBA[i * 4 + c]});
+            MaxColor[c] = std::max(MaxColor[c], int{pRGBA[i * 4 + c]});
+            AvgColor[c] += pRGBA[i * 4 + c];
+        }
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        AvgColor[c] = (AvgColor[c] + 8) / 16;
+
+        const int Inset = (MaxColor[c] - MinColor[c]) / 16;
+        MinColor[c] += Inset;
+        MaxColor[c] -= Inset;
+    }
+
+    // Pick the box diagonal that follows the colors: flip red and blue ranges
+    // if they are negatively correlated with green
+    int CovRG = 0, CovBG = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const int G = pRGBA[i * 4 + 1] - AvgColor[1];
+        CovRG += (pRGBA[i * 4 + 0] - AvgColor[0]) * G;
+        CovBG += (pRGBA[i * 4 + 2] - AvgColor[2]) * G;
+    }
+    if (CovRG < 0)
+        std::swap(MinColor[0], MaxColor[0]);
+    if (CovBG < 0)
+        std::swap(MinColor[2], MaxColor[2]);
+
+    Uint16 Color0 = PackRGB565(MaxColor);
+    Uint16 Color1 = PackRGB565(MinColor);
+    if (Color0 < Color1)
+        std::swap(Color0, Color1);
+
+    Uint32 Indices = 0;
+    if (Color0 != Color1)
+    {
+        // Four-color mode: Color0 > Color1
+        int Palette[4][3];
+        UnpackRGB565(Color0, Palette[0]);
+        UnpackRGB565(Color1, Palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+            Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int BestIdx  = 0;
+            int BestDist = INT_MAX;
+            for (int p = 0; p < 4; ++p)
+            {
+                int Dist = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const int d = pRGBA[i * 4 + c] - Palette[p][c];
+                    Dist += d * d;
+                }
+                if (Dist < BestDist)
+                {
+                    BestDist = Dist;
+                    BestIdx  = p;
+                }
+            }
+            Indices |= static_cast<Uint32>(BestIdx) << (i * 2);
+        }
+    }
+
+    WriteLE(pDst + 0, Color0, 2);
+    WriteLE(pDst + 2, Color1, 2);
+    WriteLE(pDst + 4, Indices, 4);
+}
+
+// Encodes one channel of a 4x4 block as BC4 block. Stride is the distance between pixels in bytes.
+void CompressChannelBlock(const Uint8* pPixels, Uint32 Stride, Uint8* pDst)
+{
+    int MinValue = 255;
+    int MaxValue = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        MinValue = std::min(MinValue, int{pPixels[i * Stride]});
+        MaxValue = std::max(MaxValue, int{pPixels[i * Stride]});
+    }
+
+    Uint64 Indices = 0;
+    if (MaxValue != MinValue)
+    {
+        // Eight-value mode: Value0 > Value1
+        int Palette[8];
+        Palette[0] = MaxValue;
+        Palette[1] = MinValue;
+        for (int p = 1; p < 7; ++p)
+            Palette[p + 1] = ((7 - p) * MaxValue + p * MinValue) / 7;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int BestIdx  = 0;
+            int BestDist = INT_MAX;
+            for (int p = 0; p < 8; ++p)
+            {
+                const int Dist = std::abs(pPixels[i * Stride] - Palette[p]);
+                if (Dist < BestDist)
+                {
+                    BestDist = Dist;
+                    BestIdx  = p;
+                }
+            }
+            Indices |= static_cast<Uint64>(BestIdx) << (i * 3);
+        }
+    }
+
+    pDst[0] = static_cast<Uint8>(MaxValue);
+    pDst[1] = static_cast<Uint8>(MinValue);
+    WriteLE(pDst + 2, Indices, 6);
+}
+
+} // namespace
+
+void CompressBlockBC1(const Uint8* pRGBA, Uint8* pDst)
+{
+    CompressColorBlock(pRGBA, pDst);
+}
+
+void CompressBlockBC3(const Uint8* pRGBA, Uint8* pDst)
+{
+    CompressChannelBlock(pRGBA + 3, 4, pDst);
+    CompressColorBlock(pRGBA, pDst + 8);
+}
+
+void CompressBlockBC4(const Uint8* pR, Uint8* pDst)
+{
+    CompressChannelBlock(pR, 1, pDst);
+}
+
+void CompressBlockBC5(const Uint8* pRG, Uint8* pDst)
+{
+    CompressChannelBlock(pRG + 0, 2, pDst);
+    CompressChannelBlock(pRG + 1, 2, pDst + 8);
+}
+
+} // namespace Diligent
@@ -0,0 +1,196 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+// Asset packer builds a single asset archive from the list of files. The list contains one file per
+// line in the form "<name in the archive>|<path to the file>". The archive is produced by the build
+// for every sample, see add_sample_app(), and is loaded by AssetArchive.
+//
+// Usage: Diligent-AssetPacker <file list> <archive>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "AssetArchiveFormat.hpp"
+#include "FileWrapper.hpp"
+#include "Errors.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct FileInfo
+{
+    std::string Name;
+    std::string Path;
+    Uint64      Hash = 0;
+    Uint64      Size = 0;
+};
+
+Uint64 AlignUp(Uint64 Offset, Uint64 Alignment)
+{
+    return (Offset + Alignment - 1) / Alignment * Alignment;
+}
+
+bool ReadFileList(const Char* ListPath, std::vector<FileInfo>& Files)
+{
+    std::ifstream List{ListPath};
+    if (!List)
+    {
+        LOG_ERROR_MESSAGE("Failed to open file list '", ListPath, "'");
+        return false;
+    }
+
+    std::string Line;
+    while (std::getline(List, Line))
+    {
+        if (!Line.empty() && Line.back() == '\r')
+            Line.pop_back();
+        if (Line.empty())
+            continue;
+
+        const auto SeparatorPos = Line.find('|');
+        if (SeparatorPos == std::string::npos)
+        {
+            LOG_ERROR_MESSAGE("Invalid line in file list '", ListPath, "': ", Line);
+            return false;
+        }
+
+        FileInfo File;
+        File.Name = NormalizeAssetName(Line.substr(0, SeparatorPos).c_str());
+        File.Path = Line.substr(SeparatorPos + 1);
+        File.Hash = ComputeAssetNameHash(File.Name);
+        Files.emplace_back(std::move(File));
+    }
+
+    // The index is sorted by hash so that files can be found with binary search
+    std::sort(Files.begin(), Files.end(), [](const FileInfo& F1, const FileInfo& F2) {
+        return F1.Hash != F2.Hash ? F1.Hash < F2.Hash : F1.Name < F2.Name;
+    });
+    for (size_t i = 1; i < Files.size(); ++i)
+    {
+        if (Files[i].Name == Files[i - 1].Name)
+        {
+            LOG_ERROR_MESSAGE("File '", Files[i].Name, "' is listed more than once");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool WriteArchive(const Char* ArchivePath, std::vector<FileInfo>& Files)
+{
+    for (auto& File : Files)
+    {
+        FileWrapper pFile(File.Path.c_str(), EFileAccessMode::Read);
+        if (!pFile)
+        {
+            LOG_ERROR_MESSAGE("Failed to open file '", File.Path, "'");
+            return false;
+        }
+        File.Size = pFile->GetSize();
+    }
+
+    AssetArchiveHeader Header;
+    Header.NumFiles    = static_cast<Uint32>(Files.size());
+    Header.IndexOffset = sizeof(AssetArchiveHeader);
+    Header.NamesOffset = Header.IndexOffset + Files.size() * sizeof(AssetArchiveEntry);
+
+    std::string                    Names;
+    std::vector<AssetArchiveEntry> Entries(Files.size());
+    for (size_t i = 0; i < Files.size(); ++i)
+    {
+        Entries[i].NameHash   = Files[i].Hash;
+        Entries[i].NameOffset = static_cast<Uint32>(Names.length());
+        Entries[i].NameLength = static_cast<Uint32>(Files[i].Name.length());
+        Names += Files[i].Name;
+    }
+    Header.NamesSize = static_cast<Uint32>(Names.length());
+
+    Uint64 DataOffset = Header.NamesOffset + Header.NamesSize;
+    for (size_t i = 0; i < Files.size(); ++i)
+    {
+        DataOffset            = AlignUp(DataOffset, AssetArchiveAlignment);
+        Entries[i].DataOffset = DataOffset;
+        Entries[i].DataSize   = Files[i].Size;
+        DataOffset += Files[i].Size;
+    }
+
+    FileWrapper pArchive(ArchivePath, EFileAccessMode::Overwrite);
+    if (!pArchive)
+    {
+        LOG_ERROR_MESSAGE("Failed to create archive '", ArchivePath, "'");
+        return false;
+    }
+
+    bool Res = pArchive->Write(&Header, sizeof(Header)) &&
+        (Entries.empty() || pArchive->Write(Entries.data(), Entries.size() * sizeof(AssetArchiveEntry))) &&
+        (Names.empty() || pArchive->Write(Names.data(), Names.length()));
+
+    Uint64             Offset = Header.NamesOffset + Header.NamesSize;
+    std::vector<Uint8> Data;
+    for (size_t i = 0; i < Files.size() && Res; ++i)
+    {
+        const std::vector<Uint8> Padding(static_cast<size_t>(Entries[i].DataOffset - Offset));
+        Res = Padding.empty() || pArchive->Write(Padding.data(), Padding.size());
+
+        Data.resize(static_cast<size_t>(Files[i].Size));
+        FileWrapper pFile(Files[i].Path.c_str(), EFileAccessMode::Read);
+        if (!pFile || !(Data.empty() || pFile->Read(Data.data(), Data.size())))
+        {
+            LOG_ERROR_MESSAGE("Failed to read file '", Files[i].Path, "'");
+            return false;
+        }
+        Res = Res && (Data.empty() || pArchive->Write(Data.data(), Data.size()));
+        Offset = Entries[i].DataOffset + Entries[i].DataSize;
+    }
+
+    if (!Res)
+        LOG_ERROR_MESSAGE("Failed to write archive '", ArchivePath, "'");
+
+    return Res;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        LOG_ERROR_MESSAGE("Usage: Diligent-AssetPacker <file list> <archive>");
+        return 1;
+    }
+
+    std::vector<FileInfo> Files;
+    if (!ReadFileList(argv[1], Files) || !WriteArchive(argv[2], Files))
+        return 1;
+
+    return 0;
+}
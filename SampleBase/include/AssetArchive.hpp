@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "EngineFactory.h"
+#include "Shader.h"
+#include "DataBlob.h"
+#include "Image.hpp"
+#include "AssetArchiveFormat.hpp"
+
+namespace Diligent
+{
+
+/// Read-only archive that packs all assets of a sample into a single file.
+
+/// The archive is produced by the asset packer at build time. It is memory-mapped as a whole,
+/// so opening it costs one system call, and file data is paged in on first access. Files are
+/// looked up by name in the hash index without touching the file system. The index is validated
+/// when the archive is opened, and an archive with any entry out of range is rejected.
+///
+/// The mapping is copy-on-write: file data may be modified in place by the loaders without
+/// affecting the archive file on disk.
+class AssetArchive
+{
+public:
+    explicit AssetArchive(const Char* FilePath);
+    ~AssetArchive();
+
+    // clang-format off
+    AssetArchive           (const AssetArchive&)  = delete;
+    AssetArchive           (      AssetArchive&&) = delete;
+    AssetArchive& operator=(const AssetArchive&)  = delete;
+    AssetArchive& operator=(      AssetArchive&&) = delete;
+    // clang-format on
+
+    bool IsOpen() const { return m_pData != nullptr; }
+
+    Uint32 GetNumFiles() const { return m_NumFiles; }
+
+    /// Returns a pointer to the data of the file with the given name and its size, or null if the
+    /// archive does not contain the file. The data remains valid while the archive is alive.
+    void* FindFile(const Char* Name, size_t& Size) const;
+
+    /// Mounts the archive used by the asset loading functions below. Returns false if the archive can't be opened.
+    /// Shader source factories created while the archive is mounted must be released before it is unmounted.
+    static bool Mount(const Char* FilePath);
+
+    static void Unmount();
+
+    /// Returns the mounted archive, or null if no archive is mounted
+    static AssetArchive* GetMounted();
+
+private:
+    void Close();
+
+    Uint8* m_pData = nullptr;
+    size_t m_Size  = 0;
+
+    const AssetArchiveEntry* m_pEntries = nullptr;
+    const Char*              m_pNames   = nullptr;
+    Uint32                   m_NumFiles = 0;
+};
+
+/// Same as IEngineFactory::CreateDefaultShaderSourceStreamFactory(), but reads files from the mounted
+/// asset archive when it contains them. Files that are not in the archive are read from disk.
+void CreateAssetShaderSourceStreamFactory(IEngineFactory*                   pEngineFactory,
+                                          const Char*                       SearchDirectories,
+                                          IShaderSourceInputStreamFactory** ppFactory);
+
+/// Same as CreateImageFromFile(), but decodes the image straight from the mounted asset archive
+/// when it contains the file. Raw DDS and KTX data references the archive memory without copying.
+void CreateImageFromAsset(const Char* FilePath, Image** ppImage, IDataBlob** ppRawData);
+
+/// Returns true if the file is contained in the mounted asset archive or exists on disk
+bool AssetExists(const Char* FilePath);
+
+} // namespace Diligent
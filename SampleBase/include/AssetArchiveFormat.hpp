@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+// Binary layout of the asset archive shared by the asset packer and AssetArchive.
+//
+// The archive starts with AssetArchiveHeader followed by the index: NumFiles AssetArchiveEntry
+// structures sorted by name hash, and the file names. The data of every file starts at an
+// offset that is a multiple of AssetArchiveAlignment. All values are little-endian.
+
+#include <string>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+static constexpr Uint32 AssetArchiveMagic     = 0x52414144; // "DAAR"
+static constexpr Uint32 AssetArchiveVersion   = 1;
+static constexpr Uint32 AssetArchiveAlignment = 64;
+
+struct AssetArchiveHeader
+{
+    Uint32 Magic       = AssetArchiveMagic;
+    Uint32 Version     = AssetArchiveVersion;
+    Uint32 NumFiles    = 0;
+    Uint32 NamesSize   = 0;
+    Uint64 IndexOffset = 0;
+    Uint64 NamesOffset = 0;
+};
+
+struct AssetArchiveEntry
+{
+    Uint64 NameHash   = 0;
+    Uint64 DataOffset = 0;
+    Uint64 DataSize   = 0;
+    Uint32 NameOffset = 0; // Relative to AssetArchiveHeader::NamesOffset
+    Uint32 NameLength = 0;
+};
+
+// Names are stored with forward slashes and without leading "./", so that files
+// can be found by the paths used in the samples, e.g. "Terrain\\Tiles\\Snow_NM.jpg".
+inline std::string NormalizeAssetName(const Char* Name)
+{
+    std::string Normalized{Name};
+    for (auto& c : Normalized)
+    {
+        if (c == '\\')
+            c = '/';
+    }
+    while (Normalized.compare(0, 2, "./") == 0)
+        Normalized.erase(0, 2);
+    return Normalized;
+}
+
+// 64-bit FNV-1a hash of the normalized name
+inline Uint64 ComputeAssetNameHash(const std::string& NormalizedName)
+{
+    Uint64 Hash = 0xCBF29CE484222325ull;
+    for (auto c : NormalizedName)
+    {
+        Hash ^= static_cast<Uint8>(c);
+        Hash *= 0x100000001B3ull;
+    }
+    return Hash;
+}
+
+} // namespace Diligent
@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Image.hpp"
+
+namespace Diligent
+{
+
+/// Encodes screen captures and writes them to files on a pool of worker threads.
+
+/// Pixels are copied into pooled buffers, so the caller may unmap and recycle the
+/// staging texture as soon as Enqueue() returns. The number of images in flight is bounded:
+/// when the limit is reached, Enqueue() either blocks until a worker finishes (the image
+/// is counted as late) or drops the image if dropping is allowed.
+class AsyncImageWriter
+{
+public:
+    AsyncImageWriter(Uint32 NumThreads, Uint32 MaxPendingImages, bool DropWhenFull);
+    ~AsyncImageWriter();
+
+    // clang-format off
+    AsyncImageWriter           (const AsyncImageWriter&)  = delete;
+    AsyncImageWriter           (      AsyncImageWriter&&) = delete;
+    AsyncImageWriter& operator=(const AsyncImageWriter&)  = delete;
+    AsyncImageWriter& operator=(      AsyncImageWriter&&) = delete;
+    // clang-format on
+
+    /// Copies the image data and schedules it for encoding.
+    /// Returns false if the image was dropped.
+    bool Enqueue(std::string FileName, const Image::EncodeInfo& Info);
+
+    /// Waits until all scheduled images are written.
+    void WaitForIdle();
+
+    Uint32 GetNumWrittenImages() const;
+    /// Returns the number of images that could not be encoded or written
+    Uint32 GetNumFailedImages() const;
+    Uint32 GetNumDroppedImages() const;
+    Uint32 GetNumLateImages() const;
+
+private:
+    struct Task
+    {
+        std::string        FileName;
+        Image::EncodeInfo  Info;
+        std::vector<Uint8> Pixels;
+    };
+
+    void WorkerThreadFunc();
+    // Returns true if the image has been encoded and written
+    bool WriteImage(Task& task);
+
+    const Uint32 m_MaxPendingImages;
+    const bool   m_DropWhenFull;
+
+    mutable std::mutex              m_Mtx;
+    std::condition_variable         m_TaskAvailableCV;
+    std::condition_variable         m_TaskCompletedCV;
+    std::deque<Task>                m_Tasks;
+    std::vector<std::vector<Uint8>> m_BufferPool;
+    Uint32                          m_NumPendingImages = 0;
+    Uint32                          m_NumWrittenImages = 0;
+    Uint32                          m_NumFailedImages  = 0;
+    Uint32                          m_NumDroppedImages = 0;
+    Uint32                          m_NumLateImages    = 0;
+    bool                            m_bStop            = false;
+
+    std::vector<std::thread> m_WorkerThreads;
+};
+
+} // namespace Diligent
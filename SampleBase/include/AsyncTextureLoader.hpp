@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "Texture.h"
+#include "TextureView.h"
+#include "RefCntAutoPtr.hpp"
+#include "Image.hpp"
+#include "TextureUtilities.h"
+
+namespace Diligent
+{
+
+/// Loads textures from files in the background.
+
+/// Image files are read and decoded on a pool of worker threads, so loading many textures
+/// scales with the number of cores. Textures are created from the decoded images on the main
+/// thread in Update(), which also transitions all textures created in the same call to the
+/// shader resource state with a single batch of barriers through the immediate context.
+///
+/// LoadTexture() returns a placeholder SRV that can be bound right away. When the texture is
+/// ready, the callback is called from Update(), and the application replaces the placeholder.
+/// Since mutable and static shader variables can only be set once, this typically requires
+/// creating a new shader resource binding.
+///
+/// All methods must be called from the main thread.
+class AsyncTextureLoader
+{
+public:
+    /// Called from Update() when the texture is created. pTexture is null if the texture failed to load.
+    using LoadedCallback = std::function<void(ITexture* pTexture)>;
+
+    AsyncTextureLoader(IRenderDevice* pDevice, Uint32 NumThreads);
+    ~AsyncTextureLoader();
+
+    // clang-format off
+    AsyncTextureLoader           (const AsyncTextureLoader&)  = delete;
+    AsyncTextureLoader           (      AsyncTextureLoader&&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&)  = delete;
+    AsyncTextureLoader& operator=(      AsyncTextureLoader&&) = delete;
+    // clang-format on
+
+    /// Schedules the texture for loading and returns the placeholder SRV.
+    /// Supports all file formats supported by CreateTextureFromFile().
+    /// The cooked version of the file is loaded instead when there is one.
+    ITextureView* LoadTexture(const Char* FilePath, const TextureLoadInfo& LoadInfo, LoadedCallback Callback);
+
+    /// Creates at most MaxTextures textures from the images decoded so far, transitions them
+    /// to the shader resource state and calls their callbacks. Called once per frame by the application.
+    void Update(IDeviceContext* pContext, Uint32 MaxTextures = DefaultMaxTexturesPerUpdate);
+
+    /// Waits until all scheduled textures are loaded and calls their callbacks.
+    void Flush(IDeviceContext* pContext);
+
+    /// 1x1 gray texture shown in place of textures that are being loaded
+    ITextureView* GetPlaceholderSRV() const { return m_pPlaceholderSRV; }
+
+    /// Number of textures that have been scheduled, but whose callbacks have not been called yet
+    Uint32 GetNumPendingTextures() const { return m_NumPendingTextures; }
+
+    // Limits the time spent on creating textures and generating their mip levels in a single frame
+    static constexpr Uint32 DefaultMaxTexturesPerUpdate = 4;
+
+private:
+    struct Request
+    {
+        std::string     FilePath;
+        std::string     Name;
+        TextureLoadInfo LoadInfo;
+        LoadedCallback  Callback;
+
+        // Whether FilePath has been replaced with the path of the cooked texture
+        bool IsCooked = false;
+
+        // Decoded image, or raw file data for DDS and KTX files that are loaded as is
+        RefCntAutoPtr<Image>     pImage;
+        RefCntAutoPtr<IDataBlob> pRawData;
+    };
+
+    void WorkerThreadFunc(Uint32 ThreadIdx);
+
+    RefCntAutoPtr<ITexture> CreateTexture(Request& Req);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    RefCntAutoPtr<ITexture>      m_pPlaceholder;
+    ITextureView*                m_pPlaceholderSRV          = nullptr;
+    bool                         m_bPlaceholderTransitioned = false;
+
+    // Only accessed by the main thread
+    Uint32 m_NumPendingTextures = 0;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_RequestAvailableCV;
+    std::condition_variable m_ImageDecodedCV;
+    std::deque<Request>     m_Requests;
+    std::deque<Request>     m_DecodedRequests;
+    bool                    m_bStop = false;
+
+    std::vector<std::thread> m_WorkerThreads;
+};
+
+} // namespace Diligent
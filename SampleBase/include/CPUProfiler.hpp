@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <atomic>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Lightweight hierarchical CPU profiler.
+
+/// Every thread records completed scopes into its own ring buffer, so BeginScope() and
+/// EndScope() never take a lock. Readers (the profiler overlay, trace export) walk the
+/// ring buffers from another thread and discard events that may have been overwritten
+/// while they were being copied. Buffers of exited threads are reused by new threads.
+/// Scope names must be string literals or otherwise outlive the profiler.
+class CPUProfiler
+{
+public:
+    struct Event
+    {
+        const char* Name  = nullptr;
+        Uint64      Start = 0; // Nanoseconds since the profiler epoch
+        Uint64      End   = 0;
+        Uint32      Depth = 0;
+    };
+
+    struct ThreadEvents
+    {
+        Uint32             ThreadId = 0;
+        std::string        ThreadName;
+        std::vector<Event> Events; // Sorted by end time
+    };
+
+    /// Maximum number of completed events kept per thread
+    static constexpr Uint32 RingBufferSize = 16384;
+
+    /// Maximum scope nesting depth; deeper scopes are not recorded
+    static constexpr Uint32 MaxDepth = 32;
+
+    static void SetEnabled(bool Enabled) { s_Enabled.store(Enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+    /// Returns the current time in nanoseconds since the profiler epoch
+    static Uint64 GetTime();
+
+    /// Sets the name of the calling thread as it appears in the overlay and traces
+    static void SetThreadName(const char* Name);
+
+    static void BeginScope(const char* Name);
+    static void EndScope();
+
+    /// Collects events from all threads that overlap the [StartTime, EndTime] interval.
+    /// Threads without such events are not included.
+    static void GetEvents(Uint64 StartTime, Uint64 EndTime, std::vector<ThreadEvents>& Threads);
+
+    /// Writes all events currently held in the ring buffers to a file in Chrome trace
+    /// event format (chrome://tracing, Perfetto).
+    static bool WriteChromeTrace(const char* FilePath);
+
+private:
+    static std::atomic<bool> s_Enabled;
+};
+
+/// Records a CPU profiler scope for the lifetime of the object
+class ScopedCPUProfilerMarker
+{
+public:
+    explicit ScopedCPUProfilerMarker(const char* Name) :
+        m_bActive{CPUProfiler::IsEnabled()}
+    {
+        if (m_bActive)
+            CPUProfiler::BeginScope(Name);
+    }
+
+    ~ScopedCPUProfilerMarker()
+    {
+        if (m_bActive)
+            CPUProfiler::EndScope();
+    }
+
+    // clang-format off
+    ScopedCPUProfilerMarker           (const ScopedCPUProfilerMarker&)  = delete;
+    ScopedCPUProfilerMarker           (      ScopedCPUProfilerMarker&&) = delete;
+    ScopedCPUProfilerMarker& operator=(const ScopedCPUProfilerMarker&)  = delete;
+    ScopedCPUProfilerMarker& operator=(      ScopedCPUProfilerMarker&&) = delete;
+    // clang-format on
+
+private:
+    // The profiler may be enabled or disabled while the scope is open
+    const bool m_bActive;
+};
+
+#define CPU_PROFILER_CONCAT_IMPL(x, y) x##y
+#define CPU_PROFILER_CONCAT(x, y)      CPU_PROFILER_CONCAT_IMPL(x, y)
+
+/// Profiles the enclosing scope, e.g. CPU_PROFILER_SCOPE("RenderShadowMap");
+#define CPU_PROFILER_SCOPE(Name) ::Diligent::ScopedCPUProfilerMarker CPU_PROFILER_CONCAT(CPUProfilerMarker, __LINE__)(Name)
+
+} // namespace Diligent
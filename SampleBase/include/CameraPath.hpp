@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Camera pose that is recorded to and played back from a camera path.
+
+/// All interactive cameras of the samples are defined by a position and yaw and pitch angles.
+/// Orbit cameras store the distance to the target in Position.z.
+struct CameraPose
+{
+    float3 Position;
+    float  Yaw   = 0;
+    float  Pitch = 0;
+};
+
+/// Sequence of timestamped camera poses.
+
+/// Camera paths are recorded by sampling the interactive camera while the user flies
+/// through the scene and are played back to drive the camera along the same path in
+/// every run, so that benchmarks of different builds and machines are comparable.
+/// Poses between keys are interpolated with a Catmull-Rom spline.
+///
+/// The path is stored in a binary file that contains a header followed by the keys.
+class CameraPath
+{
+public:
+    struct Key
+    {
+        // Time in seconds since the beginning of the path
+        float      Time = 0;
+        CameraPose Pose;
+    };
+
+    // The minimum time between two recorded keys
+    static constexpr double DefaultKeyInterval = 1.0 / 30.0;
+
+    explicit CameraPath(double KeyInterval = DefaultKeyInterval) :
+        m_KeyInterval{KeyInterval}
+    {}
+
+    /// Adds the pose to the path unless less than the key interval has passed since the last key
+    void Record(double Time, const CameraPose& Pose);
+
+    /// Returns the pose at the given time. The path is looped, so that playback continues
+    /// from the beginning when the time exceeds the path duration.
+    CameraPose Evaluate(double Time) const;
+
+    double GetDuration() const { return m_Keys.empty() ? 0.0 : m_Keys.back().Time; }
+
+    Uint32 GetNumKeys() const { return static_cast<Uint32>(m_Keys.size()); }
+
+    void Clear() { m_Keys.clear(); }
+
+    bool Load(const char* FilePath);
+    bool Save(const char* FilePath) const;
+
+private:
+    const double m_KeyInterval;
+
+    std::vector<Key> m_Keys;
+};
+
+} // namespace Diligent
@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "RenderDevice.h"
+#include "Texture.h"
+#include "DataBlob.h"
+#include "TextureUtilities.h"
+
+namespace Diligent
+{
+
+// Cooked textures are DDS files with the full mip chain that the asset cooker produces at build time
+// from the source images in the assets folder. A texture cooked from "Dir/Image.png" is located at
+// "cooked/Dir/Image.png.dds". Every image is also cooked into "cooked/Dir/Image.png.srgb.dds" that has
+// sRGB format and mip levels filtered in linear space; it is selected when TextureLoadInfo::IsSRGB is true.
+
+/// Returns the path of the cooked texture for the given source image, or an empty string if
+/// there is no cooked texture or it can't be used with the given load parameters.
+std::string FindCookedTexture(const Char* FilePath, const TextureLoadInfo& LoadInfo);
+
+/// Creates a texture from the cooked DDS data.
+void CreateTextureFromCookedData(IDataBlob* pDDSData, const TextureLoadInfo& LoadInfo, IRenderDevice* pDevice, ITexture** ppTexture);
+
+/// Creates a texture from the cooked version of the file if there is one, and from the file itself otherwise.
+void CreateTextureFromFilePreferCooked(const Char* FilePath, const TextureLoadInfo& LoadInfo, IRenderDevice* pDevice, ITexture** ppTexture);
+
+} // namespace Diligent
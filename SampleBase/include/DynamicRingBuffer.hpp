@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "Buffer.h"
+#include "RefCntAutoPtr.hpp"
+#include "MapHelper.hpp"
+
+namespace Diligent
+{
+
+/// Linear allocator of per-frame data blocks in a dynamic buffer.
+
+/// Every context maps the buffer once and sub-allocates aligned blocks from it by bumping
+/// an offset, so that per-draw data such as instance transforms costs a pointer increment
+/// rather than a map/unmap of a separate buffer for every draw call. The blocks are bound
+/// by offset, e.g. as per-instance vertex buffer data. The buffer is always mapped with
+/// MAP_FLAG_DISCARD, which is the only flag D3D11.0 deferred contexts support, so it is
+/// mapped at most once between two calls to Discard().
+///
+/// Every context has its own copy of the buffer and its own offset. Contexts are identified
+/// by index, and different contexts may allocate from different threads. The same context
+/// must only be used by one thread at a time.
+///
+/// D3D11 and OpenGL do not allow using a buffer while it is mapped, so the context must call
+/// Unmap() before it records commands that use the allocated blocks. When the buffer is full,
+/// or has been unmapped, Allocate() returns null; the context then records the commands that use
+/// the blocks allocated so far and calls Discard() to start over from the beginning of the buffer.
+/// To use the whole buffer, the context should allocate as many blocks as fit before unmapping it.
+///
+/// Dynamic buffer contents do not survive the end of the frame, and deferred contexts may not
+/// continue mapping a buffer in a new command list, so the immediate context must call Discard()
+/// at the beginning of every frame, and deferred contexts at the beginning of every command list.
+class DynamicRingBuffer
+{
+public:
+    static constexpr Uint32 DefaultAlignment = 16;
+
+    DynamicRingBuffer(IRenderDevice* pDevice,
+                      const Char*    Name,
+                      BIND_FLAGS     BindFlags,
+                      Uint32         Size,
+                      Uint32         NumContexts,
+                      Uint32         Alignment = DefaultAlignment);
+
+    // clang-format off
+    DynamicRingBuffer           (const DynamicRingBuffer&)  = delete;
+    DynamicRingBuffer           (      DynamicRingBuffer&&) = delete;
+    DynamicRingBuffer& operator=(const DynamicRingBuffer&)  = delete;
+    DynamicRingBuffer& operator=(      DynamicRingBuffer&&) = delete;
+    // clang-format on
+
+    /// Allocates a block of the given size and returns its CPU address, or null if the block does
+    /// not fit into the remaining space or the buffer has been unmapped since the last discard.
+    /// Maps the buffer in the context if nothing has been allocated since the last discard.
+    /// Offset receives the offset of the block from the beginning of the buffer.
+    void* Allocate(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 Size, Uint32& Offset);
+
+    /// Unmaps the buffer in the context. The blocks allocated so far remain valid, but no more
+    /// blocks can be allocated until Discard() is called.
+    void Unmap(Uint32 CtxIdx);
+
+    /// Unmaps the buffer and starts allocating from the beginning. Commands recorded before
+    /// the call keep using the old contents; the old blocks must not be used by new commands.
+    void Discard(Uint32 CtxIdx);
+
+    /// Returns the total size of the blocks allocated by the context since the last discard
+    Uint32 GetAllocatedSize(Uint32 CtxIdx) const { return m_Contexts[CtxIdx].Offset; }
+
+    IBuffer* GetBuffer() const { return m_pBuffer; }
+    Uint32   GetSize() const { return m_Size; }
+
+private:
+    RefCntAutoPtr<IBuffer> m_pBuffer;
+
+    const Uint32 m_Size;
+    const Uint32 m_Alignment;
+
+    struct ContextData
+    {
+        MapHelper<Uint8> MappedData;
+        Uint32           Offset = 0;
+    };
+    std::vector<ContextData> m_Contexts;
+};
+
+} // namespace Diligent
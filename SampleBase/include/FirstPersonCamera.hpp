@@ -29,6 +29,7 @@
 
 #include "BasicMath.hpp"
 #include "InputController.hpp"
+#include "CameraPath.hpp"
 
 namespace Diligent
 {
@@ -49,6 +50,9 @@ public:
                         bool    IsGL);
     void SetSpeedUpScales(Float32 SpeedUpScale, Float32 SuperSpeedUpScale);
 
+    CameraPose GetPose() const;
+    // Sets the position and rotation and updates the view and world matrices
+    void SetPose(const CameraPose& Pose);
 
     // clang-format off
     const float4x4& GetViewMatrix()  const { return m_ViewMatrix;  }
@@ -76,6 +80,9 @@ public:
     void SetReferenceAxes(const float3& ReferenceRightAxis, const float3& ReferenceUpAxis);
 
 protected:
+    float4x4 GetRotationMatrix() const;
+    void     UpdateMatrices();
+
     ProjectionAttribs m_ProjAttribs;
 
     MouseState m_LastMouseState;
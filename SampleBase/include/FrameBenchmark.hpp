@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Collects per-frame timings in benchmark mode and reports their statistics.
+class FrameBenchmark
+{
+public:
+    /// CPU time, in seconds, spent in every stage of the frame, and the wall-clock
+    /// time between the ends of this and the previous frame.
+    struct FrameTimings
+    {
+        double Update  = 0;
+        double Render  = 0;
+        double Present = 0;
+        double Frame   = 0;
+
+        double Total() const { return Update + Render + Present; }
+    };
+
+    struct Statistics
+    {
+        double Min    = 0;
+        double Median = 0;
+        double P95    = 0;
+        double P99    = 0;
+        double Max    = 0;
+    };
+
+    FrameBenchmark(Uint32 NumWarmupFrames, Uint32 NumFrames, std::string OutputFile);
+    ~FrameBenchmark();
+
+    // clang-format off
+    FrameBenchmark           (const FrameBenchmark&)  = delete;
+    FrameBenchmark           (      FrameBenchmark&&) = delete;
+    FrameBenchmark& operator=(const FrameBenchmark&)  = delete;
+    FrameBenchmark& operator=(      FrameBenchmark&&) = delete;
+    // clang-format on
+
+    /// Adds the timings of the frame that has just been presented.
+    /// Frames that fall into the warm-up window are ignored.
+    void AddFrame(const FrameTimings& Timings);
+
+    /// Returns true when all requested frames have been recorded.
+    bool IsComplete() const
+    {
+        return m_Frames.size() >= m_NumFrames;
+    }
+
+    /// Total number of frames, including warm-up, the benchmark needs to run.
+    Uint32 GetTotalFrameCount() const
+    {
+        return m_NumWarmupFrames + m_NumFrames;
+    }
+
+    /// Writes the CSV file and logs the statistics. Subsequent calls have no effect.
+    void Finish();
+
+    /// Computes min, median, 95th and 99th percentiles and max of the values using nearest-rank method.
+    static Statistics ComputeStatistics(std::vector<double> Values);
+
+private:
+    void WriteCSV() const;
+    void LogStatistics() const;
+
+    const Uint32      m_NumWarmupFrames;
+    const Uint32      m_NumFrames;
+    const std::string m_OutputFile;
+
+    Uint32                    m_NumSkippedFrames = 0;
+    bool                      m_bFinished        = false;
+    std::vector<FrameTimings> m_Frames;
+};
+
+} // namespace Diligent
@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// A list of render passes that declare the resources they read and write.
+
+/// The graph is built every frame and executed with Execute(). Passes are executed in the order
+/// they were added. Before every pass, the graph transitions all resources the pass uses into the
+/// declared states with a single TransitionResourceStates() call, so the pass itself should use
+/// RESOURCE_STATE_TRANSITION_MODE_VERIFY (or NONE) for these resources. Only resources that are not
+/// already in the required state are transitioned. The exception is unordered access: staying in
+/// RESOURCE_STATE_UNORDERED_ACCESS does not make the previous writes visible, so the graph always
+/// issues a UAV barrier before a pass that writes a resource in this state, and before the first
+/// pass that accesses a resource after it has been written in this state.
+///
+/// Passes that do not contribute to any resource marked as output, directly or through other
+/// passes, are culled and are not executed. A pass that writes a resource is assumed to depend
+/// on all previous writes of that resource, so, for example, a clear is never culled while the
+/// draws that follow it are used.
+///
+/// The graph is not thread-safe and must only be used from the render thread.
+class FrameGraph
+{
+public:
+    using PassFunction = std::function<void(IDeviceContext* pCtx)>;
+
+    explicit FrameGraph(IRenderDevice* pDevice);
+
+    // clang-format off
+    FrameGraph           (const FrameGraph&)  = delete;
+    FrameGraph           (      FrameGraph&&) = delete;
+    FrameGraph& operator=(const FrameGraph&)  = delete;
+    FrameGraph& operator=(      FrameGraph&&) = delete;
+    // clang-format on
+
+    /// Adds the texture to the graph and returns its index. The texture must be alive until the graph
+    /// is executed, and its state must be known to the engine. Importing the same texture again returns
+    /// the same index.
+    Uint32 ImportTexture(ITexture* pTexture);
+
+    /// Adds the buffer to the graph and returns its index, see ImportTexture()
+    Uint32 ImportBuffer(IBuffer* pBuffer);
+
+    /// Marks the resource as used outside of the graph, e.g. the swap chain back buffer
+    void MarkOutput(Uint32 Resource);
+
+    /// Adds a pass to the graph and returns its index
+    Uint32 AddPass(const Char* Name, PassFunction Func);
+
+    /// Declares that the pass reads the resource in the given state
+    void AddRead(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State);
+
+    /// Declares that the pass writes the resource in the given state
+    void AddWrite(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State);
+
+    /// Executes all passes that contribute to the outputs
+    void Execute(IDeviceContext* pCtx);
+
+    /// Removes all passes and resources from the graph
+    void Clear();
+
+    Uint32 GetNumPasses() const { return static_cast<Uint32>(m_Passes.size()); }
+
+    /// The number of passes that were culled by the last Execute()
+    Uint32 GetNumCulledPasses() const { return m_NumCulledPasses; }
+
+    /// The number of resources transitioned by the last Execute()
+    Uint32 GetNumTransitions() const { return m_NumTransitions; }
+
+private:
+    struct Resource
+    {
+        ITexture* pTexture = nullptr;
+        IBuffer*  pBuffer  = nullptr;
+        bool      IsOutput = false;
+
+        // The resource has been written in unordered access state since the last barrier
+        bool HasPendingUAVWrite = false;
+    };
+
+    struct ResourceAccess
+    {
+        Uint32         Resource = 0;
+        RESOURCE_STATE State    = RESOURCE_STATE_UNKNOWN;
+        bool           IsWrite  = false;
+    };
+
+    struct Pass
+    {
+        const Char*                 Name = nullptr;
+        PassFunction                Func;
+        std::vector<ResourceAccess> Accesses;
+    };
+
+    void AddAccess(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State, bool IsWrite);
+
+    // Marks passes that contribute to the outputs
+    void CullPasses(std::vector<bool>& IsPassUsed);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    std::vector<Resource> m_Resources;
+    std::vector<Pass>     m_Passes;
+
+    std::vector<StateTransitionDesc> m_Barriers;
+
+    Uint32 m_NumCulledPasses = 0;
+    Uint32 m_NumTransitions  = 0;
+};
+
+} // namespace Diligent
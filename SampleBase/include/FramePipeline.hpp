@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Runs the per-frame simulation of a sample on a dedicated update thread so that
+/// simulation of frame N+1 overlaps with command recording for frame N.
+
+/// The simulation writes its results into one of NumSnapshots frame snapshots, and rendering
+/// reads the snapshot returned by GetRenderSnapshotIndex(). The number of frames the rendered
+/// snapshot lags behind the simulation is given by the maximum frame latency:
+/// - 0: the simulation runs synchronously on the calling thread and the frame renders its own snapshot;
+/// - 1: the simulation runs on the update thread and the frame renders the snapshot of the previous frame.
+///
+/// At most one simulation step is in flight at any time, so the latency never exceeds one frame.
+class FramePipeline
+{
+public:
+    static constexpr Uint32 NumSnapshots = 2;
+
+    using SimulateCallbackType = std::function<void(double CurrTime, double ElapsedTime, Uint32 SnapshotIdx)>;
+
+    FramePipeline(Uint32 MaxFrameLatency, SimulateCallbackType SimulateCallback);
+    ~FramePipeline();
+
+    // clang-format off
+    FramePipeline           (const FramePipeline&)  = delete;
+    FramePipeline           (      FramePipeline&&) = delete;
+    FramePipeline& operator=(const FramePipeline&)  = delete;
+    FramePipeline& operator=(      FramePipeline&&) = delete;
+    // clang-format on
+
+    /// Waits until the update thread finishes the current simulation step.
+    /// After this call, the calling thread may safely modify the simulation state.
+    void WaitForUpdate();
+
+    /// Starts simulating a new frame into the next snapshot and selects the snapshot to render.
+    void BeginUpdate(double CurrTime, double ElapsedTime);
+
+    /// Returns the index of the snapshot that the current frame must render
+    Uint32 GetRenderSnapshotIndex() const { return m_RenderSnapshotIdx; }
+
+    Uint32 GetMaxFrameLatency() const { return m_MaxFrameLatency; }
+
+private:
+    void UpdateThreadFunc();
+
+    const Uint32               m_MaxFrameLatency;
+    const SimulateCallbackType m_SimulateCallback;
+
+    Uint64 m_FrameNumber       = 0;
+    Uint32 m_RenderSnapshotIdx = 0;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_UpdateRequestedCV;
+    std::condition_variable m_UpdateCompletedCV;
+
+    struct UpdateRequest
+    {
+        double CurrTime    = 0;
+        double ElapsedTime = 0;
+        Uint32 SnapshotIdx = 0;
+    } m_Request;
+    bool m_bUpdatePending = false;
+    bool m_bStop          = false;
+
+    std::thread m_UpdateThread;
+};
+
+} // namespace Diligent
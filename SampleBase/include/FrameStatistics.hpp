@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "BasicTypes.h"
+#include "FrameBenchmark.hpp"
+
+namespace Diligent
+{
+
+/// Keeps a rolling history of frame times and computes their statistics.
+
+/// Frame time is the wall-clock time between the ends of two consecutive frames.
+/// The application adds the same frame times to the statistics and to the benchmark,
+/// and both compute percentiles with FrameBenchmark::ComputeStatistics(), so the
+/// numbers shown in the overlay, queried by samples and reported by the benchmark match.
+class FrameStatistics
+{
+public:
+    static constexpr Uint32 DefaultHistorySize    = 512;
+    static constexpr double DefaultHitchThreshold = 1.0 / 30.0;
+
+    explicit FrameStatistics(Uint32 HistorySize = DefaultHistorySize);
+
+    /// Adds the time, in seconds, of the frame that has just been presented.
+    void AddFrame(double FrameTime);
+
+    /// Removes all frames from the history and resets the hitch counter.
+    void Reset();
+
+    /// Frames that take longer than the threshold, in seconds, are counted as hitches.
+    void   SetHitchThreshold(double Threshold);
+    double GetHitchThreshold() const { return m_HitchThreshold; }
+
+    /// Number of frames in the history
+    Uint32 GetNumFrames() const { return m_NumFrames; }
+
+    /// Total number of frames added since the last reset
+    Uint64 GetTotalFrames() const { return m_TotalFrames; }
+
+    /// Total number of hitches since the last reset, counted with the threshold in effect when each frame was added
+    Uint64 GetTotalHitches() const { return m_TotalHitches; }
+
+    /// Number of hitches in the history
+    Uint32 GetNumHitches() const;
+
+    double GetLastFrameTime() const { return m_LastFrameTime; }
+
+    /// Average frame time over the history, in seconds
+    double GetAverageFrameTime() const;
+
+    /// Average frame rate over the history
+    double GetFPS() const;
+
+    /// Min, median, 95th and 99th percentiles and max of frame times in the history, in seconds
+    const FrameBenchmark::Statistics& GetStatistics() const;
+
+    /// Returns the frame times in the history, in seconds, from the oldest to the most recent one
+    void GetFrameTimes(std::vector<double>& FrameTimes) const;
+
+private:
+    void UpdateStatistics() const;
+
+    std::vector<double> m_History;
+    Uint32              m_NextFrameIdx  = 0;
+    Uint32              m_NumFrames     = 0;
+    double              m_LastFrameTime = 0;
+
+    double m_HitchThreshold = DefaultHitchThreshold;
+    Uint64 m_TotalFrames    = 0;
+    Uint64 m_TotalHitches   = 0;
+
+    // Statistics of the history are only recomputed when they are requested after new frames have been added
+    mutable bool                       m_bStatisticsValid = false;
+    mutable FrameBenchmark::Statistics m_Statistics;
+    mutable double                     m_AverageFrameTime = 0;
+    mutable Uint32                     m_NumHitches       = 0;
+};
+
+} // namespace Diligent
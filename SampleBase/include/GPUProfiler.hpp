@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "Query.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// GPU profiler that measures named, nestable scopes with timestamp queries.
+
+/// Every frame uses its own set of queries, and the results are read back without
+/// stalling once the GPU has finished the frame, which is typically a few frames later.
+/// If the results of a frame are not available by the time its queries need to be
+/// reused, the frame is dropped. Scopes may only be recorded in the immediate context
+/// between BeginFrame() and EndFrame().
+class GPUProfiler
+{
+public:
+    struct ScopeTiming
+    {
+        std::string Name;
+        Uint32      Depth = 0;
+        double      Start = 0; // Milliseconds since the beginning of the frame
+        double      End   = 0;
+    };
+
+    struct FrameTimings
+    {
+        Uint64                   FrameNumber = 0;
+        double                   Duration    = 0; // Milliseconds
+        std::vector<ScopeTiming> Scopes;
+    };
+
+    GPUProfiler(IRenderDevice* pDevice, IDeviceContext* pContext, Uint32 NumFramesInFlight, Uint32 MaxScopesPerFrame);
+
+    // clang-format off
+    GPUProfiler           (const GPUProfiler&)  = delete;
+    GPUProfiler           (      GPUProfiler&&) = delete;
+    GPUProfiler& operator=(const GPUProfiler&)  = delete;
+    GPUProfiler& operator=(      GPUProfiler&&) = delete;
+    // clang-format on
+
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginScope(const char* Name);
+    void EndScope();
+
+    /// Returns the timings of the most recent frame whose results have been read back
+    const FrameTimings& GetLastFrameTimings() const { return m_LastFrameTimings; }
+
+    Uint32 GetNumDroppedFrames() const { return m_NumDroppedFrames; }
+
+private:
+    static constexpr Uint32 InvalidIndex = ~0u;
+
+    struct QuerySlot
+    {
+        RefCntAutoPtr<IQuery> pQuery;
+        Uint64                Counter   = 0;
+        Uint64                Frequency = 0;
+        bool                  Resolved  = false;
+    };
+
+    struct FrameData
+    {
+        struct Scope
+        {
+            std::string Name;
+            Uint32      Depth      = 0;
+            Uint32      BeginQuery = InvalidIndex;
+            Uint32      EndQuery   = InvalidIndex;
+        };
+
+        std::vector<QuerySlot> Queries;
+        std::vector<Scope>     Scopes;
+        Uint32                 NumQueries  = 0;
+        Uint32                 BeginQuery  = InvalidIndex;
+        Uint32                 EndQuery    = InvalidIndex;
+        Uint64                 FrameNumber = 0;
+        bool                   Pending     = false;
+    };
+
+    Uint32 WriteTimestamp(FrameData& Frame);
+    bool   ResolveFrame(FrameData& Frame);
+    void   ResolvePendingFrames();
+
+    RefCntAutoPtr<IRenderDevice>  m_pDevice;
+    RefCntAutoPtr<IDeviceContext> m_pContext;
+    const Uint32                  m_MaxQueriesPerFrame;
+
+    std::vector<FrameData> m_Frames;
+    FrameData*             m_pCurrFrame  = nullptr;
+    Uint64                 m_FrameNumber = 0;
+    std::vector<Uint32>    m_ScopeStack;
+    Uint32                 m_NumOpenTimedScopes = 0;
+
+    FrameTimings m_LastFrameTimings;
+    Uint32       m_NumDroppedFrames = 0;
+};
+
+/// Records a GPU profiler scope for the lifetime of the object. Does nothing if the profiler is null.
+class ScopedGPUProfilerMarker
+{
+public:
+    ScopedGPUProfilerMarker(GPUProfiler* pProfiler, const char* Name) :
+        m_pProfiler{pProfiler}
+    {
+        if (m_pProfiler != nullptr)
+            m_pProfiler->BeginScope(Name);
+    }
+
+    ~ScopedGPUProfilerMarker()
+    {
+        if (m_pProfiler != nullptr)
+            m_pProfiler->EndScope();
+    }
+
+    // clang-format off
+    ScopedGPUProfilerMarker           (const ScopedGPUProfilerMarker&)  = delete;
+    ScopedGPUProfilerMarker           (      ScopedGPUProfilerMarker&&) = delete;
+    ScopedGPUProfilerMarker& operator=(const ScopedGPUProfilerMarker&)  = delete;
+    ScopedGPUProfilerMarker& operator=(      ScopedGPUProfilerMarker&&) = delete;
+    // clang-format on
+
+private:
+    GPUProfiler* const m_pProfiler;
+};
+
+#define GPU_PROFILER_CONCAT_IMPL(x, y) x##y
+#define GPU_PROFILER_CONCAT(x, y)      GPU_PROFILER_CONCAT_IMPL(x, y)
+
+/// Profiles the GPU work recorded in the enclosing scope, e.g. GPU_PROFILER_SCOPE(m_pGPUProfiler, "RenderShadowMap");
+#define GPU_PROFILER_SCOPE(pProfiler, Name) ::Diligent::ScopedGPUProfilerMarker GPU_PROFILER_CONCAT(GPUProfilerMarker, __LINE__)(pProfiler, Name)
+
+} // namespace Diligent
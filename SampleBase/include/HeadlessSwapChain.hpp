@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "SwapChain.h"
+
+namespace Diligent
+{
+
+/// Swap chain that renders into offscreen color and depth buffers.
+
+/// The swap chain is used by the sample app in headless mode when there is no native
+/// window to present to. Present() only flushes the immediate context and finishes the frame.
+class HeadlessSwapChain final : public ObjectBase<ISwapChain>
+{
+public:
+    using TBase = ObjectBase<ISwapChain>;
+
+    HeadlessSwapChain(IReferenceCounters*  pRefCounters,
+                      IRenderDevice*       pDevice,
+                      IDeviceContext*      pContext,
+                      const SwapChainDesc& SCDesc);
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_SwapChain, TBase)
+
+    virtual void Present(Uint32 SyncInterval) override final;
+
+    virtual const SwapChainDesc& GetDesc() const override final
+    {
+        return m_SwapChainDesc;
+    }
+
+    virtual void Resize(Uint32 NewWidth, Uint32 NewHeight) override final;
+
+    virtual void SetFullscreenMode(const DisplayModeAttribs& DisplayMode) override final {}
+    virtual void SetWindowedMode() override final {}
+
+    virtual ITextureView* GetCurrentBackBufferRTV() override final
+    {
+        return m_pRTV;
+    }
+
+    virtual ITextureView* GetDepthBufferDSV() override final
+    {
+        return m_pDSV;
+    }
+
+    static void Create(IRenderDevice*       pDevice,
+                       IDeviceContext*      pContext,
+                       const SwapChainDesc& SCDesc,
+                       ISwapChain**         ppSwapChain);
+
+private:
+    void CreateBuffers();
+
+    SwapChainDesc m_SwapChainDesc;
+
+    RefCntAutoPtr<IRenderDevice>  m_pDevice;
+    RefCntAutoPtr<IDeviceContext> m_pContext;
+    RefCntAutoPtr<ITextureView>   m_pRTV;
+    RefCntAutoPtr<ITextureView>   m_pDSV;
+};
+
+} // namespace Diligent
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "GraphicsTypes.h"
+
+namespace Diligent
+{
+
+struct ImageDiffAttribs
+{
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+
+    /// Pixels of the first image. Only RGBA8 and BGRA8 formats are supported.
+    const void*    pData0  = nullptr;
+    Uint32         Stride0 = 0;
+    TEXTURE_FORMAT Format0 = TEX_FORMAT_RGBA8_UNORM;
+
+    /// Pixels of the second image in RGB or RGBA order.
+    const void* pData1         = nullptr;
+    Uint32      Stride1        = 0;
+    Uint32      NumComponents1 = 3;
+
+    /// Pixels whose error in any of the RGB channels exceeds the tolerance are counted as mismatched.
+    Uint32 Tolerance = 0;
+
+    /// Number of threads to split the rows between. Zero selects the number of hardware threads.
+    Uint32 NumThreads = 0;
+
+    /// If not null, receives a tightly packed RGBA8 heat map of the per-pixel error.
+    std::vector<Uint8>* pHeatMap = nullptr;
+};
+
+struct ImageDiffStats
+{
+    /// Number of pixels whose error exceeds the tolerance.
+    Uint32 NumMismatchedPixels = 0;
+
+    /// Maximum absolute error over all RGB channels.
+    Uint32 MaxError = 0;
+
+    /// Mean absolute error over all RGB channels.
+    double MeanError = 0;
+
+    /// Peak signal-to-noise ratio in dB. Infinite when the images are identical.
+    double PSNR = 0;
+};
+
+/// Compares the RGB channels of two images using SIMD kernels, splitting the rows between multiple threads.
+/// Returns false if the first image format is not supported.
+bool ComputeImageDiff(const ImageDiffAttribs& Attribs, ImageDiffStats& Stats);
+
+} // namespace Diligent
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "BasicTypes.h"
 #include "FlagEnum.h"
 
@@ -110,9 +112,34 @@ public:
         }
     }
 
+    // Input events are timestamped with this clock, in seconds, as they arrive
+    static double GetEventTime()
+    {
+        return std::chrono::duration<double>{std::chrono::steady_clock::now().time_since_epoch()}.count();
+    }
+
+    // Returns the arrival time of the oldest input event received since the previous call,
+    // or a negative value if there were no events. The application latches the events
+    // once per frame right after the sample has applied the newest input.
+    double LatchEventTime()
+    {
+        auto OldestEventTime = m_OldestEventTime;
+        m_OldestEventTime    = -1;
+        return OldestEventTime;
+    }
+
 protected:
+    // Platform controllers call this method for every input event they handle
+    void OnInputEvent()
+    {
+        if (m_OldestEventTime < 0)
+            m_OldestEventTime = GetEventTime();
+    }
+
     MouseState            m_MouseState;
     INPUT_KEY_STATE_FLAGS m_Keys[static_cast<size_t>(InputKeys::TotalKeys)] = {};
+
+    double m_OldestEventTime = -1;
 };
 
 } // namespace Diligent
@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// A set of tasks with dependencies that is executed by JobSystem::Run().
+
+/// A task may only start when all tasks it depends on have completed.
+/// The graph must be acyclic. The same graph may be run any number of times.
+class TaskGraph
+{
+public:
+    /// Task function receives the index of the job system thread that executes it
+    using TaskFunction = std::function<void(Uint32 ThreadIdx)>;
+
+    /// Adds a task to the graph and returns its index
+    Uint32 AddTask(TaskFunction Func);
+
+    /// Makes task Task wait for task Prerequisite
+    void AddDependency(Uint32 Task, Uint32 Prerequisite);
+
+    void Clear() { m_Tasks.clear(); }
+
+    Uint32 GetNumTasks() const { return static_cast<Uint32>(m_Tasks.size()); }
+
+private:
+    friend class JobSystem;
+
+    struct Task
+    {
+        TaskFunction        Func;
+        std::vector<Uint32> Successors;
+        Uint32              NumPrerequisites = 0;
+    };
+    std::vector<Task> m_Tasks;
+};
+
+
+/// Work-stealing job system.
+
+/// Every thread of the job system owns a queue of ready tasks. A thread executes tasks from
+/// the back of its own queue, and when the queue is empty, steals tasks from the front of
+/// other threads' queues, so that work is rebalanced between threads at run time.
+///
+/// Job system threads are indexed from 0 to GetNumThreads()-1. Index 0 is the thread that
+/// calls Run() or ParallelFor(): it executes tasks along with the worker threads until all
+/// tasks are complete. Indices 1 to GetNumWorkerThreads() are background worker threads.
+/// Tasks may use the thread index to access per-thread resources such as deferred contexts.
+///
+/// Run() and ParallelFor() must not be called concurrently or from within a task.
+/// ParallelForAsync() starts the work on the worker threads and returns immediately; no other
+/// method that executes tasks may be called until Wait() returns.
+class JobSystem
+{
+public:
+    explicit JobSystem(Uint32 NumWorkerThreads);
+    ~JobSystem();
+
+    // clang-format off
+    JobSystem           (const JobSystem&)  = delete;
+    JobSystem           (      JobSystem&&) = delete;
+    JobSystem& operator=(const JobSystem&)  = delete;
+    JobSystem& operator=(      JobSystem&&) = delete;
+    // clang-format on
+
+    /// Executes all tasks of the graph and returns when they are complete
+    void Run(const TaskGraph& Graph);
+
+    using ParallelForFunction = std::function<void(Uint32 First, Uint32 Last, Uint32 ThreadIdx)>;
+
+    /// Splits the range [0, NumItems) into chunks of ChunkSize items and calls Func for
+    /// every chunk [First, Last). Returns when all chunks are processed.
+    void ParallelFor(Uint32 NumItems, Uint32 ChunkSize, const ParallelForFunction& Func);
+
+    /// Starts processing the range [0, NumItems) in the same way as ParallelFor() and returns immediately.
+    /// The chunks are processed by the worker threads; the calling thread only joins them in Wait().
+    /// When there are no worker threads, all chunks are processed before the method returns.
+    void ParallelForAsync(Uint32 NumItems, Uint32 ChunkSize, ParallelForFunction Func);
+
+    /// Waits until all chunks started by ParallelForAsync() are processed. The calling thread executes
+    /// the remaining chunks along with the worker threads. Does nothing if no work is in flight.
+    void Wait();
+
+    /// Returns true if the work started by ParallelForAsync() has not been waited for
+    bool IsBusy() const { return m_pGraph != nullptr; }
+
+    Uint32 GetNumWorkerThreads() const { return static_cast<Uint32>(m_WorkerThreads.size()); }
+    Uint32 GetNumThreads() const { return GetNumWorkerThreads() + 1; }
+
+    /// Returns the total time, in seconds, that the thread with the given index has spent waiting for
+    /// tasks since the job system was created. For the calling thread (index 0), only the time waiting
+    /// for other threads to complete their tasks in Run(), ParallelFor() and Wait() is counted.
+    double GetIdleTime(Uint32 ThreadIdx) const;
+
+private:
+    void WorkerThreadFunc(Uint32 ThreadIdx);
+
+    void StartGraph(const TaskGraph& Graph);
+    void WaitForGraph();
+
+    bool PopTask(Uint32 ThreadIdx, Uint32& TaskIdx);
+    void PushTask(Uint32 ThreadIdx, Uint32 TaskIdx);
+    void ExecuteTask(Uint32 ThreadIdx, Uint32 TaskIdx);
+
+    struct TaskQueue
+    {
+        std::mutex         Mtx;
+        std::deque<Uint32> Tasks;
+    };
+    std::unique_ptr<TaskQueue[]> m_Queues;
+
+    // The graph that is currently being executed and the number of prerequisites
+    // of every task that have not completed yet
+    const TaskGraph*                       m_pGraph = nullptr;
+    std::unique_ptr<std::atomic<Uint32>[]> m_NumPendingPrerequisites;
+    Uint32                                 m_MaxTasks = 0;
+
+    // The total number of tasks in all queues. Only modified while the queue is locked.
+    std::atomic<Uint32> m_NumQueuedTasks{0};
+    // The number of tasks of the current graph that have not completed yet
+    std::atomic<Uint32> m_NumRemainingTasks{0};
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_WakeUpCV;
+    bool                    m_bStop = false;
+
+    TaskGraph           m_ParallelForGraph;
+    ParallelForFunction m_AsyncFunc;
+
+    // Time, in nanoseconds, that every thread has spent waiting on m_WakeUpCV
+    std::unique_ptr<std::atomic<Uint64>[]> m_IdleTime;
+
+    std::vector<std::thread> m_WorkerThreads;
+};
+
+} // namespace Diligent
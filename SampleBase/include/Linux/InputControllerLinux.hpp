@@ -30,10 +30,24 @@ public:
 
     void InitXCBKeysms(void* connection);
 
+    // Sets the window whose pointer position is queried by PollMousePosition().
+    // Either X11 display or XCB connection must be specified.
+    void SetPointerWindow(void* display, void* connection, Uint32 window);
+
+    // Queries the current pointer position from the server so that the position is not
+    // limited to the motion events that were pumped before the frame started.
+    void PollMousePosition();
+
 private:
+    int ProcessXEvent(void* xevent);
+    int ProcessXCBEvent(void* xcb_event);
     int HandleKeyEvevnt(unsigned int keysym, bool IsKeyPressed);
 
     void* m_XCBKeySymbols = nullptr;
+
+    void*  m_Display       = nullptr;
+    void*  m_XCBConnection = nullptr;
+    Uint32 m_Window        = 0;
 };
 
 } // namespace Diligent
@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "CPUProfiler.hpp"
+#include "GPUProfiler.hpp"
+
+namespace Diligent
+{
+
+/// ImGui window that shows a timeline of the CPU profiler scopes recorded on all
+/// threads during the last complete frame, and the GPU scopes of the last frame
+/// whose timings have been read back.
+class ProfilerOverlay
+{
+public:
+    /// Marks the beginning of a new frame. Must be called once per frame on the main thread.
+    void NewFrame();
+
+    /// Draws the overlay window. Must be called between ImGui::NewFrame() and ImGui::Render().
+    void Draw(bool* pOpen = nullptr);
+
+    void SetTraceFile(std::string TraceFile) { m_TraceFile = std::move(TraceFile); }
+
+    void SetGPUProfiler(const GPUProfiler* pGPUProfiler) { m_pGPUProfiler = pGPUProfiler; }
+
+private:
+    void DrawTimeline(const std::vector<CPUProfiler::Event>& Events, Uint64 FrameStart, Uint64 FrameEnd, float Width);
+    void DrawGPUTimeline();
+    void DrawTopScopes();
+
+    Uint64 m_CurrFrameStart = 0;
+    Uint64 m_LastFrameStart = 0;
+    Uint64 m_LastFrameEnd   = 0;
+    bool   m_bPaused        = false;
+
+    std::vector<CPUProfiler::ThreadEvents> m_Threads;
+
+    const GPUProfiler*        m_pGPUProfiler = nullptr;
+    GPUProfiler::FrameTimings m_GPUFrame;
+
+    std::string m_TraceFile = "cpu_profile.json";
+};
+
+} // namespace Diligent
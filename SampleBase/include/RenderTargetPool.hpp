@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+#include <vector>
+
+#include "RenderDevice.h"
+#include "Texture.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Pool of render targets and depth buffers keyed by texture description.
+
+/// Textures are not destroyed when the caller is done with them, but are returned to the pool
+/// and handed out again to the next request with an equal description, so that intermediate
+/// buffers of passes that do not overlap in time share the same memory. A texture that has not
+/// been used for the given number of frames is released, so that when the window is resized,
+/// the buffers of the old size are freed lazily rather than in the middle of the resize, and
+/// are reused if the window returns to the old size.
+///
+/// There are two kinds of allocations:
+/// - Transient textures are valid until the end of the frame, or until they are explicitly
+///   released. The pool tracks them by frame rather than by reference count, so the caller may
+///   keep views of a transient texture, e.g. in resource bindings, but must not use them after
+///   that unless it acquires the texture again. Since the same texture is returned for the same
+///   description in every frame, such bindings usually remain valid.
+/// - Persistent textures are kept by the caller across frames and are returned to the pool
+///   when the caller releases the last reference to the texture or any of its default views.
+///
+/// The pool is not thread-safe and must only be used from the render thread.
+class RenderTargetPool
+{
+public:
+    struct Statistics
+    {
+        // The number of textures owned by the pool, used or not
+        Uint32 NumTextures = 0;
+        // The number of textures created since the pool was created
+        Uint32 NumCreatedTextures = 0;
+        // Estimated memory size, in bytes, of all textures owned by the pool
+        Uint64 MemorySize = 0;
+        // The largest MemorySize since the pool was created
+        Uint64 PeakMemorySize = 0;
+    };
+
+    static constexpr Uint32 DefaultMaxUnusedFrames = 8;
+
+    RenderTargetPool(IRenderDevice* pDevice, Uint32 MaxUnusedFrames = DefaultMaxUnusedFrames);
+
+    // clang-format off
+    RenderTargetPool           (const RenderTargetPool&)  = delete;
+    RenderTargetPool           (      RenderTargetPool&&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&)  = delete;
+    RenderTargetPool& operator=(      RenderTargetPool&&) = delete;
+    // clang-format on
+
+    /// Returns a texture that matches the description and is valid until the end of the frame.
+    /// The texture name is only used when a new texture is created.
+    ITexture* AcquireTransient(const TextureDesc& Desc);
+
+    /// Returns the transient texture to the pool before the end of the frame, so that
+    /// subsequent passes of the same frame may reuse it
+    void ReleaseTransient(ITexture* pTexture);
+
+    /// Returns a texture that matches the description and is kept until the caller releases it
+    RefCntAutoPtr<ITexture> Acquire(const TextureDesc& Desc);
+
+    /// Returns all transient textures to the pool and releases textures that have not been
+    /// used for MaxUnusedFrames frames. Must be called once per frame before the sample is rendered.
+    void NextFrame();
+
+    /// Releases all textures that are not currently used
+    void ReleaseUnused();
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+    void LogStatistics() const;
+
+private:
+    struct PooledTexture
+    {
+        RefCntAutoPtr<ITexture> pTexture;
+
+        Uint64 MemorySize    = 0;
+        Uint64 LastUsedFrame = 0;
+        // The texture is acquired as transient in the current frame
+        bool IsTransient = false;
+        // The texture was last acquired by Acquire() and is in use while the caller references it
+        bool IsPersistent = false;
+    };
+
+    PooledTexture* AcquireTexture(const TextureDesc& Desc);
+
+    bool IsAvailable(const PooledTexture& Texture) const;
+
+    void ReleaseTexture(size_t Idx);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    const Uint32 m_MaxUnusedFrames;
+    Uint64       m_FrameNumber = 0;
+
+    std::vector<PooledTexture> m_Textures;
+
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
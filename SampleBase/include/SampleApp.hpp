@@ -40,6 +40,16 @@
 #include "SampleBase.hpp"
 #include "ScreenCapture.hpp"
 #include "Image.hpp"
+#include "Timer.hpp"
+#include "FrameBenchmark.hpp"
+#include "FrameStatistics.hpp"
+#include "AsyncImageWriter.hpp"
+#include "VideoStreamWriter.hpp"
+#include "ProfilerOverlay.hpp"
+#include "ShaderCache.hpp"
+#include "AsyncTextureLoader.hpp"
+#include "RenderTargetPool.hpp"
+#include "CameraPath.hpp"
 
 namespace Diligent
 {
@@ -83,6 +93,13 @@ protected:
         void* NativeWindowHandle);
     void InitializeSample();
     void UpdateAdaptersDialog();
+    void UpdateFrameStatisticsWindow();
+    void RunHeadless();
+    void ReleaseDiligentEngine();
+
+    // Platform applications may query the input state that has changed since the events
+    // were pumped at the beginning of the frame, e.g. the current mouse position
+    virtual void PollInput() {}
 
     virtual void SetFullscreenMode(const DisplayModeAttribs& DisplayMode)
     {
@@ -97,6 +114,7 @@ protected:
 
     void CompareGoldenImage(const std::string& FileName, ScreenCapture::CaptureInfo& Capture);
     void SaveScreenCapture(const std::string& FileName, ScreenCapture::CaptureInfo& Capture);
+    void WriteVideoFrame(ScreenCapture::CaptureInfo& Capture);
 
     RENDER_DEVICE_TYPE                         m_DeviceType = RENDER_DEVICE_TYPE_UNDEFINED;
     RefCntAutoPtr<IEngineFactory>              m_pEngineFactory;
@@ -123,6 +141,36 @@ protected:
     bool         m_bShowUI             = true;
     double       m_CurrentTime         = 0;
 
+    struct HeadlessModeInfo
+    {
+        bool   Enabled   = false;
+        Uint32 Width     = 0;
+        Uint32 Height    = 0;
+        Uint32 NumFrames = 100;
+    } m_HeadlessMode;
+
+    struct BenchmarkInfo
+    {
+        Uint32      NumFrames       = 0;
+        Uint32      NumWarmupFrames = 10;
+        double      FixedDeltaTime  = 0;
+        std::string OutputFile;
+        Uint64      FrameIndex = 0;
+    } m_BenchmarkInfo;
+    std::unique_ptr<FrameBenchmark> m_pBenchmark;
+    FrameBenchmark::FrameTimings    m_FrameTimings;
+    Timer                           m_FrameTimer;
+
+    // Frame statistics are always collected and are shared with the sample
+    FrameStatistics m_FrameStats;
+    double          m_LastFrameEndTime = -1;
+    bool            m_bShowFrameStats  = false;
+
+    // Time from the arrival of the oldest input event applied in a frame to the return from Present,
+    // in seconds. Only frames that applied input events are added to the statistics.
+    FrameStatistics m_InputLatencyStats;
+    double          m_LatchedInputTime = -1;
+
     struct ScreenCaptureInfo
     {
         bool             AllowCapture = false;
@@ -135,14 +183,44 @@ protected:
         EImageFileFormat FileFormat      = EImageFileFormat::png;
         int              JpegQuality     = 95;
         bool             KeepAlpha       = false;
+        Uint32           NumThreads      = 0;
+        bool             DropFrames      = false;
+
+        // When set, frames are appended to a single video stream instead of individual image files
+        bool                      WriteVideoStream = false;
+        VideoStreamWriter::FORMAT StreamFormat     = VideoStreamWriter::FORMAT::Y4M;
 
     } m_ScreenCaptureInfo;
-    std::unique_ptr<ScreenCapture> m_pScreenCapture;
+    std::unique_ptr<ScreenCapture>     m_pScreenCapture;
+    std::unique_ptr<AsyncImageWriter>  m_pImageWriter;
+    std::unique_ptr<VideoStreamWriter> m_pVideoStreamWriter;
 
     std::unique_ptr<ImGuiImplDiligent> m_pImGui;
 
+    std::unique_ptr<ProfilerOverlay> m_pProfilerOverlay;
+    std::unique_ptr<GPUProfiler>     m_pGPUProfiler;
+    bool                             m_bShowProfiler = false;
+    std::string                      m_ProfilerTraceFile;
+
+    std::unique_ptr<FramePipeline> m_pFramePipeline;
+    Uint32                         m_MaxFrameLatency = 0;
+
+    std::unique_ptr<ShaderCache> m_pShaderCache;
+    std::string                  m_ShaderCacheDir;
+
+    std::unique_ptr<AsyncTextureLoader> m_pTextureLoader;
+    std::unique_ptr<RenderTargetPool>   m_pRenderTargetPool;
+
+    std::unique_ptr<CameraPath> m_pCameraPath;
+    std::string                 m_CameraPathFile;
+    bool                        m_bRecordCameraPath = false;
+
+    static constexpr const Char* DefaultAssetArchive = "assets.pak";
+    std::string                  m_AssetArchivePath;
+
     GoldenImageMode m_GoldenImgMode           = GoldenImageMode::None;
     int             m_GoldenImgPixelTolerance = 0;
+    bool            m_bWriteGoldenImgDiff     = false;
     int             m_ExitCode                = 0;
 };
 
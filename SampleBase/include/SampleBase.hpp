@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "EngineFactory.h"
@@ -35,6 +37,14 @@
 #include "DeviceContext.h"
 #include "SwapChain.h"
 #include "InputController.hpp"
+#include "GPUProfiler.hpp"
+#include "FramePipeline.hpp"
+#include "FrameStatistics.hpp"
+#include "JobSystem.hpp"
+#include "ShaderCache.hpp"
+#include "AsyncTextureLoader.hpp"
+#include "RenderTargetPool.hpp"
+#include "CameraPath.hpp"
 
 namespace Diligent
 {
@@ -55,41 +65,164 @@ public:
     virtual void Render()                                    = 0;
     virtual void Update(double CurrTime, double ElapsedTime) = 0;
     virtual void WindowResize(Uint32 Width, Uint32 Height) {}
+    // Called before the swap chain is resized. Samples must release all references to the
+    // back buffer here, including command lists that were recorded with it.
+    virtual void PreWindowResize() {}
+    // Called on the main thread right after the frame has been presented and before the next frame is
+    // updated. Samples may start recording commands of the next frame on the job system threads here.
+    virtual void PostPresent() {}
     virtual bool HandleNativeMessage(const void* pNativeMsgData) { return false; }
 
     virtual const Char* GetSampleName() const { return "Diligent Engine Sample"; }
     virtual void        ProcessCommandLine(const char* CmdLine) {}
 
+    // Samples that separate their per-frame simulation from UI and input handling may return true
+    // to let SampleApp run UpdateSimulation() through the FramePipeline. UpdateSimulation() must only
+    // write to the snapshot with the given index, while Render() must only read the snapshot selected
+    // by SetRenderSnapshot(). Update() is always called on the main thread when no simulation is in
+    // flight, so it may modify any state. Snapshot indices are in [0, FramePipeline::NumSnapshots).
+    virtual bool SupportsPipelinedUpdate() const { return false; }
+    virtual void UpdateSimulation(double CurrTime, double ElapsedTime, Uint32 SnapshotIdx) {}
+    virtual void SetRenderSnapshot(Uint32 SnapshotIdx) {}
+
+    // Samples that return true get LateLatchInput() called on the main thread right before Render(),
+    // after the application has polled the input again. The sample should apply the newest input to
+    // the camera and refresh the view-dependent state so that it is as recent as possible when the
+    // commands are submitted. Wheel delta and key release flags have already been consumed by Update().
+    virtual bool SupportsLateInputLatching() const { return false; }
+    virtual void LateLatchInput(double CurrTime) {}
+
     InputController& GetInputController()
     {
         return m_InputController;
     }
 
+    void SetGPUProfiler(GPUProfiler* pGPUProfiler)
+    {
+        m_pGPUProfiler = pGPUProfiler;
+    }
+
+    void SetFrameStatistics(const FrameStatistics* pFrameStats)
+    {
+        m_pFrameStats = pFrameStats;
+    }
+
+    void SetShaderCache(ShaderCache* pShaderCache)
+    {
+        m_pShaderCache = pShaderCache;
+    }
+
+    void SetTextureLoader(AsyncTextureLoader* pTextureLoader)
+    {
+        m_pTextureLoader = pTextureLoader;
+    }
+
+    void SetRenderTargetPool(RenderTargetPool* pRenderTargetPool)
+    {
+        m_pRenderTargetPool = pRenderTargetPool;
+    }
+
+    // When Record is true, the poses of the interactive camera are recorded to the path.
+    // Otherwise, the camera is driven by the path.
+    void SetCameraPath(CameraPath* pCameraPath, bool Record)
+    {
+        m_pCameraPath       = pCameraPath;
+        m_bRecordCameraPath = Record;
+    }
+
 protected:
+    // Every job system thread records commands into its own deferred context, so the number
+    // of worker threads is limited by the number of deferred contexts minus one for the main thread.
+    Uint32 GetMaxWorkerThreads() const
+    {
+        return m_pDeferredContexts.empty() ? 0 : static_cast<Uint32>(m_pDeferredContexts.size() - 1);
+    }
+
+    // Recreates the job system with the given number of worker threads
+    void SetNumWorkerThreads(Uint32 NumWorkerThreads);
+
+    // Returns the deferred context used by the job system thread with the given index
+    IDeviceContext* GetWorkerContext(Uint32 ThreadIdx) const
+    {
+        return m_pDeferredContexts[ThreadIdx];
+    }
+
+    // Context index passed to the recording function: 0 is the immediate context,
+    // and 1 + i is the deferred context of job system thread i.
+    using RecordCommandsFunction = std::function<void(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 First, Uint32 Last)>;
+
+    // The range is split into at most this number of chunks per job system thread. Several chunks per thread
+    // let idle threads steal the remaining work when the cost of items is uneven, while keeping the number
+    // of command lists to execute small.
+    static constexpr Uint32 CommandListChunksPerThread = 4;
+
+    // Records commands for the range [0, NumItems) split into chunks. When there are worker threads, the chunks
+    // are recorded on the job system, every chunk into a separate command list using the deferred context of
+    // the thread that picked it, and the command lists are executed in the immediate context in the chunk order.
+    // Otherwise, the whole range is recorded directly into the immediate context.
+    void RecordCommandsInParallel(Uint32 NumItems, const RecordCommandsFunction& RecordCommands);
+
+    // Records commands for the range [0, NumItems) into command lists in the same way as RecordCommandsInParallel(),
+    // even when there are no worker threads, and returns the command lists in the chunk order without executing them.
+    // FinishWorkerContextFrames() must be called after the command lists have been executed.
+    void RecordCommandLists(Uint32 NumItems, const RecordCommandsFunction& RecordCommands, std::vector<RefCntAutoPtr<ICommandList>>& CmdLists);
+
+    // Starts recording command lists in the same way as RecordCommandLists() and returns immediately. The chunks are
+    // recorded by the worker threads while the calling thread continues. WaitForCommandLists() must be called before
+    // the command lists are used, before the data read by RecordCommands is modified, and before the job system is used again.
+    void BeginRecordCommandLists(Uint32 NumItems, RecordCommandsFunction RecordCommands, std::vector<RefCntAutoPtr<ICommandList>>& CmdLists);
+    // Waits until the command lists started by BeginRecordCommandLists() are recorded. Does nothing if there are none.
+    void WaitForCommandLists();
+
+    // Releases dynamic resources allocated by the deferred contexts of all job system threads.
+    // Must only be called after the command lists recorded by the contexts have been executed.
+    void FinishWorkerContextFrames();
+
+    // Samples with an interactive camera must call this method every update after the camera has processed
+    // user input. When a camera path is played back, the pose is replaced with the pose on the path;
+    // when a camera path is recorded, the pose is added to the path. The path starts at the first call.
+    void UpdateCameraPose(double CurrTime, CameraPose& Pose);
+
     RefCntAutoPtr<IEngineFactory>              m_pEngineFactory;
     RefCntAutoPtr<IRenderDevice>               m_pDevice;
     RefCntAutoPtr<IDeviceContext>              m_pImmediateContext;
     std::vector<RefCntAutoPtr<IDeviceContext>> m_pDeferredContexts;
     RefCntAutoPtr<ISwapChain>                  m_pSwapChain;
-    float                                      m_fSmoothFPS         = 0;
-    double                                     m_LastFPSTime        = 0;
-    Uint32                                     m_NumFramesRendered  = 0;
     Uint32                                     m_CurrentFrameNumber = 0;
 
+    // GPU profiler is only available when profiling is enabled, and is null otherwise
+    GPUProfiler* m_pGPUProfiler = nullptr;
+
+    // Frame time statistics collected by the application. Samples should use them rather than
+    // measure frame rate on their own, so that all samples and the benchmark report the same numbers.
+    const FrameStatistics* m_pFrameStats = nullptr;
+
+    // Shader cache is always set by the application before the sample is initialized.
+    // Samples should create shaders through the cache to avoid recompiling them in every run.
+    ShaderCache* m_pShaderCache = nullptr;
+
+    // Texture loader is always set by the application before the sample is initialized.
+    // Loaded texture callbacks are called on the main thread before the sample is updated.
+    AsyncTextureLoader* m_pTextureLoader = nullptr;
+
+    // Render target pool is always set by the application before the sample is initialized.
+    // Samples should allocate window-size offscreen buffers from the pool rather than create them directly.
+    RenderTargetPool* m_pRenderTargetPool = nullptr;
+
+    // Camera path is only set when a path is played back or recorded, and is null otherwise
+    CameraPath* m_pCameraPath         = nullptr;
+    bool        m_bRecordCameraPath   = false;
+    double      m_CameraPathStartTime = -1;
+
+    std::unique_ptr<JobSystem>               m_pJobSystem;
+    std::vector<RefCntAutoPtr<ICommandList>> m_WorkerCmdLists;
+
     InputController m_InputController;
 };
 
 inline void SampleBase::Update(double CurrTime, double ElapsedTime)
 {
-    ++m_NumFramesRendered;
     ++m_CurrentFrameNumber;
-    static const double dFPSInterval = 0.5;
-    if (CurrTime - m_LastFPSTime > dFPSInterval)
-    {
-        m_fSmoothFPS        = static_cast<float>(m_NumFramesRendered / (CurrTime - m_LastFPSTime));
-        m_NumFramesRendered = 0;
-        m_LastFPSTime       = CurrTime;
-    }
 }
 
 inline void SampleBase::Initialize(IEngineFactory*  pEngineFactory,
@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "RenderDevice.h"
+#include "Shader.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Keeps compiled shader bytecode on disk between application runs.
+
+/// A shader is identified by the hash of its source code, including all files it includes,
+/// macros, entry point, shader type, compilation options and the device type. When the
+/// cache has the bytecode of a shader, the shader is created from the bytecode and the
+/// compilation is skipped. Otherwise, the shader is compiled from source and its bytecode
+/// is written to the cache.
+///
+/// Only the Vulkan backend exposes compiled shader bytecode (SPIR-V). With other backends,
+/// and when no cache directory is given, shaders are always compiled from source.
+///
+/// The cache is not thread-safe: all shaders must be created from the same thread.
+class ShaderCache
+{
+public:
+    struct Statistics
+    {
+        // Shaders created from cached bytecode
+        Uint32 Hits = 0;
+        // Shaders compiled from source and written to the cache
+        Uint32 Misses = 0;
+        // Shaders compiled from source that could not be cached
+        Uint32 Uncached = 0;
+        // Total time, in seconds, spent in creating shaders
+        double CreationTime = 0;
+    };
+
+    ShaderCache(IRenderDevice* pDevice, std::string Directory);
+
+    // clang-format off
+    ShaderCache           (const ShaderCache&)  = delete;
+    ShaderCache           (      ShaderCache&&) = delete;
+    ShaderCache& operator=(const ShaderCache&)  = delete;
+    ShaderCache& operator=(      ShaderCache&&) = delete;
+    // clang-format on
+
+    /// Creates the shader from cached bytecode if it is available, and compiles it from source otherwise
+    void CreateShader(const ShaderCreateInfo& ShaderCI, IShader** ppShader);
+
+    bool IsEnabled() const { return !m_Directory.empty(); }
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+    void LogStatistics() const;
+
+private:
+    bool ComputeHash(const ShaderCreateInfo& ShaderCI, Uint64& Hash) const;
+
+    std::string GetCacheFilePath(Uint64 Hash) const;
+
+    bool LoadByteCode(const std::string& FilePath, Uint64 Hash, std::vector<Uint8>& ByteCode) const;
+    void StoreByteCode(const std::string& FilePath, Uint64 Hash, const std::vector<Uint8>& ByteCode) const;
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    // Empty when the cache is disabled
+    std::string m_Directory;
+
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
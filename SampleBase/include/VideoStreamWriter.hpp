@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "GraphicsTypes.h"
+
+namespace Diligent
+{
+
+/// Appends captured frames to a single uncompressed video stream.
+
+/// Two stream formats are supported:
+/// - Y4M: YUV4MPEG2 stream with full-range BT.601 4:2:0 chroma (C420jpeg)
+/// - Raw: headerless sequence of tightly packed RGBA8 frames
+///
+/// Regular files are written through memory-mapped views. When the target is not a
+/// regular file (a named pipe, or "-" for the standard output), frames are written
+/// with buffered I/O instead.
+class VideoStreamWriter
+{
+public:
+    enum class FORMAT
+    {
+        Y4M,
+        Raw
+    };
+
+    VideoStreamWriter(const std::string& FilePath,
+                      FORMAT             Format,
+                      Uint32             Width,
+                      Uint32             Height,
+                      double             FrameRate);
+    ~VideoStreamWriter();
+
+    // clang-format off
+    VideoStreamWriter           (const VideoStreamWriter&)  = delete;
+    VideoStreamWriter           (      VideoStreamWriter&&) = delete;
+    VideoStreamWriter& operator=(const VideoStreamWriter&)  = delete;
+    VideoStreamWriter& operator=(      VideoStreamWriter&&) = delete;
+    // clang-format on
+
+    /// Converts the frame and appends it to the stream.
+
+    /// \param [in] pData  - pointer to the first row of the frame.
+    /// \param [in] Stride - row stride, in bytes.
+    /// \param [in] Format - pixel format. Only RGBA8 and BGRA8 formats are supported.
+    /// \return true if the frame has been written, and false otherwise.
+    bool WriteFrame(const void* pData, Uint32 Stride, TEXTURE_FORMAT Format);
+
+    Uint32 GetWidth() const { return m_Width; }
+    Uint32 GetHeight() const { return m_Height; }
+    Uint32 GetNumFrames() const { return m_NumFrames; }
+
+    /// Stream output, either memory-mapped or buffered
+    class IOutput;
+
+private:
+    const FORMAT m_Format;
+    const Uint32 m_Width;
+    const Uint32 m_Height;
+    Uint32       m_NumFrames = 0;
+
+    std::unique_ptr<IOutput> m_pOutput;
+};
+
+} // namespace Diligent
@@ -0,0 +1,469 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "PlatformDefinitions.h"
+#include "AssetArchive.hpp"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "FileStream.h"
+#include "FileSystem.hpp"
+#include "TextureUtilities.h"
+#include "Errors.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_ANDROID || PLATFORM_IOS
+#    define ASSET_ARCHIVE_USE_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+std::unique_ptr<AssetArchive> g_pMountedArchive;
+
+// Data blob that references file data in the archive. The archive must outlive the blob.
+class ArchiveDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    using TBase = ObjectBase<IDataBlob>;
+
+    ArchiveDataBlob(IReferenceCounters* pRefCounters, void* pData, size_t Size) :
+        // clang-format off
+        TBase  {pRefCounters},
+        m_pData{pData},
+        m_Size {Size}
+    // clang-format on
+    {
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DataBlob, TBase)
+
+    virtual void Resize(size_t NewSize) override final
+    {
+        UNEXPECTED("Data blobs that reference the asset archive can't be resized");
+    }
+
+    virtual size_t GetSize() override final
+    {
+        return m_Size;
+    }
+
+    virtual void* GetDataPtr() override final
+    {
+        return m_pData;
+    }
+
+private:
+    void* const  m_pData;
+    const size_t m_Size;
+};
+
+// Read-only stream over file data in the archive
+class ArchiveFileStream final : public ObjectBase<IFileStream>
+{
+public:
+    using TBase = ObjectBase<IFileStream>;
+
+    ArchiveFileStream(IReferenceCounters* pRefCounters, const void* pData, size_t Size) :
+        // clang-format off
+        TBase  {pRefCounters},
+        m_pData{static_cast<const Uint8*>(pData)},
+        m_Size {Size}
+    // clang-format on
+    {
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_FileStream, TBase)
+
+    virtual bool Read(void* Data, size_t BufferSize) override final
+    {
+        if (BufferSize > m_Size - m_Pos)
+            return false;
+
+        memcpy(Data, m_pData + m_Pos, BufferSize);
+        m_Pos += BufferSize;
+        return true;
+    }
+
+    virtual void ReadBlob(IDataBlob* pData) override final
+    {
+        pData->Resize(m_Size - m_Pos);
+        Read(pData->GetDataPtr(), m_Size - m_Pos);
+    }
+
+    virtual bool Write(const void* Data, size_t Size) override final
+    {
+        UNEXPECTED("Asset archive is read-only");
+        return false;
+    }
+
+    virtual size_t GetSize() override final
+    {
+        return m_Size;
+    }
+
+    virtual bool IsValid() override final
+    {
+        return true;
+    }
+
+private:
+    const Uint8* const m_pData;
+    const size_t       m_Size;
+    size_t             m_Pos = 0;
+};
+
+// Looks up shader source files in the archive using the same search rules as the default factory:
+// every search directory is tried in order, followed by the name itself. Files that are not in the
+// archive are read by the default factory.
+class ArchiveShaderSourceFactory final : public ObjectBase<IShaderSourceInputStreamFactory>
+{
+public:
+    using TBase = ObjectBase<IShaderSourceInputStreamFactory>;
+
+    ArchiveShaderSourceFactory(IReferenceCounters*              pRefCounters,
+                               const AssetArchive&              Archive,
+                               const Char*                      SearchDirectories,
+                               IShaderSourceInputStreamFactory* pDefaultFactory) :
+        // clang-format off
+        TBase            {pRefCounters},
+        m_Archive        {Archive},
+        m_pDefaultFactory{pDefaultFactory}
+    // clang-format on
+    {
+        std::string Dirs = SearchDirectories != nullptr ? SearchDirectories : "";
+        size_t      Pos  = 0;
+        while (Pos < Dirs.length())
+        {
+            auto End = Dirs.find(';', Pos);
+            if (End == std::string::npos)
+                End = Dirs.length();
+
+            auto Dir = NormalizeAssetName(Dirs.substr(Pos, End - Pos).c_str());
+            if (!Dir.empty())
+            {
+                if (Dir.back() != '/')
+                    Dir.push_back('/');
+                m_SearchDirectories.emplace_back(std::move(Dir));
+            }
+            Pos = End + 1;
+        }
+        m_SearchDirectories.emplace_back("");
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_IShaderSourceInputStreamFactory, TBase)
+
+    virtual void CreateInputStream(const Char* Name, IFileStream** ppStream) override final
+    {
+        *ppStream = nullptr;
+
+        const auto NormalizedName = NormalizeAssetName(Name);
+        for (const auto& Dir : m_SearchDirectories)
+        {
+            size_t Size  = 0;
+            auto*  pData = m_Archive.FindFile((Dir + NormalizedName).c_str(), Size);
+            if (pData != nullptr)
+            {
+                auto* pStream = MakeNewRCObj<ArchiveFileStream>()(pData, Size);
+                pStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+                return;
+            }
+        }
+
+        m_pDefaultFactory->CreateInputStream(Name, ppStream);
+    }
+
+private:
+    const AssetArchive&                           m_Archive;
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pDefaultFactory;
+    std::vector<std::string>                       m_SearchDirectories;
+};
+
+IMAGE_FILE_FORMAT GetImageFileFormat(const Char* FilePath)
+{
+    std::string Extension{FilePath};
+
+    const auto DotPos = Extension.find_last_of('.');
+    Extension         = DotPos != std::string::npos ? Extension.substr(DotPos + 1) : "";
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (Extension == "png")
+        return IMAGE_FILE_FORMAT_PNG;
+    else if (Extension == "jpg" || Extension == "jpeg")
+        return IMAGE_FILE_FORMAT_JPEG;
+    else if (Extension == "tif" || Extension == "tiff")
+        return IMAGE_FILE_FORMAT_TIFF;
+    else if (Extension == "dds")
+        return IMAGE_FILE_FORMAT_DDS;
+    else if (Extension == "ktx")
+        return IMAGE_FILE_FORMAT_KTX;
+    else
+        return IMAGE_FILE_FORMAT_UNKNOWN;
+}
+
+// Checks that [Offset, Offset + Size) lies within [0, TotalSize) without overflowing
+bool IsRangeValid(Uint64 Offset, Uint64 Size, Uint64 TotalSize)
+{
+    return Offset <= TotalSize && Size <= TotalSize - Offset;
+}
+
+} // namespace
+
+AssetArchive::AssetArchive(const Char* FilePath)
+{
+#if PLATFORM_WIN32
+    auto hFile = CreateFileA(FilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        LOG_ERROR_MESSAGE("Failed to open asset archive '", FilePath, "'");
+        return;
+    }
+
+    LARGE_INTEGER FileSize = {};
+    GetFileSizeEx(hFile, &FileSize);
+    // Copy-on-write mapping
+    auto hMapping = FileSize.QuadPart > 0 ? CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+    CloseHandle(hFile);
+    if (hMapping != nullptr)
+    {
+        m_pData = static_cast<Uint8*>(MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0));
+        m_Size  = static_cast<size_t>(FileSize.QuadPart);
+        CloseHandle(hMapping);
+    }
+#elif ASSET_ARCHIVE_USE_MMAP
+    auto fd = open(FilePath, O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR_MESSAGE("Failed to open asset archive '", FilePath, "'");
+        return;
+    }
+
+    struct stat FileStat;
+    if (fstat(fd, &FileStat) == 0 && FileStat.st_size > 0)
+    {
+        m_Size = static_cast<size_t>(FileStat.st_size);
+        // Copy-on-write mapping
+        auto* pData = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (pData != MAP_FAILED)
+            m_pData = static_cast<Uint8*>(pData);
+    }
+    close(fd);
+#else
+    LOG_ERROR_MESSAGE("Asset archives are not supported on this platform");
+#endif
+
+    if (m_pData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to map asset archive '", FilePath, "'");
+        m_Size = 0;
+        return;
+    }
+
+    AssetArchiveHeader Header;
+    if (m_Size >= sizeof(Header))
+        memcpy(&Header, m_pData, sizeof(Header));
+
+    const auto IndexSize = Uint64{Header.NumFiles} * sizeof(AssetArchiveEntry);
+    if (m_Size < sizeof(Header) || Header.Magic != AssetArchiveMagic || Header.Version != AssetArchiveVersion ||
+        Header.IndexOffset % alignof(AssetArchiveEntry) != 0 || !IsRangeValid(Header.IndexOffset, IndexSize, m_Size) ||
+        !IsRangeValid(Header.NamesOffset, Header.NamesSize, m_Size))
+    {
+        LOG_ERROR_MESSAGE("'", FilePath, "' is not a valid asset archive");
+        Close();
+        return;
+    }
+
+    // Validate all entries once, so that FindFile() can use them without checks. The index must also
+    // be sorted by name hash for the binary search.
+    const auto* pEntries = reinterpret_cast<const AssetArchiveEntry*>(m_pData + Header.IndexOffset);
+    for (Uint32 i = 0; i < Header.NumFiles; ++i)
+    {
+        const auto& Entry = pEntries[i];
+        if (!IsRangeValid(Entry.DataOffset, Entry.DataSize, m_Size) ||
+            !IsRangeValid(Entry.NameOffset, Entry.NameLength, Header.NamesSize) ||
+            (i > 0 && Entry.NameHash < pEntries[i - 1].NameHash))
+        {
+            LOG_ERROR_MESSAGE("Asset archive '", FilePath, "' has invalid entry ", i);
+            Close();
+            return;
+        }
+    }
+
+    m_pEntries = pEntries;
+    m_pNames   = reinterpret_cast<const Char*>(m_pData + Header.NamesOffset);
+    m_NumFiles = Header.NumFiles;
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+void AssetArchive::Close()
+{
+    if (m_pData != nullptr)
+    {
+#if PLATFORM_WIN32
+        UnmapViewOfFile(m_pData);
+#elif ASSET_ARCHIVE_USE_MMAP
+        munmap(m_pData, m_Size);
+#endif
+    }
+
+    m_pData    = nullptr;
+    m_Size     = 0;
+    m_pEntries = nullptr;
+    m_pNames   = nullptr;
+    m_NumFiles = 0;
+}
+
+void* AssetArchive::FindFile(const Char* Name, size_t& Size) const
+{
+    Size = 0;
+    if (m_pData == nullptr)
+        return nullptr;
+
+    const auto NormalizedName = NormalizeAssetName(Name);
+    const auto Hash           = ComputeAssetNameHash(NormalizedName);
+
+    const auto* pEnd   = m_pEntries + m_NumFiles;
+    const auto* pEntry = std::lower_bound(m_pEntries, pEnd, Hash,
+                                          [](const AssetArchiveEntry& Entry, Uint64 Hash) { return Entry.NameHash < Hash; });
+    for (; pEntry != pEnd && pEntry->NameHash == Hash; ++pEntry)
+    {
+        if (pEntry->NameLength == NormalizedName.length() &&
+            memcmp(m_pNames + pEntry->NameOffset, NormalizedName.data(), NormalizedName.length()) == 0)
+        {
+            Size = static_cast<size_t>(pEntry->DataSize);
+            return m_pData + pEntry->DataOffset;
+        }
+    }
+
+    return nullptr;
+}
+
+bool AssetArchive::Mount(const Char* FilePath)
+{
+    std::unique_ptr<AssetArchive> pArchive{new AssetArchive{FilePath}};
+    if (!pArchive->IsOpen())
+        return false;
+
+    LOG_INFO_MESSAGE("Mounted asset archive '", FilePath, "' with ", pArchive->GetNumFiles(), " files");
+    g_pMountedArchive = std::move(pArchive);
+    return true;
+}
+
+void AssetArchive::Unmount()
+{
+    g_pMountedArchive.reset();
+}
+
+AssetArchive* AssetArchive::GetMounted()
+{
+    return g_pMountedArchive.get();
+}
+
+void CreateAssetShaderSourceStreamFactory(IEngineFactory*                   pEngineFactory,
+                                          const Char*                       SearchDirectories,
+                                          IShaderSourceInputStreamFactory** ppFactory)
+{
+    *ppFactory = nullptr;
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pDefaultFactory;
+    pEngineFactory->CreateDefaultShaderSourceStreamFactory(SearchDirectories, &pDefaultFactory);
+
+    const auto* pArchive = AssetArchive::GetMounted();
+    if (pArchive == nullptr)
+    {
+        *ppFactory = pDefaultFactory.Detach();
+        return;
+    }
+
+    auto* pFactory = MakeNewRCObj<ArchiveShaderSourceFactory>()(*pArchive, SearchDirectories, pDefaultFactory);
+    pFactory->QueryInterface(IID_IShaderSourceInputStreamFactory, reinterpret_cast<IObject**>(ppFactory));
+}
+
+void CreateImageFromAsset(const Char* FilePath, Image** ppImage, IDataBlob** ppRawData)
+{
+    const auto* pArchive = AssetArchive::GetMounted();
+
+    size_t Size  = 0;
+    auto*  pData = pArchive != nullptr ? pArchive->FindFile(FilePath, Size) : nullptr;
+    if (pData == nullptr)
+    {
+        CreateImageFromFile(FilePath, ppImage, ppRawData);
+        return;
+    }
+
+    RefCntAutoPtr<IDataBlob> pFileData{MakeNewRCObj<ArchiveDataBlob>()(pData, Size)};
+
+    ImageLoadInfo LoadInfo;
+    LoadInfo.Format = GetImageFileFormat(FilePath);
+    switch (LoadInfo.Format)
+    {
+        case IMAGE_FILE_FORMAT_DDS:
+        case IMAGE_FILE_FORMAT_KTX:
+            if (ppRawData != nullptr)
+                *ppRawData = pFileData.Detach();
+            break;
+
+        case IMAGE_FILE_FORMAT_UNKNOWN:
+            LOG_ERROR_MESSAGE("Unable to derive image format from the file name '", FilePath, "'");
+            break;
+
+        default:
+            Image::CreateFromDataBlob(pFileData, LoadInfo, ppImage);
+    }
+}
+
+bool AssetExists(const Char* FilePath)
+{
+    size_t      Size     = 0;
+    const auto* pArchive = AssetArchive::GetMounted();
+    if (pArchive != nullptr && pArchive->FindFile(FilePath, Size) != nullptr)
+        return true;
+
+    return FileSystem::FileExists(FilePath);
+}
+
+} // namespace Diligent
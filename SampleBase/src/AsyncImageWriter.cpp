@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "AsyncImageWriter.hpp"
+#include "FileWrapper.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+AsyncImageWriter::AsyncImageWriter(Uint32 NumThreads, Uint32 MaxPendingImages, bool DropWhenFull) :
+    // clang-format off
+    m_MaxPendingImages{std::max(MaxPendingImages, 1u)},
+    m_DropWhenFull    {DropWhenFull}
+// clang-format on
+{
+    NumThreads = std::max(NumThreads, 1u);
+    m_WorkerThreads.reserve(NumThreads);
+    for (Uint32 t = 0; t < NumThreads; ++t)
+        m_WorkerThreads.emplace_back(&AsyncImageWriter::WorkerThreadFunc, this);
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_bStop = true;
+    }
+    m_TaskAvailableCV.notify_all();
+
+    // Workers drain the queue before exiting, so no captures are lost
+    for (auto& Thread : m_WorkerThreads)
+        Thread.join();
+}
+
+bool AsyncImageWriter::Enqueue(std::string FileName, const Image::EncodeInfo& Info)
+{
+    const size_t DataSize = size_t{Info.Stride} * size_t{Info.Height};
+
+    std::vector<Uint8> Pixels;
+    {
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        if (m_NumPendingImages >= m_MaxPendingImages)
+        {
+            if (m_DropWhenFull)
+            {
+                ++m_NumDroppedImages;
+                return false;
+            }
+
+            // Apply backpressure: stall the render thread until a worker is done
+            ++m_NumLateImages;
+            m_TaskCompletedCV.wait(Lock, [this] { return m_NumPendingImages < m_MaxPendingImages; });
+        }
+        ++m_NumPendingImages;
+
+        if (!m_BufferPool.empty())
+        {
+            Pixels = std::move(m_BufferPool.back());
+            m_BufferPool.pop_back();
+        }
+    }
+
+    Pixels.resize(DataSize);
+    memcpy(Pixels.data(), Info.pData, DataSize);
+
+    Task NewTask;
+    NewTask.FileName   = std::move(FileName);
+    NewTask.Info       = Info;
+    NewTask.Info.pData = nullptr;
+    NewTask.Pixels     = std::move(Pixels);
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Tasks.emplace_back(std::move(NewTask));
+    }
+    m_TaskAvailableCV.notify_one();
+
+    return true;
+}
+
+void AsyncImageWriter::WaitForIdle()
+{
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_TaskCompletedCV.wait(Lock, [this] { return m_NumPendingImages == 0; });
+}
+
+Uint32 AsyncImageWriter::GetNumWrittenImages() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_NumWrittenImages;
+}
+
+Uint32 AsyncImageWriter::GetNumFailedImages() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_NumFailedImages;
+}
+
+Uint32 AsyncImageWriter::GetNumDroppedImages() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_NumDroppedImages;
+}
+
+Uint32 AsyncImageWriter::GetNumLateImages() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_NumLateImages;
+}
+
+void AsyncImageWriter::WorkerThreadFunc()
+{
+    for (;;)
+    {
+        Task CurrTask;
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_TaskAvailableCV.wait(Lock, [this] { return !m_Tasks.empty() || m_bStop; });
+            if (m_Tasks.empty())
+                return;
+
+            CurrTask = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+
+        const auto Written = WriteImage(CurrTask);
+
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_BufferPool.emplace_back(std::move(CurrTask.Pixels));
+            if (Written)
+                ++m_NumWrittenImages;
+            else
+                ++m_NumFailedImages;
+            --m_NumPendingImages;
+        }
+        m_TaskCompletedCV.notify_all();
+    }
+}
+
+bool AsyncImageWriter::WriteImage(Task& task)
+{
+    task.Info.pData = task.Pixels.data();
+
+    RefCntAutoPtr<IDataBlob> pEncodedImage;
+    Image::Encode(task.Info, &pEncodedImage);
+    if (!pEncodedImage)
+    {
+        LOG_ERROR_MESSAGE("Failed to encode screen capture '", task.FileName, "'.");
+        return false;
+    }
+
+    FileWrapper pFile(task.FileName.c_str(), EFileAccessMode::Overwrite);
+    if (!pFile)
+    {
+        LOG_ERROR_MESSAGE("Failed to create screen capture file '", task.FileName, "'. Verify that the directory exists and the app has sufficient rights to write to this directory.");
+        return false;
+    }
+
+    auto res = pFile->Write(pEncodedImage->GetDataPtr(), pEncodedImage->GetSize());
+    pFile.Close();
+    if (!res)
+    {
+        LOG_ERROR_MESSAGE("Failed to write screen capture file '", task.FileName, "'.");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
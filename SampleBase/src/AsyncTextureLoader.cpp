@@ -0,0 +1,257 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cctype>
+
+#include "AsyncTextureLoader.hpp"
+#include "AssetArchive.hpp"
+#include "CookedTextures.hpp"
+#include "CPUProfiler.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+std::string GetFileExtension(const std::string& FilePath)
+{
+    const auto DotPos = FilePath.find_last_of('.');
+    if (DotPos == std::string::npos)
+        return "";
+
+    auto Extension = FilePath.substr(DotPos + 1);
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+    return Extension;
+}
+
+} // namespace
+
+AsyncTextureLoader::AsyncTextureLoader(IRenderDevice* pDevice, Uint32 NumThreads) :
+    m_pDevice{pDevice}
+{
+    const Uint32 Gray = 0xFF808080;
+
+    TextureSubResData Mip0;
+    Mip0.pData  = &Gray;
+    Mip0.Stride = sizeof(Gray);
+
+    TextureData InitData;
+    InitData.pSubResources   = &Mip0;
+    InitData.NumSubresources = 1;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Placeholder texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = 1;
+    TexDesc.Height    = 1;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Usage     = USAGE_STATIC;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    m_pDevice->CreateTexture(TexDesc, &InitData, &m_pPlaceholder);
+    if (m_pPlaceholder)
+        m_pPlaceholderSRV = m_pPlaceholder->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    else
+        LOG_ERROR_MESSAGE("Failed to create placeholder texture");
+
+    NumThreads = std::max(NumThreads, 1u);
+    m_WorkerThreads.reserve(NumThreads);
+    for (Uint32 t = 0; t < NumThreads; ++t)
+        m_WorkerThreads.emplace_back(&AsyncTextureLoader::WorkerThreadFunc, this, t);
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_bStop = true;
+    }
+    m_RequestAvailableCV.notify_all();
+
+    // Textures that have not been loaded yet are discarded
+    for (auto& Thread : m_WorkerThreads)
+        Thread.join();
+}
+
+ITextureView* AsyncTextureLoader::LoadTexture(const Char* FilePath, const TextureLoadInfo& LoadInfo, LoadedCallback Callback)
+{
+    Request Req;
+    Req.FilePath = FilePath;
+    Req.Name     = LoadInfo.Name != nullptr ? LoadInfo.Name : FilePath;
+    Req.LoadInfo = LoadInfo;
+    Req.Callback = std::move(Callback);
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Requests.emplace_back(std::move(Req));
+    }
+    m_RequestAvailableCV.notify_one();
+
+    ++m_NumPendingTextures;
+    return m_pPlaceholderSRV;
+}
+
+void AsyncTextureLoader::Update(IDeviceContext* pContext, Uint32 MaxTextures)
+{
+    std::vector<StateTransitionDesc> Barriers;
+    if (!m_bPlaceholderTransitioned && m_pPlaceholder)
+    {
+        Barriers.emplace_back(m_pPlaceholder, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
+        m_bPlaceholderTransitioned = true;
+    }
+
+    std::vector<Request> DecodedRequests;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        while (!m_DecodedRequests.empty() && DecodedRequests.size() < MaxTextures)
+        {
+            DecodedRequests.emplace_back(std::move(m_DecodedRequests.front()));
+            m_DecodedRequests.pop_front();
+        }
+    }
+    if (DecodedRequests.empty() && Barriers.empty())
+        return;
+
+    CPU_PROFILER_SCOPE("CreateLoadedTextures");
+
+    std::vector<RefCntAutoPtr<ITexture>> Textures(DecodedRequests.size());
+    for (size_t i = 0; i < DecodedRequests.size(); ++i)
+    {
+        Textures[i] = CreateTexture(DecodedRequests[i]);
+        if (Textures[i])
+            Barriers.emplace_back(Textures[i], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
+    }
+
+    if (!Barriers.empty())
+        pContext->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
+
+    // Callbacks are called after the barriers, so the textures can be used in the same frame
+    for (size_t i = 0; i < DecodedRequests.size(); ++i)
+    {
+        VERIFY_EXPR(m_NumPendingTextures > 0);
+        --m_NumPendingTextures;
+        if (DecodedRequests[i].Callback)
+            DecodedRequests[i].Callback(Textures[i]);
+    }
+}
+
+void AsyncTextureLoader::Flush(IDeviceContext* pContext)
+{
+    CPU_PROFILER_SCOPE("FlushTextureLoads");
+
+    while (m_NumPendingTextures > 0)
+    {
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_ImageDecodedCV.wait(Lock, [this] { return !m_DecodedRequests.empty(); });
+        }
+        Update(pContext, ~0u);
+    }
+}
+
+void AsyncTextureLoader::WorkerThreadFunc(Uint32 ThreadIdx)
+{
+    CPUProfiler::SetThreadName(("Texture loader " + std::to_string(ThreadIdx)).c_str());
+    for (;;)
+    {
+        Request Req;
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_RequestAvailableCV.wait(Lock, [this] { return !m_Requests.empty() || m_bStop; });
+            if (m_bStop)
+                return;
+
+            Req = std::move(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        {
+            CPU_PROFILER_SCOPE("DecodeTexture");
+
+            auto CookedPath = FindCookedTexture(Req.FilePath.c_str(), Req.LoadInfo);
+            if (!CookedPath.empty())
+            {
+                Req.FilePath = std::move(CookedPath);
+                Req.IsCooked = true;
+            }
+
+            try
+            {
+                // DDS and KTX files are returned as raw data and are parsed when the texture is created
+                CreateImageFromAsset(Req.FilePath.c_str(), &Req.pImage, &Req.pRawData);
+            }
+            catch (...)
+            {
+                // The error has been logged, the callback will receive null texture
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_DecodedRequests.emplace_back(std::move(Req));
+        }
+        m_ImageDecodedCV.notify_all();
+    }
+}
+
+RefCntAutoPtr<ITexture> AsyncTextureLoader::CreateTexture(Request& Req)
+{
+    RefCntAutoPtr<ITexture> pTexture;
+
+    Req.LoadInfo.Name = Req.Name.c_str();
+    try
+    {
+        if (Req.pImage)
+        {
+            CreateTextureFromImage(Req.pImage, Req.LoadInfo, m_pDevice, &pTexture);
+        }
+        else if (Req.pRawData && Req.IsCooked)
+        {
+            CreateTextureFromCookedData(Req.pRawData, Req.LoadInfo, m_pDevice, &pTexture);
+        }
+        else if (Req.pRawData)
+        {
+            const auto Extension = GetFileExtension(Req.FilePath);
+            if (Extension == "dds")
+                CreateTextureFromDDS(Req.pRawData, Req.LoadInfo, m_pDevice, &pTexture);
+            else if (Extension == "ktx")
+                CreateTextureFromKTX(Req.pRawData, Req.LoadInfo, m_pDevice, &pTexture);
+        }
+    }
+    catch (...)
+    {
+        // The error is reported below
+    }
+
+    if (!pTexture)
+        LOG_ERROR_MESSAGE("Failed to load texture '", Req.FilePath, "'.");
+
+    return pTexture;
+}
+
+} // namespace Diligent
@@ -0,0 +1,351 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+#include "CPUProfiler.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+std::atomic<bool> CPUProfiler::s_Enabled{false};
+
+namespace
+{
+
+using ProfilerClock = std::chrono::steady_clock;
+
+const ProfilerClock::time_point g_ProfilerEpoch = ProfilerClock::now();
+
+struct ThreadBuffer
+{
+    // Ids and names are only accessed under the registry mutex
+    Uint32      ThreadId = 0;
+    std::string ThreadName;
+    bool        InUse = false;
+
+    // Ring buffer slots are written by the owning thread only. Slot fields are relaxed atomics
+    // so that readers may copy them concurrently and validate the copy afterwards.
+    struct EventSlot
+    {
+        std::atomic<const char*> Name{nullptr};
+        std::atomic<Uint64>      Start{0};
+        std::atomic<Uint64>      End{0};
+        std::atomic<Uint32>      Depth{0};
+    };
+    std::unique_ptr<EventSlot[]> Events{new EventSlot[CPUProfiler::RingBufferSize]};
+    std::atomic<Uint64>          WriteIdx{0};
+
+    // Events with smaller indices were recorded by a thread that no longer exists
+    // and has released this buffer
+    std::atomic<Uint64> FirstValidIdx{0};
+
+    struct OpenScope
+    {
+        const char* Name  = nullptr;
+        Uint64      Start = 0;
+    };
+    OpenScope Stack[CPUProfiler::MaxDepth];
+    Uint32    Depth = 0;
+};
+
+class ThreadBufferRegistry
+{
+public:
+    static ThreadBufferRegistry& Get()
+    {
+        // The registry is never destroyed as threads may outlive static objects
+        static ThreadBufferRegistry* pRegistry = new ThreadBufferRegistry;
+        return *pRegistry;
+    }
+
+    ThreadBuffer* Acquire(const std::string& ThreadName)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        ThreadBuffer* pBuffer = nullptr;
+        // Reuse buffers of exited threads to keep memory bounded when threads are recreated
+        for (auto& Buffer : m_Buffers)
+        {
+            if (!Buffer->InUse)
+            {
+                pBuffer = Buffer.get();
+                pBuffer->FirstValidIdx.store(pBuffer->WriteIdx.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (pBuffer == nullptr)
+        {
+            m_Buffers.emplace_back(new ThreadBuffer);
+            pBuffer = m_Buffers.back().get();
+        }
+
+        pBuffer->InUse    = true;
+        pBuffer->ThreadId = m_NextThreadId++;
+        pBuffer->ThreadName = ThreadName;
+        pBuffer->Depth      = 0;
+        return pBuffer;
+    }
+
+    void Release(ThreadBuffer* pBuffer)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        pBuffer->InUse = false;
+    }
+
+    void SetThreadName(ThreadBuffer* pBuffer, const char* Name)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        pBuffer->ThreadName = Name != nullptr ? Name : "";
+    }
+
+    template <typename HandlerType>
+    void ProcessBuffers(HandlerType Handler)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        for (auto& Buffer : m_Buffers)
+            Handler(*Buffer);
+    }
+
+private:
+    std::mutex                                 m_Mtx;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_Buffers;
+    Uint32                                     m_NextThreadId = 0;
+};
+
+struct ThreadBufferHolder
+{
+    ~ThreadBufferHolder()
+    {
+        if (pBuffer != nullptr)
+            ThreadBufferRegistry::Get().Release(pBuffer);
+    }
+
+    ThreadBuffer* GetBuffer()
+    {
+        if (pBuffer == nullptr)
+            pBuffer = ThreadBufferRegistry::Get().Acquire(ThreadName);
+        return pBuffer;
+    }
+
+    ThreadBuffer* pBuffer = nullptr;
+
+    // Name of a thread that has not recorded any events yet
+    std::string ThreadName;
+};
+
+thread_local ThreadBufferHolder t_ThreadBuffer;
+
+void WriteJSONString(std::ostream& os, const char* Str)
+{
+    os << '"';
+    for (; Str != nullptr && *Str != '\0'; ++Str)
+    {
+        const auto c = *Str;
+        if (c == '"' || c == '\\')
+            os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            os << ' ';
+        else
+            os << c;
+    }
+    os << '"';
+}
+
+} // namespace
+
+Uint64 CPUProfiler::GetTime()
+{
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(ProfilerClock::now() - g_ProfilerEpoch).count());
+}
+
+void CPUProfiler::SetThreadName(const char* Name)
+{
+    // Do not allocate the ring buffer until the thread records its first event
+    if (t_ThreadBuffer.pBuffer == nullptr)
+        t_ThreadBuffer.ThreadName = Name != nullptr ? Name : "";
+    else
+        ThreadBufferRegistry::Get().SetThreadName(t_ThreadBuffer.pBuffer, Name);
+}
+
+void CPUProfiler::BeginScope(const char* Name)
+{
+    auto* pBuffer = t_ThreadBuffer.GetBuffer();
+    if (pBuffer->Depth < MaxDepth)
+    {
+        auto& Scope = pBuffer->Stack[pBuffer->Depth];
+        Scope.Name  = Name;
+        Scope.Start = GetTime();
+    }
+    ++pBuffer->Depth;
+}
+
+void CPUProfiler::EndScope()
+{
+    const auto EndTime = GetTime();
+
+    auto* pBuffer = t_ThreadBuffer.GetBuffer();
+    if (pBuffer->Depth == 0)
+    {
+        UNEXPECTED("EndScope() is called without matching BeginScope()");
+        return;
+    }
+
+    const auto Depth = --pBuffer->Depth;
+    if (Depth >= MaxDepth)
+        return;
+
+    const auto& Scope = pBuffer->Stack[Depth];
+    const auto  Idx   = pBuffer->WriteIdx.load(std::memory_order_relaxed);
+
+    // Make sure that a reader that sees any of the new slot values also sees
+    // the write index that invalidates the event previously stored in the slot
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& Slot = pBuffer->Events[Idx % RingBufferSize];
+    Slot.Name.store(Scope.Name, std::memory_order_relaxed);
+    Slot.Start.store(Scope.Start, std::memory_order_relaxed);
+    Slot.End.store(EndTime, std::memory_order_relaxed);
+    Slot.Depth.store(Depth, std::memory_order_relaxed);
+
+    // Publish the event to readers
+    pBuffer->WriteIdx.store(Idx + 1, std::memory_order_release);
+}
+
+void CPUProfiler::GetEvents(Uint64 StartTime, Uint64 EndTime, std::vector<ThreadEvents>& Threads)
+{
+    Threads.clear();
+    ThreadBufferRegistry::Get().ProcessBuffers([&](const ThreadBuffer& Buffer) {
+        const auto LastIdx  = Buffer.WriteIdx.load(std::memory_order_acquire);
+        const auto FirstIdx = std::max(Buffer.FirstValidIdx.load(std::memory_order_relaxed),
+                                       LastIdx > RingBufferSize ? LastIdx - RingBufferSize : Uint64{0});
+
+        ThreadEvents Thread;
+        Thread.ThreadId   = Buffer.ThreadId;
+        Thread.ThreadName = Buffer.ThreadName;
+
+        // Events are stored in the order of their end times, so walk
+        // backwards until an event that ends before the interval is found.
+        for (auto Idx = LastIdx; Idx > FirstIdx; --Idx)
+        {
+            const auto& Slot = Buffer.Events[(Idx - 1) % RingBufferSize];
+
+            Event Evt;
+            Evt.Name  = Slot.Name.load(std::memory_order_relaxed);
+            Evt.Start = Slot.Start.load(std::memory_order_relaxed);
+            Evt.End   = Slot.End.load(std::memory_order_relaxed);
+            Evt.Depth = Slot.Depth.load(std::memory_order_relaxed);
+            if (Evt.End < StartTime)
+                break;
+            Thread.Events.push_back(Evt);
+        }
+
+        // The owning thread may have wrapped around the ring buffer while the events
+        // were being copied. Drop the events whose slots could have been overwritten.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto NewLastIdx = Buffer.WriteIdx.load(std::memory_order_relaxed);
+        if (NewLastIdx >= RingBufferSize)
+        {
+            // Events were copied starting from LastIdx - 1 going back
+            const auto OldestValidIdx = NewLastIdx - RingBufferSize + 1;
+            const auto NumValid       = LastIdx > OldestValidIdx ? LastIdx - OldestValidIdx : 0;
+            if (Thread.Events.size() > NumValid)
+                Thread.Events.resize(static_cast<size_t>(NumValid));
+        }
+
+        Thread.Events.erase(std::remove_if(Thread.Events.begin(), Thread.Events.end(),
+                                           [EndTime](const Event& Evt) { return Evt.Start > EndTime; }),
+                            Thread.Events.end());
+
+        if (!Thread.Events.empty())
+        {
+            std::reverse(Thread.Events.begin(), Thread.Events.end());
+            Threads.emplace_back(std::move(Thread));
+        }
+    });
+
+    std::sort(Threads.begin(), Threads.end(), [](const ThreadEvents& lhs, const ThreadEvents& rhs) {
+        return lhs.ThreadId < rhs.ThreadId;
+    });
+}
+
+bool CPUProfiler::WriteChromeTrace(const char* FilePath)
+{
+    std::vector<ThreadEvents> Threads;
+    GetEvents(0, std::numeric_limits<Uint64>::max(), Threads);
+
+    std::ofstream Trace{FilePath};
+    if (!Trace)
+    {
+        LOG_ERROR_MESSAGE("Failed to create CPU profiler trace file '", FilePath, "'.");
+        return false;
+    }
+
+    size_t NumEvents = 0;
+    Trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    Trace << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"CPU\"}}";
+    Trace << std::fixed << std::setprecision(3);
+    for (const auto& Thread : Threads)
+    {
+        Trace << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << Thread.ThreadId << ",\"args\":{\"name\":";
+        if (!Thread.ThreadName.empty())
+            WriteJSONString(Trace, Thread.ThreadName.c_str());
+        else
+            Trace << "\"Thread " << Thread.ThreadId << '"';
+        Trace << "}}";
+
+        for (const auto& Evt : Thread.Events)
+        {
+            // Complete events with microsecond timestamps
+            Trace << ",\n{\"name\":";
+            WriteJSONString(Trace, Evt.Name);
+            Trace << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << Thread.ThreadId
+                  << ",\"ts\":" << static_cast<double>(Evt.Start) / 1000.0
+                  << ",\"dur\":" << static_cast<double>(Evt.End - Evt.Start) / 1000.0 << '}';
+        }
+        NumEvents += Thread.Events.size();
+    }
+    Trace << "\n]}\n";
+
+    if (!Trace)
+    {
+        LOG_ERROR_MESSAGE("Failed to write CPU profiler trace file '", FilePath, "'.");
+        return false;
+    }
+
+    LOG_INFO_MESSAGE("CPU profiler trace with ", NumEvents, " events from ", Threads.size(), " threads is written to '", FilePath, "'.");
+    return true;
+}
+
+} // namespace Diligent
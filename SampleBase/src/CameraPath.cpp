@@ -0,0 +1,193 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "CameraPath.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Camera path files start with this header followed by the keys.
+// The version must be incremented whenever the file format changes.
+struct CameraPathFileHeader
+{
+    Uint32 Magic    = 0;
+    Uint32 Version  = 0;
+    Uint32 NumKeys  = 0;
+    Uint32 Reserved = 0;
+};
+
+static constexpr Uint32 CameraPathFileMagic   = 0x50434744; // "DGCP"
+static constexpr Uint32 CameraPathFileVersion = 1;
+
+static_assert(sizeof(CameraPath::Key) == sizeof(float) * 6, "Keys are written to the file as is, so they must not contain padding");
+
+template <typename T>
+T CatmullRom(const T& P0, const T& P1, const T& P2, const T& P3, float t)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return (P1 * 2.f +
+            (P2 - P0) * t +
+            (P0 * 2.f - P1 * 5.f + P2 * 4.f - P3) * t2 +
+            (P1 * 3.f - P0 - P2 * 3.f + P3) * t3) *
+        0.5f;
+}
+
+} // namespace
+
+void CameraPath::Record(double Time, const CameraPose& Pose)
+{
+    if (!m_Keys.empty())
+    {
+        VERIFY(Time >= m_Keys.back().Time, "Camera path keys must be recorded in time order");
+        if (Time - m_Keys.back().Time < m_KeyInterval)
+            return;
+    }
+
+    Key NewKey;
+    NewKey.Time = static_cast<float>(Time);
+    NewKey.Pose = Pose;
+    m_Keys.push_back(NewKey);
+}
+
+CameraPose CameraPath::Evaluate(double Time) const
+{
+    if (m_Keys.empty())
+        return CameraPose{};
+
+    const auto Duration = GetDuration();
+    if (m_Keys.size() == 1 || Duration <= 0)
+        return m_Keys.front().Pose;
+
+    Time = std::fmod(Time, Duration);
+    if (Time < 0)
+        Time += Duration;
+
+    // Find the segment [Key1, Key2] that contains the time
+    auto It = std::upper_bound(m_Keys.begin(), m_Keys.end(), static_cast<float>(Time),
+                               [](float t, const Key& k) { return t < k.Time; });
+    const size_t Key2 = std::min(static_cast<size_t>(It - m_Keys.begin()), m_Keys.size() - 1);
+    const size_t Key1 = Key2 > 0 ? Key2 - 1 : 0;
+    const size_t Key0 = Key1 > 0 ? Key1 - 1 : Key1;
+    const size_t Key3 = std::min(Key2 + 1, m_Keys.size() - 1);
+
+    const auto& K0 = m_Keys[Key0].Pose;
+    const auto& K1 = m_Keys[Key1].Pose;
+    const auto& K2 = m_Keys[Key2].Pose;
+    const auto& K3 = m_Keys[Key3].Pose;
+
+    const float SegmentLen = m_Keys[Key2].Time - m_Keys[Key1].Time;
+    const float t          = SegmentLen > 0 ? clamp((static_cast<float>(Time) - m_Keys[Key1].Time) / SegmentLen, 0.f, 1.f) : 0.f;
+
+    CameraPose Pose;
+    Pose.Position = CatmullRom(K0.Position, K1.Position, K2.Position, K3.Position, t);
+    Pose.Yaw      = CatmullRom(K0.Yaw, K1.Yaw, K2.Yaw, K3.Yaw, t);
+    Pose.Pitch    = CatmullRom(K0.Pitch, K1.Pitch, K2.Pitch, K3.Pitch, t);
+    return Pose;
+}
+
+bool CameraPath::Load(const char* FilePath)
+{
+    m_Keys.clear();
+
+    if (!FileSystem::FileExists(FilePath))
+    {
+        LOG_ERROR_MESSAGE("Camera path file '", FilePath, "' does not exist");
+        return false;
+    }
+
+    FileWrapper pFile(FilePath, EFileAccessMode::Read);
+    if (!pFile)
+    {
+        LOG_ERROR_MESSAGE("Failed to open camera path file '", FilePath, "'");
+        return false;
+    }
+
+    CameraPathFileHeader Header;
+
+    const auto FileSize = pFile->GetSize();
+    if (FileSize < sizeof(Header) || !pFile->Read(&Header, sizeof(Header)) ||
+        Header.Magic != CameraPathFileMagic || Header.Version != CameraPathFileVersion ||
+        Header.NumKeys == 0 || FileSize != sizeof(Header) + sizeof(Key) * size_t{Header.NumKeys})
+    {
+        LOG_ERROR_MESSAGE("Camera path file '", FilePath, "' is invalid");
+        return false;
+    }
+
+    m_Keys.resize(Header.NumKeys);
+    if (!pFile->Read(m_Keys.data(), sizeof(Key) * m_Keys.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to read camera path file '", FilePath, "'");
+        m_Keys.clear();
+        return false;
+    }
+
+    for (size_t i = 1; i < m_Keys.size(); ++i)
+    {
+        if (m_Keys[i].Time < m_Keys[i - 1].Time)
+        {
+            LOG_ERROR_MESSAGE("Keys of camera path '", FilePath, "' are not sorted by time");
+            m_Keys.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CameraPath::Save(const char* FilePath) const
+{
+    FileWrapper pFile(FilePath, EFileAccessMode::Overwrite);
+    if (!pFile)
+    {
+        LOG_ERROR_MESSAGE("Failed to create camera path file '", FilePath, "'");
+        return false;
+    }
+
+    CameraPathFileHeader Header;
+    Header.Magic   = CameraPathFileMagic;
+    Header.Version = CameraPathFileVersion;
+    Header.NumKeys = static_cast<Uint32>(m_Keys.size());
+    if (!pFile->Write(&Header, sizeof(Header)) || !pFile->Write(m_Keys.data(), sizeof(Key) * m_Keys.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write camera path file '", FilePath, "'");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
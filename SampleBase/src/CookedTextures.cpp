@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "CookedTextures.hpp"
+#include "AssetArchive.hpp"
+#include "Image.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr Uint32 DDSMagic = 0x20534444; // "DDS "
+
+// Loads the texture from the asset archive, or from disk if the archive does not contain the file
+void CreateTextureFromAsset(const Char* FilePath, const TextureLoadInfo& LoadInfo, IRenderDevice* pDevice, ITexture** ppTexture)
+{
+    RefCntAutoPtr<Image>     pImage;
+    RefCntAutoPtr<IDataBlob> pRawData;
+    CreateImageFromAsset(FilePath, &pImage, &pRawData);
+    if (pImage)
+    {
+        CreateTextureFromImage(pImage, LoadInfo, pDevice, ppTexture);
+    }
+    else if (pRawData && pRawData->GetSize() >= sizeof(Uint32))
+    {
+        Uint32 Magic = 0;
+        memcpy(&Magic, pRawData->GetDataPtr(), sizeof(Magic));
+        if (Magic == DDSMagic)
+            CreateTextureFromDDS(pRawData, LoadInfo, pDevice, ppTexture);
+        else
+            CreateTextureFromKTX(pRawData, LoadInfo, pDevice, ppTexture);
+    }
+}
+
+} // namespace
+
+std::string FindCookedTexture(const Char* FilePath, const TextureLoadInfo& LoadInfo)
+{
+    // Cooked textures always have the full mip chain
+    if (!LoadInfo.GenerateMips || LoadInfo.MipLevels != 0)
+        return "";
+
+    std::string CookedPath = "cooked/";
+    CookedPath += FilePath;
+    // Color textures are cooked separately with sRGB formats, so that their mip levels are
+    // filtered in linear space
+    CookedPath += LoadInfo.IsSRGB ? ".srgb.dds" : ".dds";
+    std::replace(CookedPath.begin(), CookedPath.end(), '\\', '/');
+
+    return AssetExists(CookedPath.c_str()) ? CookedPath : "";
+}
+
+void CreateTextureFromCookedData(IDataBlob* pDDSData, const TextureLoadInfo& LoadInfo, IRenderDevice* pDevice, ITexture** ppTexture)
+{
+    // The cooked texture found by FindCookedTexture() already has sRGB or linear format
+    CreateTextureFromDDS(pDDSData, LoadInfo, pDevice, ppTexture);
+}
+
+void CreateTextureFromFilePreferCooked(const Char* FilePath, const TextureLoadInfo& LoadInfo, IRenderDevice* pDevice, ITexture** ppTexture)
+{
+    const auto CookedPath = FindCookedTexture(FilePath, LoadInfo);
+    if (CookedPath.empty())
+    {
+        CreateTextureFromAsset(FilePath, LoadInfo, pDevice, ppTexture);
+        return;
+    }
+
+    // DDS files are not decoded and are returned as raw data
+    RefCntAutoPtr<Image>     pImage;
+    RefCntAutoPtr<IDataBlob> pDDSData;
+    CreateImageFromAsset(CookedPath.c_str(), &pImage, &pDDSData);
+    if (pDDSData)
+        CreateTextureFromCookedData(pDDSData, LoadInfo, pDevice, ppTexture);
+    else
+        CreateTextureFromAsset(FilePath, LoadInfo, pDevice, ppTexture);
+}
+
+} // namespace Diligent
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "DynamicRingBuffer.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+DynamicRingBuffer::DynamicRingBuffer(IRenderDevice* pDevice,
+                                     const Char*    Name,
+                                     BIND_FLAGS     BindFlags,
+                                     Uint32         Size,
+                                     Uint32         NumContexts,
+                                     Uint32         Alignment) :
+    // clang-format off
+    m_Size     {Size},
+    m_Alignment{Alignment},
+    m_Contexts (NumContexts)
+// clang-format on
+{
+    VERIFY((Alignment & (Alignment - 1)) == 0, "Alignment (", Alignment, ") must be a power of two");
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = Name;
+    BuffDesc.Usage          = USAGE_DYNAMIC;
+    BuffDesc.BindFlags      = BindFlags;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+    BuffDesc.uiSizeInBytes  = Size;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &m_pBuffer);
+    if (!m_pBuffer)
+        LOG_ERROR_MESSAGE("Failed to create dynamic ring buffer '", Name, "'");
+}
+
+void* DynamicRingBuffer::Allocate(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 Size, Uint32& Offset)
+{
+    auto& Ctx = m_Contexts[CtxIdx];
+
+    const auto AlignedOffset = (Ctx.Offset + (m_Alignment - 1)) & ~(m_Alignment - 1);
+    if (!m_pBuffer || AlignedOffset + Size > m_Size)
+        return nullptr;
+
+    if (Ctx.MappedData == nullptr)
+    {
+        // Mapping the buffer again with MAP_FLAG_NO_OVERWRITE would keep the blocks that have already been
+        // allocated, but D3D11.0 deferred contexts only support MAP_FLAG_DISCARD. The buffer is therefore
+        // only mapped once after it has been discarded, and the space left after Unmap() is not used.
+        if (Ctx.Offset != 0)
+            return nullptr;
+
+        Ctx.MappedData.Map(pCtx, m_pBuffer, MAP_WRITE, MAP_FLAG_DISCARD);
+        if (Ctx.MappedData == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to map dynamic ring buffer");
+            return nullptr;
+        }
+    }
+
+    Offset     = AlignedOffset;
+    Ctx.Offset = AlignedOffset + Size;
+    return static_cast<Uint8*>(Ctx.MappedData) + AlignedOffset;
+}
+
+void DynamicRingBuffer::Unmap(Uint32 CtxIdx)
+{
+    m_Contexts[CtxIdx].MappedData.Unmap();
+}
+
+void DynamicRingBuffer::Discard(Uint32 CtxIdx)
+{
+    auto& Ctx = m_Contexts[CtxIdx];
+    Ctx.MappedData.Unmap();
+    Ctx.Offset = 0;
+}
+
+} // namespace Diligent
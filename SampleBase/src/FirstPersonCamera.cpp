@@ -91,6 +91,16 @@ void FirstPersonCamera::Update(InputController& Controller, float ElapsedTime)
         }
     }
 
+    float4x4 WorldRotation = GetRotationMatrix().Transpose();
+
+    float3 PosDeltaWorld = PosDelta * WorldRotation;
+    m_Pos += PosDeltaWorld;
+
+    UpdateMatrices();
+}
+
+float4x4 FirstPersonCamera::GetRotationMatrix() const
+{
     // clang-format off
     float4x4 ReferenceRotation
     {
@@ -101,18 +111,37 @@ void FirstPersonCamera::Update(InputController& Controller, float ElapsedTime)
     };
     // clang-format on
 
-    float4x4 CameraRotation = float4x4::RotationArbitrary(m_ReferenceUpAxis, -m_fYawAngle) *
+    return float4x4::RotationArbitrary(m_ReferenceUpAxis, -m_fYawAngle) *
         float4x4::RotationArbitrary(m_ReferenceRightAxis, -m_fPitchAngle) *
         ReferenceRotation;
-    float4x4 WorldRotation = CameraRotation.Transpose();
+}
 
-    float3 PosDeltaWorld = PosDelta * WorldRotation;
-    m_Pos += PosDeltaWorld;
+void FirstPersonCamera::UpdateMatrices()
+{
+    float4x4 CameraRotation = GetRotationMatrix();
+    float4x4 WorldRotation  = CameraRotation.Transpose();
 
     m_ViewMatrix  = float4x4::Translation(-m_Pos) * CameraRotation;
     m_WorldMatrix = WorldRotation * float4x4::Translation(m_Pos);
 }
 
+CameraPose FirstPersonCamera::GetPose() const
+{
+    CameraPose Pose;
+    Pose.Position = m_Pos;
+    Pose.Yaw      = m_fYawAngle;
+    Pose.Pitch    = m_fPitchAngle;
+    return Pose;
+}
+
+void FirstPersonCamera::SetPose(const CameraPose& Pose)
+{
+    m_Pos         = Pose.Position;
+    m_fYawAngle   = Pose.Yaw;
+    m_fPitchAngle = Pose.Pitch;
+    UpdateMatrices();
+}
+
 void FirstPersonCamera::SetReferenceAxes(const float3& ReferenceRightAxis, const float3& ReferenceUpAxis)
 {
     m_ReferenceRightAxis    = normalize(ReferenceRightAxis);
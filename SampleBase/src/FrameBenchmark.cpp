@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "FrameBenchmark.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+FrameBenchmark::FrameBenchmark(Uint32 NumWarmupFrames, Uint32 NumFrames, std::string OutputFile) :
+    // clang-format off
+    m_NumWarmupFrames{NumWarmupFrames},
+    m_NumFrames      {NumFrames},
+    m_OutputFile     {std::move(OutputFile)}
+// clang-format on
+{
+    m_Frames.reserve(m_NumFrames);
+}
+
+FrameBenchmark::~FrameBenchmark()
+{
+    // Report whatever has been collected if the app is closed before the benchmark completes
+    Finish();
+}
+
+void FrameBenchmark::AddFrame(const FrameTimings& Timings)
+{
+    if (m_NumSkippedFrames < m_NumWarmupFrames)
+    {
+        ++m_NumSkippedFrames;
+        return;
+    }
+
+    if (IsComplete())
+        return;
+
+    m_Frames.push_back(Timings);
+    if (IsComplete())
+        Finish();
+}
+
+FrameBenchmark::Statistics FrameBenchmark::ComputeStatistics(std::vector<double> Values)
+{
+    Statistics Stats;
+    if (Values.empty())
+        return Stats;
+
+    std::sort(Values.begin(), Values.end());
+
+    auto Percentile = [&Values](double p) {
+        auto Rank = static_cast<size_t>(std::ceil(p * static_cast<double>(Values.size())));
+        return Values[std::min(std::max(Rank, size_t{1}), Values.size()) - 1];
+    };
+
+    Stats.Min    = Values.front();
+    Stats.Median = Percentile(0.50);
+    Stats.P95    = Percentile(0.95);
+    Stats.P99    = Percentile(0.99);
+    Stats.Max    = Values.back();
+    return Stats;
+}
+
+void FrameBenchmark::Finish()
+{
+    if (m_bFinished)
+        return;
+    m_bFinished = true;
+
+    if (m_Frames.empty())
+    {
+        LOG_WARNING_MESSAGE("Benchmark finished before any frames were recorded");
+        return;
+    }
+
+    if (!m_OutputFile.empty())
+        WriteCSV();
+    LogStatistics();
+}
+
+void FrameBenchmark::WriteCSV() const
+{
+    std::ofstream CSV{m_OutputFile};
+    if (!CSV)
+    {
+        LOG_ERROR_MESSAGE("Failed to create benchmark output file '", m_OutputFile, "'.");
+        return;
+    }
+
+    CSV << "frame,update_ms,render_ms,present_ms,total_ms,frame_ms\n";
+    CSV << std::fixed << std::setprecision(4);
+    for (size_t i = 0; i < m_Frames.size(); ++i)
+    {
+        const auto& Frame = m_Frames[i];
+        CSV << i << ','
+            << Frame.Update * 1000.0 << ','
+            << Frame.Render * 1000.0 << ','
+            << Frame.Present * 1000.0 << ','
+            << Frame.Total() * 1000.0 << ','
+            << Frame.Frame * 1000.0 << '\n';
+    }
+
+    if (!CSV)
+        LOG_ERROR_MESSAGE("Failed to write benchmark output file '", m_OutputFile, "'.");
+}
+
+void FrameBenchmark::LogStatistics() const
+{
+    std::vector<double> Update, Render, Present, Total, FrameTime;
+    Update.reserve(m_Frames.size());
+    Render.reserve(m_Frames.size());
+    Present.reserve(m_Frames.size());
+    Total.reserve(m_Frames.size());
+    FrameTime.reserve(m_Frames.size());
+    for (const auto& Frame : m_Frames)
+    {
+        Update.push_back(Frame.Update);
+        Render.push_back(Frame.Render);
+        Present.push_back(Frame.Present);
+        Total.push_back(Frame.Total());
+        FrameTime.push_back(Frame.Frame);
+    }
+
+    std::stringstream ss;
+    ss << "Benchmark results (" << m_Frames.size() << " frames, " << m_NumWarmupFrames << " warm-up frames skipped), time in ms:\n";
+    ss << std::setw(10) << "" << std::right
+       << std::setw(9) << "min"
+       << std::setw(9) << "median"
+       << std::setw(9) << "p95"
+       << std::setw(9) << "p99"
+       << std::setw(9) << "max" << '\n';
+    ss << std::fixed << std::setprecision(3);
+
+    auto PrintRow = [&ss](const char* Name, std::vector<double>&& Values) {
+        auto Stats = ComputeStatistics(std::move(Values));
+        ss << std::left << std::setw(10) << Name << std::right
+           << std::setw(9) << Stats.Min * 1000.0
+           << std::setw(9) << Stats.Median * 1000.0
+           << std::setw(9) << Stats.P95 * 1000.0
+           << std::setw(9) << Stats.P99 * 1000.0
+           << std::setw(9) << Stats.Max * 1000.0 << '\n';
+    };
+    PrintRow("Update", std::move(Update));
+    PrintRow("Render", std::move(Render));
+    PrintRow("Present", std::move(Present));
+    PrintRow("Total", std::move(Total));
+    // Wall-clock frame time, including the time spent outside of the sample, e.g. waiting for vsync
+    PrintRow("Frame", std::move(FrameTime));
+
+    LOG_INFO_MESSAGE(ss.str());
+}
+
+} // namespace Diligent
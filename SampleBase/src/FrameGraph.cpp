@@ -0,0 +1,213 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#include "FrameGraph.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+FrameGraph::FrameGraph(IRenderDevice* pDevice) :
+    m_pDevice{pDevice}
+{
+}
+
+Uint32 FrameGraph::ImportTexture(ITexture* pTexture)
+{
+    VERIFY_EXPR(pTexture != nullptr);
+    for (Uint32 i = 0; i < m_Resources.size(); ++i)
+    {
+        if (m_Resources[i].pTexture == pTexture)
+            return i;
+    }
+
+    Resource Res;
+    Res.pTexture = pTexture;
+    m_Resources.emplace_back(Res);
+    return static_cast<Uint32>(m_Resources.size() - 1);
+}
+
+Uint32 FrameGraph::ImportBuffer(IBuffer* pBuffer)
+{
+    VERIFY_EXPR(pBuffer != nullptr);
+    for (Uint32 i = 0; i < m_Resources.size(); ++i)
+    {
+        if (m_Resources[i].pBuffer == pBuffer)
+            return i;
+    }
+
+    Resource Res;
+    Res.pBuffer = pBuffer;
+    m_Resources.emplace_back(Res);
+    return static_cast<Uint32>(m_Resources.size() - 1);
+}
+
+void FrameGraph::MarkOutput(Uint32 Resource)
+{
+    m_Resources[Resource].IsOutput = true;
+}
+
+Uint32 FrameGraph::AddPass(const Char* Name, PassFunction Func)
+{
+    Pass NewPass;
+    NewPass.Name = Name;
+    NewPass.Func = std::move(Func);
+    m_Passes.emplace_back(std::move(NewPass));
+    return static_cast<Uint32>(m_Passes.size() - 1);
+}
+
+void FrameGraph::AddAccess(Uint32 PassIdx, Uint32 ResourceIdx, RESOURCE_STATE State, bool IsWrite)
+{
+    VERIFY_EXPR(PassIdx < m_Passes.size() && ResourceIdx < m_Resources.size());
+
+    // Vulkan backend requires depth textures that are sampled in shaders to be in DEPTH_READ state
+    const auto* pTexture = m_Resources[ResourceIdx].pTexture;
+    if (State == RESOURCE_STATE_SHADER_RESOURCE && pTexture != nullptr &&
+        (pTexture->GetDesc().BindFlags & BIND_DEPTH_STENCIL) != 0 && m_pDevice->GetDeviceCaps().IsVulkanDevice())
+    {
+        State = RESOURCE_STATE_DEPTH_READ;
+    }
+
+    for (auto& Access : m_Passes[PassIdx].Accesses)
+    {
+        if (Access.Resource == ResourceIdx)
+        {
+            // A resource may be read in several states, but can't be read and written at the same time
+            VERIFY(!Access.IsWrite && !IsWrite, "Pass '", m_Passes[PassIdx].Name, "' accesses the same resource for writing more than once");
+            Access.State = static_cast<RESOURCE_STATE>(Access.State | State);
+            return;
+        }
+    }
+
+    ResourceAccess Access;
+    Access.Resource = ResourceIdx;
+    Access.State    = State;
+    Access.IsWrite  = IsWrite;
+    m_Passes[PassIdx].Accesses.emplace_back(Access);
+}
+
+void FrameGraph::AddRead(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State)
+{
+    AddAccess(Pass, Resource, State, false);
+}
+
+void FrameGraph::AddWrite(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State)
+{
+    AddAccess(Pass, Resource, State, true);
+}
+
+void FrameGraph::CullPasses(std::vector<bool>& IsPassUsed)
+{
+    std::vector<bool> IsResourceUsed(m_Resources.size());
+    for (size_t i = 0; i < m_Resources.size(); ++i)
+        IsResourceUsed[i] = m_Resources[i].IsOutput;
+
+    // Walk the passes backwards: a pass is used if it writes a used resource,
+    // and then all resources it reads are used by the earlier passes
+    IsPassUsed.assign(m_Passes.size(), false);
+    for (size_t p = m_Passes.size(); p-- > 0;)
+    {
+        const auto& Accesses = m_Passes[p].Accesses;
+        for (const auto& Access : Accesses)
+        {
+            if (Access.IsWrite && IsResourceUsed[Access.Resource])
+            {
+                IsPassUsed[p] = true;
+                break;
+            }
+        }
+
+        if (IsPassUsed[p])
+        {
+            for (const auto& Access : Accesses)
+                IsResourceUsed[Access.Resource] = true;
+        }
+    }
+}
+
+void FrameGraph::Execute(IDeviceContext* pCtx)
+{
+    std::vector<bool> IsPassUsed;
+    CullPasses(IsPassUsed);
+
+    for (auto& Res : m_Resources)
+        Res.HasPendingUAVWrite = false;
+
+    m_NumCulledPasses = 0;
+    m_NumTransitions  = 0;
+    for (size_t p = 0; p < m_Passes.size(); ++p)
+    {
+        if (!IsPassUsed[p])
+        {
+            ++m_NumCulledPasses;
+            continue;
+        }
+
+        const auto& CurrPass = m_Passes[p];
+
+        // The engine keeps track of resource states, so there is no need to duplicate it in the graph.
+        // This also accounts for transitions performed by the passes themselves.
+        m_Barriers.clear();
+        for (const auto& Access : CurrPass.Accesses)
+        {
+            auto& Res = m_Resources[Access.Resource];
+
+            const auto CurrState = Res.pTexture != nullptr ? Res.pTexture->GetState() : Res.pBuffer->GetState();
+            // Read states may be combined, while write states must match exactly
+            const auto IsInRequiredState = Access.IsWrite ?
+                CurrState == Access.State :
+                (CurrState & Access.State) == Access.State;
+
+            // Transition from UNORDERED_ACCESS to UNORDERED_ACCESS is executed as a UAV barrier
+            const auto IsUAVWrite      = Access.IsWrite && (Access.State & RESOURCE_STATE_UNORDERED_ACCESS) != 0;
+            const auto NeedsUAVBarrier = IsUAVWrite || Res.HasPendingUAVWrite;
+            Res.HasPendingUAVWrite     = IsUAVWrite;
+            if (IsInRequiredState && !NeedsUAVBarrier)
+                continue;
+
+            if (Res.pTexture != nullptr)
+                m_Barriers.emplace_back(Res.pTexture, RESOURCE_STATE_UNKNOWN, Access.State, true);
+            else
+                m_Barriers.emplace_back(Res.pBuffer, RESOURCE_STATE_UNKNOWN, Access.State, true);
+        }
+
+        if (!m_Barriers.empty())
+        {
+            pCtx->TransitionResourceStates(static_cast<Uint32>(m_Barriers.size()), m_Barriers.data());
+            m_NumTransitions += static_cast<Uint32>(m_Barriers.size());
+        }
+
+        CurrPass.Func(pCtx);
+    }
+}
+
+void FrameGraph::Clear()
+{
+    m_Resources.clear();
+    m_Passes.clear();
+}
+
+} // namespace Diligent
@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+
+#include "FramePipeline.hpp"
+#include "CPUProfiler.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+FramePipeline::FramePipeline(Uint32 MaxFrameLatency, SimulateCallbackType SimulateCallback) :
+    // clang-format off
+    m_MaxFrameLatency {std::min(MaxFrameLatency, NumSnapshots - 1)},
+    m_SimulateCallback{std::move(SimulateCallback)}
+// clang-format on
+{
+    VERIFY_EXPR(m_SimulateCallback);
+    if (MaxFrameLatency > m_MaxFrameLatency)
+        LOG_WARNING_MESSAGE("Maximum frame latency is clamped to ", m_MaxFrameLatency);
+
+    if (m_MaxFrameLatency > 0)
+        m_UpdateThread = std::thread{&FramePipeline::UpdateThreadFunc, this};
+}
+
+FramePipeline::~FramePipeline()
+{
+    if (m_UpdateThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_bStop = true;
+        }
+        m_UpdateRequestedCV.notify_one();
+        m_UpdateThread.join();
+    }
+}
+
+void FramePipeline::WaitForUpdate()
+{
+    if (!m_UpdateThread.joinable())
+        return;
+
+    CPU_PROFILER_SCOPE("WaitForUpdate");
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_UpdateCompletedCV.wait(Lock, [this] { return !m_bUpdatePending; });
+}
+
+void FramePipeline::BeginUpdate(double CurrTime, double ElapsedTime)
+{
+    WaitForUpdate();
+
+    const auto SnapshotIdx = static_cast<Uint32>(m_FrameNumber % NumSnapshots);
+    if (m_MaxFrameLatency == 0 || m_FrameNumber == 0)
+    {
+        // There is no previous snapshot to render on the first frame, so simulate it synchronously
+        CPU_PROFILER_SCOPE("Simulate");
+        m_SimulateCallback(CurrTime, ElapsedTime, SnapshotIdx);
+        m_RenderSnapshotIdx = SnapshotIdx;
+    }
+    else
+    {
+        // The frame renders the snapshot produced by the previous simulation step
+        // while the update thread writes the other one.
+        m_RenderSnapshotIdx = static_cast<Uint32>((m_FrameNumber - 1) % NumSnapshots);
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_Request.CurrTime    = CurrTime;
+            m_Request.ElapsedTime = ElapsedTime;
+            m_Request.SnapshotIdx = SnapshotIdx;
+            m_bUpdatePending      = true;
+        }
+        m_UpdateRequestedCV.notify_one();
+    }
+    ++m_FrameNumber;
+}
+
+void FramePipeline::UpdateThreadFunc()
+{
+    CPUProfiler::SetThreadName("Update");
+    for (;;)
+    {
+        UpdateRequest Request;
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_UpdateRequestedCV.wait(Lock, [this] { return m_bUpdatePending || m_bStop; });
+            if (m_bStop)
+                return;
+            Request = m_Request;
+        }
+
+        {
+            CPU_PROFILER_SCOPE("Simulate");
+            m_SimulateCallback(Request.CurrTime, Request.ElapsedTime, Request.SnapshotIdx);
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_bUpdatePending = false;
+        }
+        m_UpdateCompletedCV.notify_all();
+    }
+}
+
+} // namespace Diligent
@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+
+#include "FrameStatistics.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+FrameStatistics::FrameStatistics(Uint32 HistorySize) :
+    m_History(std::max(HistorySize, 1u))
+{
+}
+
+void FrameStatistics::AddFrame(double FrameTime)
+{
+    VERIFY_EXPR(FrameTime >= 0);
+
+    m_History[m_NextFrameIdx] = FrameTime;
+    m_NextFrameIdx            = (m_NextFrameIdx + 1) % static_cast<Uint32>(m_History.size());
+    m_NumFrames               = std::min(m_NumFrames + 1, static_cast<Uint32>(m_History.size()));
+    m_LastFrameTime           = FrameTime;
+
+    ++m_TotalFrames;
+    if (FrameTime > m_HitchThreshold)
+        ++m_TotalHitches;
+
+    m_bStatisticsValid = false;
+}
+
+void FrameStatistics::Reset()
+{
+    m_NextFrameIdx     = 0;
+    m_NumFrames        = 0;
+    m_LastFrameTime    = 0;
+    m_TotalFrames      = 0;
+    m_TotalHitches     = 0;
+    m_bStatisticsValid = false;
+}
+
+void FrameStatistics::SetHitchThreshold(double Threshold)
+{
+    VERIFY_EXPR(Threshold > 0);
+    m_HitchThreshold   = Threshold;
+    m_bStatisticsValid = false;
+}
+
+Uint32 FrameStatistics::GetNumHitches() const
+{
+    UpdateStatistics();
+    return m_NumHitches;
+}
+
+double FrameStatistics::GetAverageFrameTime() const
+{
+    UpdateStatistics();
+    return m_AverageFrameTime;
+}
+
+double FrameStatistics::GetFPS() const
+{
+    const auto AverageFrameTime = GetAverageFrameTime();
+    return AverageFrameTime > 0 ? 1.0 / AverageFrameTime : 0.0;
+}
+
+const FrameBenchmark::Statistics& FrameStatistics::GetStatistics() const
+{
+    UpdateStatistics();
+    return m_Statistics;
+}
+
+void FrameStatistics::GetFrameTimes(std::vector<double>& FrameTimes) const
+{
+    FrameTimes.resize(m_NumFrames);
+
+    // The oldest frame is at m_NextFrameIdx once the history is full, and at 0 otherwise
+    const auto HistorySize = static_cast<Uint32>(m_History.size());
+    const auto FirstIdx    = (m_NextFrameIdx + HistorySize - m_NumFrames) % HistorySize;
+    for (Uint32 i = 0; i < m_NumFrames; ++i)
+        FrameTimes[i] = m_History[(FirstIdx + i) % HistorySize];
+}
+
+void FrameStatistics::UpdateStatistics() const
+{
+    if (m_bStatisticsValid)
+        return;
+
+    std::vector<double> FrameTimes;
+    GetFrameTimes(FrameTimes);
+
+    double Sum   = 0;
+    m_NumHitches = 0;
+    for (auto FrameTime : FrameTimes)
+    {
+        Sum += FrameTime;
+        if (FrameTime > m_HitchThreshold)
+            ++m_NumHitches;
+    }
+    m_AverageFrameTime = !FrameTimes.empty() ? Sum / static_cast<double>(FrameTimes.size()) : 0.0;
+    m_Statistics       = FrameBenchmark::ComputeStatistics(std::move(FrameTimes));
+    m_bStatisticsValid = true;
+}
+
+} // namespace Diligent
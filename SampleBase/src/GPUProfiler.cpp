@@ -0,0 +1,231 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+
+#include "GPUProfiler.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+GPUProfiler::GPUProfiler(IRenderDevice* pDevice, IDeviceContext* pContext, Uint32 NumFramesInFlight, Uint32 MaxScopesPerFrame) :
+    // clang-format off
+    m_pDevice           {pDevice},
+    m_pContext          {pContext},
+    m_MaxQueriesPerFrame{2 + 2 * MaxScopesPerFrame},
+    m_Frames            (std::max(NumFramesInFlight, 1u))
+// clang-format on
+{
+    VERIFY_EXPR(m_pDevice && m_pContext);
+}
+
+Uint32 GPUProfiler::WriteTimestamp(FrameData& Frame)
+{
+    if (Frame.NumQueries == Frame.Queries.size())
+    {
+        if (Frame.NumQueries >= m_MaxQueriesPerFrame)
+            return InvalidIndex;
+
+        // Queries are created on demand and reused by the same frame slot afterwards
+        QueryDesc queryDesc;
+        queryDesc.Name = "GPU profiler timestamp";
+        queryDesc.Type = QUERY_TYPE_TIMESTAMP;
+
+        QuerySlot Slot;
+        m_pDevice->CreateQuery(queryDesc, &Slot.pQuery);
+        if (!Slot.pQuery)
+        {
+            LOG_ERROR_MESSAGE("Failed to create GPU profiler timestamp query");
+            return InvalidIndex;
+        }
+        Frame.Queries.emplace_back(std::move(Slot));
+    }
+
+    auto& Slot    = Frame.Queries[Frame.NumQueries];
+    Slot.Resolved = false;
+    m_pContext->EndQuery(Slot.pQuery);
+    return Frame.NumQueries++;
+}
+
+bool GPUProfiler::ResolveFrame(FrameData& Frame)
+{
+    for (Uint32 q = 0; q < Frame.NumQueries; ++q)
+    {
+        auto& Slot = Frame.Queries[q];
+        if (Slot.Resolved)
+            continue;
+
+        // Query data is invalidated once it is read, so keep the values of the resolved
+        // queries in case the remaining ones are not ready yet
+        QueryDataTimestamp Data;
+        if (!Slot.pQuery->GetData(&Data, sizeof(Data)))
+            return false;
+
+        Slot.Counter   = Data.Counter;
+        Slot.Frequency = Data.Frequency;
+        Slot.Resolved  = true;
+    }
+    return true;
+}
+
+void GPUProfiler::ResolvePendingFrames()
+{
+    const auto NumFrames = static_cast<Uint64>(m_Frames.size());
+
+    // Frames are read back in submission order, and the first frame that is
+    // not ready yet stops the loop as all subsequent frames will not be ready either.
+    for (auto FrameNumber = m_FrameNumber > NumFrames ? m_FrameNumber - NumFrames : 0; FrameNumber < m_FrameNumber; ++FrameNumber)
+    {
+        auto& Frame = m_Frames[static_cast<size_t>(FrameNumber % NumFrames)];
+        if (!Frame.Pending || Frame.FrameNumber != FrameNumber)
+            continue;
+
+        if (!ResolveFrame(Frame))
+            break;
+
+        Frame.Pending = false;
+
+        const auto& FrameBegin = Frame.Queries[Frame.BeginQuery];
+        const auto& FrameEnd   = Frame.Queries[Frame.EndQuery];
+        // Frequency may be zero if the timestamps are unreliable, e.g. when the GPU clock has changed
+        if (FrameBegin.Frequency == 0)
+        {
+            ++m_NumDroppedFrames;
+            continue;
+        }
+
+        const auto ToMilliseconds = [&FrameBegin](const QuerySlot& Slot) {
+            const auto Ticks = Slot.Counter >= FrameBegin.Counter ? Slot.Counter - FrameBegin.Counter : 0;
+            return static_cast<double>(Ticks) * 1000.0 / static_cast<double>(FrameBegin.Frequency);
+        };
+
+        m_LastFrameTimings.FrameNumber = Frame.FrameNumber;
+        m_LastFrameTimings.Duration    = ToMilliseconds(FrameEnd);
+        m_LastFrameTimings.Scopes.clear();
+        for (const auto& Scope : Frame.Scopes)
+        {
+            if (Scope.BeginQuery == InvalidIndex || Scope.EndQuery == InvalidIndex)
+                continue;
+
+            ScopeTiming Timing;
+            Timing.Name  = Scope.Name;
+            Timing.Depth = Scope.Depth;
+            Timing.Start = ToMilliseconds(Frame.Queries[Scope.BeginQuery]);
+            Timing.End   = ToMilliseconds(Frame.Queries[Scope.EndQuery]);
+            m_LastFrameTimings.Scopes.emplace_back(std::move(Timing));
+        }
+    }
+}
+
+void GPUProfiler::BeginFrame()
+{
+    VERIFY(m_pCurrFrame == nullptr, "EndFrame() has not been called for the previous frame");
+
+    ResolvePendingFrames();
+
+    auto& Frame = m_Frames[static_cast<size_t>(m_FrameNumber % m_Frames.size())];
+    if (Frame.Pending)
+    {
+        // The GPU is more than NumFramesInFlight frames behind
+        ++m_NumDroppedFrames;
+        Frame.Pending = false;
+    }
+
+    Frame.FrameNumber = m_FrameNumber++;
+    Frame.NumQueries  = 0;
+    Frame.Scopes.clear();
+    Frame.EndQuery   = InvalidIndex;
+    Frame.BeginQuery = WriteTimestamp(Frame);
+
+    m_pCurrFrame = &Frame;
+    m_ScopeStack.clear();
+    m_NumOpenTimedScopes = 0;
+}
+
+void GPUProfiler::EndFrame()
+{
+    if (m_pCurrFrame == nullptr)
+        return;
+
+    if (!m_ScopeStack.empty())
+    {
+        LOG_WARNING_MESSAGE("GPU profiler: ", m_ScopeStack.size(), " scope(s) have not been closed by the end of the frame");
+        while (!m_ScopeStack.empty())
+            EndScope();
+    }
+
+    auto& Frame    = *m_pCurrFrame;
+    Frame.EndQuery = WriteTimestamp(Frame);
+    Frame.Pending  = Frame.BeginQuery != InvalidIndex && Frame.EndQuery != InvalidIndex;
+    m_pCurrFrame   = nullptr;
+}
+
+void GPUProfiler::BeginScope(const char* Name)
+{
+    if (m_pCurrFrame == nullptr)
+        return;
+
+    auto& Frame = *m_pCurrFrame;
+
+    FrameData::Scope Scope;
+    Scope.Name  = Name;
+    Scope.Depth = static_cast<Uint32>(m_ScopeStack.size());
+    // Make sure there is room left for the end timestamps of this scope, all open
+    // scopes and the frame itself. Scopes that do not fit are not timed.
+    if (Frame.NumQueries + 2 + m_NumOpenTimedScopes + 1 <= m_MaxQueriesPerFrame)
+    {
+        Scope.BeginQuery = WriteTimestamp(Frame);
+        if (Scope.BeginQuery != InvalidIndex)
+            ++m_NumOpenTimedScopes;
+    }
+
+    m_ScopeStack.push_back(static_cast<Uint32>(Frame.Scopes.size()));
+    Frame.Scopes.emplace_back(std::move(Scope));
+}
+
+void GPUProfiler::EndScope()
+{
+    if (m_pCurrFrame == nullptr)
+        return;
+
+    if (m_ScopeStack.empty())
+    {
+        UNEXPECTED("EndScope() is called without matching BeginScope()");
+        return;
+    }
+
+    auto& Scope = m_pCurrFrame->Scopes[m_ScopeStack.back()];
+    m_ScopeStack.pop_back();
+    if (Scope.BeginQuery != InvalidIndex)
+    {
+        Scope.EndQuery = WriteTimestamp(*m_pCurrFrame);
+        --m_NumOpenTimedScopes;
+    }
+}
+
+} // namespace Diligent
@@ -0,0 +1,131 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "HeadlessSwapChain.hpp"
+#include "RefCountedObjectImpl.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+HeadlessSwapChain::HeadlessSwapChain(IReferenceCounters*  pRefCounters,
+                                     IRenderDevice*       pDevice,
+                                     IDeviceContext*      pContext,
+                                     const SwapChainDesc& SCDesc) :
+    // clang-format off
+    TBase          {pRefCounters},
+    m_SwapChainDesc{SCDesc},
+    m_pDevice      {pDevice},
+    m_pContext     {pContext}
+// clang-format on
+{
+    if (m_SwapChainDesc.Width == 0 || m_SwapChainDesc.Height == 0)
+        LOG_ERROR_AND_THROW("Headless swap chain size must not be zero");
+
+    CreateBuffers();
+}
+
+void HeadlessSwapChain::Create(IRenderDevice*       pDevice,
+                               IDeviceContext*      pContext,
+                               const SwapChainDesc& SCDesc,
+                               ISwapChain**         ppSwapChain)
+{
+    auto* pSwapChain = MakeNewRCObj<HeadlessSwapChain>()(pDevice, pContext, SCDesc);
+    pSwapChain->QueryInterface(IID_SwapChain, reinterpret_cast<IObject**>(ppSwapChain));
+}
+
+void HeadlessSwapChain::CreateBuffers()
+{
+    m_pRTV.Release();
+    m_pDSV.Release();
+
+    TextureDesc ColorDesc;
+    ColorDesc.Name      = "Headless swap chain color buffer";
+    ColorDesc.Type      = RESOURCE_DIM_TEX_2D;
+    ColorDesc.Width     = m_SwapChainDesc.Width;
+    ColorDesc.Height    = m_SwapChainDesc.Height;
+    ColorDesc.Format    = m_SwapChainDesc.ColorBufferFormat;
+    ColorDesc.MipLevels = 1;
+    ColorDesc.Usage     = USAGE_DEFAULT;
+    ColorDesc.BindFlags = BIND_RENDER_TARGET | BIND_SHADER_RESOURCE;
+
+    ColorDesc.ClearValue.Format = ColorDesc.Format;
+    for (int i = 0; i < 4; ++i)
+        ColorDesc.ClearValue.Color[i] = 0;
+
+    RefCntAutoPtr<ITexture> pColorBuffer;
+    m_pDevice->CreateTexture(ColorDesc, nullptr, &pColorBuffer);
+    if (!pColorBuffer)
+        LOG_ERROR_AND_THROW("Failed to create headless swap chain color buffer");
+    m_pRTV = pColorBuffer->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+    if (m_SwapChainDesc.DepthBufferFormat != TEX_FORMAT_UNKNOWN)
+    {
+        TextureDesc DepthDesc = ColorDesc;
+        DepthDesc.Name        = "Headless swap chain depth buffer";
+        DepthDesc.Format      = m_SwapChainDesc.DepthBufferFormat;
+        DepthDesc.BindFlags   = BIND_DEPTH_STENCIL;
+
+        DepthDesc.ClearValue.Format               = DepthDesc.Format;
+        DepthDesc.ClearValue.DepthStencil.Depth   = m_SwapChainDesc.DefaultDepthValue;
+        DepthDesc.ClearValue.DepthStencil.Stencil = m_SwapChainDesc.DefaultStencilValue;
+
+        RefCntAutoPtr<ITexture> pDepthBuffer;
+        m_pDevice->CreateTexture(DepthDesc, nullptr, &pDepthBuffer);
+        if (!pDepthBuffer)
+            LOG_ERROR_AND_THROW("Failed to create headless swap chain depth buffer");
+        m_pDSV = pDepthBuffer->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
+    }
+}
+
+void HeadlessSwapChain::Present(Uint32 /*SyncInterval*/)
+{
+    // There is nothing to present, but we still need to submit the commands and
+    // release dynamic resources the same way regular swap chains do.
+    m_pContext->Flush();
+    m_pContext->FinishFrame();
+    m_pDevice->ReleaseStaleResources();
+}
+
+void HeadlessSwapChain::Resize(Uint32 NewWidth, Uint32 NewHeight)
+{
+    if (NewWidth == 0 || NewHeight == 0)
+        return;
+
+    if (NewWidth == m_SwapChainDesc.Width && NewHeight == m_SwapChainDesc.Height)
+        return;
+
+    // Make sure the buffers are not used by the GPU anymore
+    m_pContext->Flush();
+    m_pContext->WaitForIdle();
+
+    m_SwapChainDesc.Width  = NewWidth;
+    m_SwapChainDesc.Height = NewHeight;
+    CreateBuffers();
+}
+
+} // namespace Diligent
@@ -0,0 +1,383 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "ImageDiff.hpp"
+#include "Errors.hpp"
+
+#if defined(__AVX2__)
+#    define IMAGE_DIFF_USE_AVX2 1
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define IMAGE_DIFF_USE_SSE2 1
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define IMAGE_DIFF_USE_NEON 1
+#    include <arm_neon.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct RowDiffStats
+{
+    Uint64 NumMismatchedPixels = 0;
+    Uint32 MaxError            = 0;
+    Uint64 SumError            = 0;
+    Uint64 SumSqError          = 0;
+
+    void Merge(const RowDiffStats& Other)
+    {
+        NumMismatchedPixels += Other.NumMismatchedPixels;
+        MaxError = std::max(MaxError, Other.MaxError);
+        SumError += Other.SumError;
+        SumSqError += Other.SumSqError;
+    }
+};
+
+// Converts a row of RGB or RGBA pixels into 4-component pixels with red and blue channels
+// in the order of the first image. Alpha is not compared, so it is left undefined.
+void ExpandRow(const Uint8* pSrc, Uint32 NumComponents, bool SwapRB, Uint8* pDst, Uint32 Width)
+{
+    const int R = SwapRB ? 2 : 0;
+    const int B = SwapRB ? 0 : 2;
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        const Uint8* pSrcPixel = pSrc + x * NumComponents;
+        Uint8*       pDstPixel = pDst + x * 4;
+        pDstPixel[R]           = pSrcPixel[0];
+        pDstPixel[1]           = pSrcPixel[1];
+        pDstPixel[B]           = pSrcPixel[2];
+        pDstPixel[3]           = 0;
+    }
+}
+
+inline Uint32 CountOneBits(Uint32 Bits)
+{
+    Uint32 Count = 0;
+    for (; Bits != 0; Bits &= Bits - 1)
+        ++Count;
+    return Count;
+}
+
+inline Uint32 PixelError(const Uint8* pPixel0, const Uint8* pPixel1, int c)
+{
+    return static_cast<Uint32>(std::abs(int{pPixel0[c]} - int{pPixel1[c]}));
+}
+
+// Compares a row of 4-component pixels ignoring the alpha channel
+RowDiffStats CompareRow(const Uint8* pRow0, const Uint8* pRow1, Uint32 Width, Uint32 Tolerance)
+{
+    RowDiffStats Stats;
+
+    Uint32 x = 0;
+#if IMAGE_DIFF_USE_AVX2
+    {
+        const __m256i Zero    = _mm256_setzero_si256();
+        const __m256i RGBMask = _mm256_set1_epi32(0x00FFFFFF);
+        const __m256i Tol     = _mm256_set1_epi8(static_cast<char>(std::min(Tolerance, 255u)));
+
+        __m256i MaxErr   = Zero;
+        __m256i SumErr   = Zero;
+        __m256i SumSq32  = Zero;
+        __m256i SumSq64  = Zero;
+        Uint32  NumIters = 0;
+
+        auto FlushSumSq = [&]() {
+            SumSq64 = _mm256_add_epi64(SumSq64, _mm256_unpacklo_epi32(SumSq32, Zero));
+            SumSq64 = _mm256_add_epi64(SumSq64, _mm256_unpackhi_epi32(SumSq32, Zero));
+            SumSq32 = Zero;
+        };
+
+        for (; x + 8 <= Width; x += 8)
+        {
+            __m256i A = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRow0 + x * 4));
+            __m256i B = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRow1 + x * 4));
+            __m256i D = _mm256_and_si256(_mm256_or_si256(_mm256_subs_epu8(A, B), _mm256_subs_epu8(B, A)), RGBMask);
+
+            MaxErr = _mm256_max_epu8(MaxErr, D);
+            SumErr = _mm256_add_epi64(SumErr, _mm256_sad_epu8(D, Zero));
+
+            __m256i Lo = _mm256_unpacklo_epi8(D, Zero);
+            __m256i Hi = _mm256_unpackhi_epi8(D, Zero);
+            SumSq32    = _mm256_add_epi32(SumSq32, _mm256_add_epi32(_mm256_madd_epi16(Lo, Lo), _mm256_madd_epi16(Hi, Hi)));
+            // Every 32-bit lane grows by at most 4 * 255^2 per iteration
+            if (++NumIters == 4096)
+            {
+                FlushSumSq();
+                NumIters = 0;
+            }
+
+            // Pixels where all channels are within the tolerance produce zero lanes
+            __m256i Exceed    = _mm256_cmpeq_epi32(_mm256_subs_epu8(D, Tol), Zero);
+            auto    WithinTol = static_cast<Uint32>(_mm256_movemask_ps(_mm256_castsi256_ps(Exceed)));
+            Stats.NumMismatchedPixels += 8 - CountOneBits(WithinTol);
+        }
+        FlushSumSq();
+
+        alignas(32) Uint8  MaxErrBytes[32];
+        alignas(32) Uint64 Sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(MaxErrBytes), MaxErr);
+        for (auto Err : MaxErrBytes)
+            Stats.MaxError = std::max(Stats.MaxError, Uint32{Err});
+        _mm256_store_si256(reinterpret_cast<__m256i*>(Sums), SumErr);
+        Stats.SumError += Sums[0] + Sums[1] + Sums[2] + Sums[3];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(Sums), SumSq64);
+        Stats.SumSqError += Sums[0] + Sums[1] + Sums[2] + Sums[3];
+    }
+#elif IMAGE_DIFF_USE_SSE2
+    {
+        const __m128i Zero    = _mm_setzero_si128();
+        const __m128i RGBMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i Tol     = _mm_set1_epi8(static_cast<char>(std::min(Tolerance, 255u)));
+
+        __m128i MaxErr   = Zero;
+        __m128i SumErr   = Zero;
+        __m128i SumSq32  = Zero;
+        __m128i SumSq64  = Zero;
+        Uint32  NumIters = 0;
+
+        auto FlushSumSq = [&]() {
+            SumSq64 = _mm_add_epi64(SumSq64, _mm_unpacklo_epi32(SumSq32, Zero));
+            SumSq64 = _mm_add_epi64(SumSq64, _mm_unpackhi_epi32(SumSq32, Zero));
+            SumSq32 = Zero;
+        };
+
+        for (; x + 4 <= Width; x += 4)
+        {
+            __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + x * 4));
+            __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + x * 4));
+            __m128i D = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(A, B), _mm_subs_epu8(B, A)), RGBMask);
+
+            MaxErr = _mm_max_epu8(MaxErr, D);
+            SumErr = _mm_add_epi64(SumErr, _mm_sad_epu8(D, Zero));
+
+            __m128i Lo = _mm_unpacklo_epi8(D, Zero);
+            __m128i Hi = _mm_unpackhi_epi8(D, Zero);
+            SumSq32    = _mm_add_epi32(SumSq32, _mm_add_epi32(_mm_madd_epi16(Lo, Lo), _mm_madd_epi16(Hi, Hi)));
+            // Every 32-bit lane grows by at most 4 * 255^2 per iteration
+            if (++NumIters == 4096)
+            {
+                FlushSumSq();
+                NumIters = 0;
+            }
+
+            // Pixels where all channels are within the tolerance produce zero lanes
+            __m128i Exceed    = _mm_cmpeq_epi32(_mm_subs_epu8(D, Tol), Zero);
+            auto    WithinTol = static_cast<Uint32>(_mm_movemask_ps(_mm_castsi128_ps(Exceed)));
+            Stats.NumMismatchedPixels += 4 - CountOneBits(WithinTol);
+        }
+        FlushSumSq();
+
+        alignas(16) Uint8  MaxErrBytes[16];
+        alignas(16) Uint64 Sums[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(MaxErrBytes), MaxErr);
+        for (auto Err : MaxErrBytes)
+            Stats.MaxError = std::max(Stats.MaxError, Uint32{Err});
+        _mm_store_si128(reinterpret_cast<__m128i*>(Sums), SumErr);
+        Stats.SumError += Sums[0] + Sums[1];
+        _mm_store_si128(reinterpret_cast<__m128i*>(Sums), SumSq64);
+        Stats.SumSqError += Sums[0] + Sums[1];
+    }
+#elif IMAGE_DIFF_USE_NEON
+    {
+        const uint8x16_t RGBMask = vreinterpretq_u8_u32(vdupq_n_u32(0x00FFFFFF));
+        const uint8x16_t Tol     = vdupq_n_u8(static_cast<Uint8>(std::min(Tolerance, 255u)));
+
+        uint8x16_t MaxErr     = vdupq_n_u8(0);
+        uint32x4_t SumErr     = vdupq_n_u32(0);
+        uint64x2_t SumSq      = vdupq_n_u64(0);
+        uint32x4_t Mismatched = vdupq_n_u32(0);
+
+        for (; x + 4 <= Width; x += 4)
+        {
+            uint8x16_t A = vld1q_u8(pRow0 + x * 4);
+            uint8x16_t B = vld1q_u8(pRow1 + x * 4);
+            uint8x16_t D = vandq_u8(vabdq_u8(A, B), RGBMask);
+
+            MaxErr = vmaxq_u8(MaxErr, D);
+            // Row sums of absolute errors fit into 32 bits for any reasonable image width
+            SumErr = vpadalq_u16(SumErr, vpaddlq_u8(D));
+
+            uint16x8_t SqLo = vmull_u8(vget_low_u8(D), vget_low_u8(D));
+            uint16x8_t SqHi = vmull_u8(vget_high_u8(D), vget_high_u8(D));
+            SumSq           = vpadalq_u32(SumSq, vaddq_u32(vpaddlq_u16(SqLo), vpaddlq_u16(SqHi)));
+
+            // Lanes of pixels that have at least one channel above the tolerance are non-zero
+            uint32x4_t Exceed = vtstq_u32(vreinterpretq_u32_u8(vcgtq_u8(D, Tol)), vdupq_n_u32(0xFFFFFFFF));
+            Mismatched        = vsubq_u32(Mismatched, Exceed);
+        }
+
+        alignas(16) Uint8  MaxErrBytes[16];
+        alignas(16) Uint32 Sums32[4];
+        alignas(16) Uint64 Sums64[2];
+        vst1q_u8(MaxErrBytes, MaxErr);
+        for (auto Err : MaxErrBytes)
+            Stats.MaxError = std::max(Stats.MaxError, Uint32{Err});
+        vst1q_u32(Sums32, SumErr);
+        Stats.SumError += Uint64{Sums32[0]} + Sums32[1] + Sums32[2] + Sums32[3];
+        vst1q_u32(Sums32, Mismatched);
+        Stats.NumMismatchedPixels += Uint64{Sums32[0]} + Sums32[1] + Sums32[2] + Sums32[3];
+        vst1q_u64(Sums64, SumSq);
+        Stats.SumSqError += Sums64[0] + Sums64[1];
+    }
+#endif
+
+    for (; x < Width; ++x)
+    {
+        const Uint8* pPixel0 = pRow0 + x * 4;
+        const Uint8* pPixel1 = pRow1 + x * 4;
+
+        bool IsMismatched = false;
+        for (int c = 0; c < 3; ++c)
+        {
+            const auto Err = PixelError(pPixel0, pPixel1, c);
+            Stats.MaxError = std::max(Stats.MaxError, Err);
+            Stats.SumError += Err;
+            Stats.SumSqError += Err * Err;
+            IsMismatched = IsMismatched || Err > Tolerance;
+        }
+        if (IsMismatched)
+            ++Stats.NumMismatchedPixels;
+    }
+
+    return Stats;
+}
+
+// Writes the maximum per-pixel channel error as a black-red-yellow-white heat map.
+// Errors are scaled by 4 to make small differences visible.
+void WriteHeatMapRow(const Uint8* pRow0, const Uint8* pRow1, Uint32 Width, Uint8* pDst)
+{
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        const Uint8* pPixel0 = pRow0 + x * 4;
+        const Uint8* pPixel1 = pRow1 + x * 4;
+
+        const auto Err  = std::max({PixelError(pPixel0, pPixel1, 0), PixelError(pPixel0, pPixel1, 1), PixelError(pPixel0, pPixel1, 2)});
+        const auto Heat = std::min(Err * 4, 765u);
+
+        pDst[x * 4 + 0] = static_cast<Uint8>(std::min(Heat, 255u));
+        pDst[x * 4 + 1] = static_cast<Uint8>(std::min(std::max(Heat, 255u) - 255u, 255u));
+        pDst[x * 4 + 2] = static_cast<Uint8>(std::max(Heat, 510u) - 510u);
+        pDst[x * 4 + 3] = 255;
+    }
+}
+
+} // namespace
+
+bool ComputeImageDiff(const ImageDiffAttribs& Attribs, ImageDiffStats& Stats)
+{
+    Stats = ImageDiffStats{};
+
+    bool SwapRB = false;
+    switch (Attribs.Format0)
+    {
+        case TEX_FORMAT_RGBA8_UNORM:
+        case TEX_FORMAT_RGBA8_UNORM_SRGB:
+            SwapRB = false;
+            break;
+
+        case TEX_FORMAT_BGRA8_UNORM:
+        case TEX_FORMAT_BGRA8_UNORM_SRGB:
+            SwapRB = true;
+            break;
+
+        default:
+            return false;
+    }
+
+    VERIFY_EXPR(Attribs.NumComponents1 == 3 || Attribs.NumComponents1 == 4);
+
+    const auto Width  = Attribs.Width;
+    const auto Height = Attribs.Height;
+    if (Width == 0 || Height == 0)
+        return true;
+
+    if (Attribs.pHeatMap != nullptr)
+        Attribs.pHeatMap->resize(size_t{Width} * size_t{Height} * 4);
+
+    // Avoid spawning threads for just a few rows
+    static constexpr Uint32 MinRowsPerThread = 32;
+
+    Uint32 NumThreads = Attribs.NumThreads != 0 ? Attribs.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    NumThreads        = std::max(std::min(NumThreads, Height / MinRowsPerThread), 1u);
+
+    std::vector<RowDiffStats> ThreadStats(NumThreads);
+
+    auto CompareRows = [&](Uint32 ThreadId) {
+        const Uint32 StartRow = Height * ThreadId / NumThreads;
+        const Uint32 EndRow   = Height * (ThreadId + 1) / NumThreads;
+
+        // Rows of the second image are converted to the layout of the first one
+        std::vector<Uint8> ExpandedRow(size_t{Width} * 4);
+
+        auto& RowStats = ThreadStats[ThreadId];
+        for (Uint32 row = StartRow; row < EndRow; ++row)
+        {
+            const auto* pRow0 = static_cast<const Uint8*>(Attribs.pData0) + size_t{row} * Attribs.Stride0;
+            const auto* pRow1 = static_cast<const Uint8*>(Attribs.pData1) + size_t{row} * Attribs.Stride1;
+            ExpandRow(pRow1, Attribs.NumComponents1, SwapRB, ExpandedRow.data(), Width);
+
+            RowStats.Merge(CompareRow(pRow0, ExpandedRow.data(), Width, Attribs.Tolerance));
+            if (Attribs.pHeatMap != nullptr)
+                WriteHeatMapRow(pRow0, ExpandedRow.data(), Width, Attribs.pHeatMap->data() + size_t{row} * Width * 4);
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(NumThreads - 1);
+    for (Uint32 t = 1; t < NumThreads; ++t)
+        Threads.emplace_back(CompareRows, t);
+    // The calling thread processes the first range
+    CompareRows(0);
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    RowDiffStats Total;
+    for (const auto& RowStats : ThreadStats)
+        Total.Merge(RowStats);
+
+    const double NumSamples = static_cast<double>(Width) * static_cast<double>(Height) * 3.0;
+    const double MSE        = static_cast<double>(Total.SumSqError) / NumSamples;
+
+    Stats.NumMismatchedPixels = static_cast<Uint32>(Total.NumMismatchedPixels);
+    Stats.MaxError            = Total.MaxError;
+    Stats.MeanError           = static_cast<double>(Total.SumError) / NumSamples;
+    Stats.PSNR                = MSE > 0 ? 10.0 * std::log10(255.0 * 255.0 / MSE) : std::numeric_limits<double>::infinity();
+
+    return true;
+}
+
+} // namespace Diligent
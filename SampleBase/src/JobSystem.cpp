@@ -0,0 +1,372 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "JobSystem.hpp"
+#include "CPUProfiler.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+Uint32 TaskGraph::AddTask(TaskFunction Func)
+{
+    VERIFY_EXPR(Func);
+    m_Tasks.emplace_back();
+    m_Tasks.back().Func = std::move(Func);
+    return static_cast<Uint32>(m_Tasks.size() - 1);
+}
+
+void TaskGraph::AddDependency(Uint32 Task, Uint32 Prerequisite)
+{
+    VERIFY(Task < m_Tasks.size() && Prerequisite < m_Tasks.size(), "Task index is out of range");
+    VERIFY(Task != Prerequisite, "Task can't depend on itself");
+    m_Tasks[Prerequisite].Successors.push_back(Task);
+    ++m_Tasks[Task].NumPrerequisites;
+}
+
+
+namespace
+{
+
+class IdleTimer
+{
+public:
+    explicit IdleTimer(std::atomic<Uint64>& IdleTime) :
+        m_IdleTime{IdleTime},
+        m_Start{std::chrono::steady_clock::now()}
+    {}
+
+    ~IdleTimer()
+    {
+        const auto Duration = std::chrono::steady_clock::now() - m_Start;
+        m_IdleTime.fetch_add(static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Duration).count()), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<Uint64>&                        m_IdleTime;
+    const std::chrono::steady_clock::time_point m_Start;
+};
+
+} // namespace
+
+JobSystem::JobSystem(Uint32 NumWorkerThreads) :
+    m_Queues{new TaskQueue[NumWorkerThreads + 1]},
+    m_IdleTime{new std::atomic<Uint64>[NumWorkerThreads + 1]}
+{
+    for (Uint32 t = 0; t <= NumWorkerThreads; ++t)
+        m_IdleTime[t].store(0);
+
+    m_WorkerThreads.reserve(NumWorkerThreads);
+    for (Uint32 t = 0; t < NumWorkerThreads; ++t)
+        m_WorkerThreads.emplace_back(&JobSystem::WorkerThreadFunc, this, 1 + t);
+}
+
+JobSystem::~JobSystem()
+{
+    // Tasks must not be abandoned as they may reference data owned by the caller
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_bStop = true;
+    }
+    m_WakeUpCV.notify_all();
+
+    for (auto& Thread : m_WorkerThreads)
+        Thread.join();
+}
+
+void JobSystem::Run(const TaskGraph& Graph)
+{
+    VERIFY(m_pGraph == nullptr, "Run() and ParallelFor() must not be called concurrently or from within a task");
+
+    if (Graph.GetNumTasks() == 0)
+        return;
+
+    StartGraph(Graph);
+    WaitForGraph();
+}
+
+void JobSystem::StartGraph(const TaskGraph& Graph)
+{
+    const auto NumTasks = Graph.GetNumTasks();
+
+#ifdef _DEBUG
+    {
+        // Check that the graph is acyclic, otherwise Run() would never return
+        std::vector<Uint32> NumPrerequisites(NumTasks);
+        std::vector<Uint32> ReadyTasks;
+        for (Uint32 i = 0; i < NumTasks; ++i)
+        {
+            NumPrerequisites[i] = Graph.m_Tasks[i].NumPrerequisites;
+            if (NumPrerequisites[i] == 0)
+                ReadyTasks.push_back(i);
+        }
+        Uint32 NumVisited = 0;
+        while (!ReadyTasks.empty())
+        {
+            auto Task = ReadyTasks.back();
+            ReadyTasks.pop_back();
+            ++NumVisited;
+            for (auto Successor : Graph.m_Tasks[Task].Successors)
+            {
+                if (--NumPrerequisites[Successor] == 0)
+                    ReadyTasks.push_back(Successor);
+            }
+        }
+        if (NumVisited != NumTasks)
+        {
+            UNEXPECTED("Task graph contains a cycle");
+            return;
+        }
+    }
+#endif
+
+    if (NumTasks > m_MaxTasks)
+    {
+        m_NumPendingPrerequisites.reset(new std::atomic<Uint32>[NumTasks]);
+        m_MaxTasks = NumTasks;
+    }
+    for (Uint32 i = 0; i < NumTasks; ++i)
+        m_NumPendingPrerequisites[i].store(Graph.m_Tasks[i].NumPrerequisites, std::memory_order_relaxed);
+
+    m_pGraph = &Graph;
+    m_NumRemainingTasks.store(NumTasks);
+
+    // Distribute the tasks that are ready to run between all queues so that
+    // every thread can start without having to steal
+    const auto NumThreads = GetNumThreads();
+    Uint32     QueueIdx   = 0;
+    for (Uint32 i = 0; i < NumTasks; ++i)
+    {
+        if (Graph.m_Tasks[i].NumPrerequisites != 0)
+            continue;
+
+        auto& Queue = m_Queues[QueueIdx];
+        {
+            std::lock_guard<std::mutex> Lock{Queue.Mtx};
+            Queue.Tasks.push_back(i);
+            m_NumQueuedTasks.fetch_add(1);
+        }
+        QueueIdx = (QueueIdx + 1) % NumThreads;
+    }
+    {
+        // Lock the mutex to make sure that no worker thread misses the notification
+        // between checking the wake-up condition and starting to wait.
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+    }
+    m_WakeUpCV.notify_all();
+}
+
+void JobSystem::WaitForGraph()
+{
+    // The calling thread executes tasks along with the worker threads
+    for (;;)
+    {
+        Uint32 TaskIdx = 0;
+        if (PopTask(0, TaskIdx))
+        {
+            ExecuteTask(0, TaskIdx);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        {
+            IdleTimer Timer{m_IdleTime[0]};
+            m_WakeUpCV.wait(Lock, [this] { return m_NumRemainingTasks.load() == 0 || m_NumQueuedTasks.load() > 0; });
+        }
+        if (m_NumRemainingTasks.load() == 0)
+            break;
+    }
+
+    m_pGraph = nullptr;
+}
+
+void JobSystem::ParallelFor(Uint32 NumItems, Uint32 ChunkSize, const ParallelForFunction& Func)
+{
+    if (NumItems == 0)
+        return;
+
+    ChunkSize            = std::max(ChunkSize, 1u);
+    const auto NumChunks = (NumItems + ChunkSize - 1) / ChunkSize;
+    if (NumChunks == 1 || m_WorkerThreads.empty())
+    {
+        for (Uint32 First = 0; First < NumItems; First += ChunkSize)
+            Func(First, std::min(First + ChunkSize, NumItems), 0);
+        return;
+    }
+
+    m_ParallelForGraph.Clear();
+    for (Uint32 First = 0; First < NumItems; First += ChunkSize)
+    {
+        const auto Last = std::min(First + ChunkSize, NumItems);
+        m_ParallelForGraph.AddTask([&Func, First, Last](Uint32 ThreadIdx) { Func(First, Last, ThreadIdx); });
+    }
+    Run(m_ParallelForGraph);
+}
+
+void JobSystem::ParallelForAsync(Uint32 NumItems, Uint32 ChunkSize, ParallelForFunction Func)
+{
+    VERIFY(m_pGraph == nullptr, "Previous asynchronous work must be waited for before starting new work");
+
+    if (NumItems == 0)
+        return;
+
+    if (m_WorkerThreads.empty())
+    {
+        ParallelFor(NumItems, ChunkSize, Func);
+        return;
+    }
+
+    // The function must outlive the call as the chunks are processed after it returns
+    m_AsyncFunc = std::move(Func);
+
+    ChunkSize = std::max(ChunkSize, 1u);
+    m_ParallelForGraph.Clear();
+    for (Uint32 First = 0; First < NumItems; First += ChunkSize)
+    {
+        const auto Last = std::min(First + ChunkSize, NumItems);
+        m_ParallelForGraph.AddTask([this, First, Last](Uint32 ThreadIdx) { m_AsyncFunc(First, Last, ThreadIdx); });
+    }
+    StartGraph(m_ParallelForGraph);
+}
+
+void JobSystem::Wait()
+{
+    if (m_pGraph == nullptr)
+        return;
+
+    WaitForGraph();
+    m_AsyncFunc = nullptr;
+}
+
+double JobSystem::GetIdleTime(Uint32 ThreadIdx) const
+{
+    VERIFY_EXPR(ThreadIdx < GetNumThreads());
+    return static_cast<double>(m_IdleTime[ThreadIdx].load(std::memory_order_relaxed)) * 1e-9;
+}
+
+bool JobSystem::PopTask(Uint32 ThreadIdx, Uint32& TaskIdx)
+{
+    if (m_NumQueuedTasks.load() == 0)
+        return false;
+
+    // Take the most recently added task from the own queue first as its data is likely still in the cache
+    {
+        auto& Queue = m_Queues[ThreadIdx];
+
+        std::lock_guard<std::mutex> Lock{Queue.Mtx};
+        if (!Queue.Tasks.empty())
+        {
+            TaskIdx = Queue.Tasks.back();
+            Queue.Tasks.pop_back();
+            m_NumQueuedTasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest task from other threads
+    const auto NumThreads = GetNumThreads();
+    for (Uint32 i = 1; i < NumThreads; ++i)
+    {
+        auto& Queue = m_Queues[(ThreadIdx + i) % NumThreads];
+
+        std::lock_guard<std::mutex> Lock{Queue.Mtx};
+        if (!Queue.Tasks.empty())
+        {
+            TaskIdx = Queue.Tasks.front();
+            Queue.Tasks.pop_front();
+            m_NumQueuedTasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::PushTask(Uint32 ThreadIdx, Uint32 TaskIdx)
+{
+    {
+        auto& Queue = m_Queues[ThreadIdx];
+
+        std::lock_guard<std::mutex> Lock{Queue.Mtx};
+        Queue.Tasks.push_back(TaskIdx);
+        m_NumQueuedTasks.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+    }
+    m_WakeUpCV.notify_one();
+}
+
+void JobSystem::ExecuteTask(Uint32 ThreadIdx, Uint32 TaskIdx)
+{
+    const auto& Task = m_pGraph->m_Tasks[TaskIdx];
+    Task.Func(ThreadIdx);
+
+    for (auto Successor : Task.Successors)
+    {
+        if (m_NumPendingPrerequisites[Successor].fetch_sub(1) == 1)
+            PushTask(ThreadIdx, Successor);
+    }
+
+    // The graph must not be accessed after the last task is complete as Run() may return at any moment
+    if (m_NumRemainingTasks.fetch_sub(1) == 1)
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+        }
+        m_WakeUpCV.notify_all();
+    }
+}
+
+void JobSystem::WorkerThreadFunc(Uint32 ThreadIdx)
+{
+    CPUProfiler::SetThreadName(("Worker " + std::to_string(ThreadIdx)).c_str());
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            {
+                IdleTimer Timer{m_IdleTime[ThreadIdx]};
+                m_WakeUpCV.wait(Lock, [this] { return m_bStop || m_NumQueuedTasks.load() > 0; });
+            }
+            if (m_bStop)
+                return;
+        }
+
+        Uint32 TaskIdx = 0;
+        while (PopTask(ThreadIdx, TaskIdx))
+            ExecuteTask(ThreadIdx, TaskIdx);
+    }
+}
+
+} // namespace Diligent
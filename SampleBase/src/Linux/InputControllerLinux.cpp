@@ -14,6 +14,8 @@
  *  all other commercial damages or losses), even if such Contributor has been advised 
  *  of the possibility of such damages.
  */
+#include <cstdlib>
+
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 
@@ -165,6 +167,14 @@ int InputControllerLinux::HandleKeyEvevnt(unsigned int keysym, bool IsKeyPressed
 }
 
 int InputControllerLinux::HandleXEvent(void* xevent)
+{
+    auto handled = ProcessXEvent(xevent);
+    if (handled)
+        OnInputEvent();
+    return handled;
+}
+
+int InputControllerLinux::ProcessXEvent(void* xevent)
 {
     auto* event = reinterpret_cast<XEvent*>(xevent);
     switch (event->type)
@@ -257,6 +267,14 @@ InputControllerLinux::~InputControllerLinux()
 }
 
 int InputControllerLinux::HandleXCBEvent(void* xcb_event)
+{
+    auto handled = ProcessXCBEvent(xcb_event);
+    if (handled)
+        OnInputEvent();
+    return handled;
+}
+
+int InputControllerLinux::ProcessXCBEvent(void* xcb_event)
 {
     auto* event = reinterpret_cast<xcb_generic_event_t*>(xcb_event);
 
@@ -340,4 +358,53 @@ int InputControllerLinux::HandleXCBEvent(void* xcb_event)
     return 0;
 }
 
+void InputControllerLinux::SetPointerWindow(void* display, void* connection, Uint32 window)
+{
+    VERIFY((display != nullptr) != (connection != nullptr), "Either X11 display or XCB connection must be specified");
+    m_Display       = display;
+    m_XCBConnection = connection;
+    m_Window        = window;
+}
+
+void InputControllerLinux::PollMousePosition()
+{
+    float PosX = 0, PosY = 0;
+    if (m_Display != nullptr)
+    {
+        ::Window     root, child;
+        int          root_x, root_y, win_x, win_y;
+        unsigned int mask;
+        if (XQueryPointer(reinterpret_cast<Display*>(m_Display), static_cast<::Window>(m_Window), &root, &child, &root_x, &root_y, &win_x, &win_y, &mask) == 0)
+            return; // The pointer is on another screen
+
+        PosX = static_cast<float>(win_x);
+        PosY = static_cast<float>(win_y);
+    }
+    else if (m_XCBConnection != nullptr)
+    {
+        auto* connection = reinterpret_cast<xcb_connection_t*>(m_XCBConnection);
+        auto* reply      = xcb_query_pointer_reply(connection, xcb_query_pointer(connection, m_Window), nullptr);
+        if (reply == nullptr)
+            return;
+
+        const bool SameScreen = reply->same_screen != 0;
+        PosX                  = static_cast<float>(reply->win_x);
+        PosY                  = static_cast<float>(reply->win_y);
+        free(reply);
+        if (!SameScreen)
+            return;
+    }
+    else
+    {
+        return;
+    }
+
+    if (PosX != m_MouseState.PosX || PosY != m_MouseState.PosY)
+    {
+        m_MouseState.PosX = PosX;
+        m_MouseState.PosY = PosY;
+        OnInputEvent();
+    }
+}
+
 } // namespace Diligent
@@ -46,6 +46,7 @@ public:
         InitializeDiligentEngine(display, reinterpret_cast<void*>(static_cast<size_t>(window)));
         const auto& SCDesc = m_pSwapChain->GetDesc();
         m_pImGui.reset(new ImGuiImplLinuxX11(m_pDevice, SCDesc.ColorBufferFormat, SCDesc.DepthBufferFormat, SCDesc.Width, SCDesc.Height));
+        m_TheSample->GetInputController().SetPointerWindow(display, nullptr, static_cast<Uint32>(window));
         InitializeSample();
     }
 
@@ -60,6 +61,11 @@ public:
         return handled;
     }
 
+    virtual void PollInput() override final
+    {
+        m_TheSample->GetInputController().PollMousePosition();
+    }
+
 #if VULKAN_SUPPORTED
     virtual bool InitVulkan(xcb_connection_t* connection, uint32_t window) override final
     {
@@ -75,6 +81,7 @@ public:
             const auto& SCDesc = m_pSwapChain->GetDesc();
             m_pImGui.reset(new ImGuiImplLinuxXCB(connection, m_pDevice, SCDesc.ColorBufferFormat, SCDesc.DepthBufferFormat, SCDesc.Width, SCDesc.Height));
             m_TheSample->GetInputController().InitXCBKeysms(connection);
+            m_TheSample->GetInputController().SetPointerWindow(nullptr, connection, window);
             InitializeSample();
             return true;
         }
@@ -0,0 +1,213 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "ProfilerOverlay.hpp"
+#include "imgui.h"
+
+namespace Diligent
+{
+
+namespace
+{
+
+ImU32 GetScopeColor(const char* Name)
+{
+    // Hash the name rather than the pointer so that the same scope gets
+    // the same color in every frame and every module
+    Uint32 Hash = 2166136261u;
+    for (const char* c = Name; c != nullptr && *c != '\0'; ++c)
+        Hash = (Hash ^ static_cast<Uint8>(*c)) * 16777619u;
+
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(static_cast<float>(Hash % 360) / 360.f, 0.5f, 0.85f, r, g, b);
+    return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1.f));
+}
+
+} // namespace
+
+void ProfilerOverlay::NewFrame()
+{
+    const auto CurrTime = CPUProfiler::GetTime();
+    if (!m_bPaused && m_CurrFrameStart > 0)
+    {
+        m_LastFrameStart = m_CurrFrameStart;
+        m_LastFrameEnd   = CurrTime;
+        CPUProfiler::GetEvents(m_LastFrameStart, m_LastFrameEnd, m_Threads);
+        if (m_pGPUProfiler != nullptr)
+            m_GPUFrame = m_pGPUProfiler->GetLastFrameTimings();
+    }
+    m_CurrFrameStart = CurrTime;
+}
+
+void ProfilerOverlay::Draw(bool* pOpen)
+{
+    ImGui::SetNextWindowPos(ImVec2(10, 320), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(640, 0), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Profiler", pOpen))
+    {
+        ImGui::Checkbox("Pause", &m_bPaused);
+        ImGui::SameLine();
+        if (ImGui::Button("Save trace"))
+            CPUProfiler::WriteChromeTrace(m_TraceFile.c_str());
+        ImGui::SameLine();
+        ImGui::Text("CPU frame: %.2f ms", static_cast<double>(m_LastFrameEnd - m_LastFrameStart) * 1e-6);
+
+        if (ImGui::CollapsingHeader("CPU timeline", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            const auto Width = std::max(ImGui::GetContentRegionAvail().x, 100.f);
+            for (const auto& Thread : m_Threads)
+            {
+                if (!Thread.ThreadName.empty())
+                    ImGui::TextUnformatted(Thread.ThreadName.c_str());
+                else
+                    ImGui::Text("Thread %u", Thread.ThreadId);
+                DrawTimeline(Thread.Events, m_LastFrameStart, m_LastFrameEnd, Width);
+            }
+        }
+
+        if (m_pGPUProfiler != nullptr && ImGui::CollapsingHeader("GPU timeline", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            DrawGPUTimeline();
+        }
+
+        if (ImGui::CollapsingHeader("Top CPU scopes"))
+        {
+            DrawTopScopes();
+        }
+    }
+    ImGui::End();
+}
+
+void ProfilerOverlay::DrawTimeline(const std::vector<CPUProfiler::Event>& Events, Uint64 FrameStart, Uint64 FrameEnd, float Width)
+{
+    Uint32 NumRows = 0;
+    for (const auto& Evt : Events)
+        NumRows = std::max(NumRows, Evt.Depth + 1);
+
+    const auto   RowHeight   = ImGui::GetTextLineHeight() + 2.f;
+    const auto   Origin      = ImGui::GetCursorScreenPos();
+    const auto   FrameLength = std::max(FrameEnd - FrameStart, Uint64{1});
+    const double Scale       = static_cast<double>(Width) / static_cast<double>(FrameLength);
+
+    auto* pDrawList = ImGui::GetWindowDrawList();
+    pDrawList->AddRectFilled(Origin, ImVec2(Origin.x + Width, Origin.y + static_cast<float>(NumRows) * RowHeight), IM_COL32(40, 40, 40, 255));
+
+    for (const auto& Evt : Events)
+    {
+        // Clip scopes that started in the previous frame or ended in the next one
+        const auto Start = std::max(Evt.Start, FrameStart) - FrameStart;
+        const auto End   = std::max(std::min(Evt.End, FrameEnd), FrameStart) - FrameStart;
+
+        const ImVec2 Min{Origin.x + static_cast<float>(static_cast<double>(Start) * Scale), Origin.y + static_cast<float>(Evt.Depth) * RowHeight};
+        const ImVec2 Max{std::max(Origin.x + static_cast<float>(static_cast<double>(End) * Scale), Min.x + 1.f), Min.y + RowHeight - 1.f};
+        pDrawList->AddRectFilled(Min, Max, GetScopeColor(Evt.Name));
+
+        if (ImGui::CalcTextSize(Evt.Name).x + 4.f < Max.x - Min.x)
+            pDrawList->AddText(ImVec2(Min.x + 2.f, Min.y + 1.f), IM_COL32(0, 0, 0, 255), Evt.Name);
+
+        if (ImGui::IsMouseHoveringRect(Min, Max))
+            ImGui::SetTooltip("%s\n%.3f ms", Evt.Name, static_cast<double>(Evt.End - Evt.Start) * 1e-6);
+    }
+
+    ImGui::Dummy(ImVec2(Width, static_cast<float>(NumRows) * RowHeight));
+}
+
+void ProfilerOverlay::DrawGPUTimeline()
+{
+    if (m_GPUFrame.Scopes.empty() && m_GPUFrame.Duration == 0)
+    {
+        ImGui::TextDisabled("No GPU timings have been read back yet");
+        return;
+    }
+
+    ImGui::Text("GPU frame: %.2f ms", m_GPUFrame.Duration);
+
+    // Convert GPU scopes to the same representation as CPU events. Names point
+    // to the strings in m_GPUFrame that are alive until the next NewFrame().
+    std::vector<CPUProfiler::Event> Events;
+    Events.reserve(m_GPUFrame.Scopes.size());
+    for (const auto& Scope : m_GPUFrame.Scopes)
+    {
+        CPUProfiler::Event Evt;
+        Evt.Name  = Scope.Name.c_str();
+        Evt.Start = static_cast<Uint64>(Scope.Start * 1e+6);
+        Evt.End   = static_cast<Uint64>(Scope.End * 1e+6);
+        Evt.Depth = Scope.Depth;
+        Events.push_back(Evt);
+    }
+    DrawTimeline(Events, 0, static_cast<Uint64>(m_GPUFrame.Duration * 1e+6), std::max(ImGui::GetContentRegionAvail().x, 100.f));
+
+    for (const auto& Scope : m_GPUFrame.Scopes)
+    {
+        ImGui::Text("%8.3f ms  %*s%s", Scope.End - Scope.Start, static_cast<int>(Scope.Depth * 2), "", Scope.Name.c_str());
+    }
+}
+
+void ProfilerOverlay::DrawTopScopes()
+{
+    struct ScopeStats
+    {
+        std::string Name;
+        Uint64      TotalTime = 0;
+        Uint32      Count     = 0;
+    };
+
+    // Same scopes on different threads are accumulated together
+    std::unordered_map<std::string, ScopeStats> StatsMap;
+    for (const auto& Thread : m_Threads)
+    {
+        for (const auto& Evt : Thread.Events)
+        {
+            auto& Stats = StatsMap[Evt.Name];
+            Stats.TotalTime += Evt.End - Evt.Start;
+            ++Stats.Count;
+        }
+    }
+
+    std::vector<ScopeStats> Scopes;
+    Scopes.reserve(StatsMap.size());
+    for (auto& it : StatsMap)
+    {
+        it.second.Name = it.first;
+        Scopes.emplace_back(std::move(it.second));
+    }
+    std::sort(Scopes.begin(), Scopes.end(), [](const ScopeStats& lhs, const ScopeStats& rhs) {
+        return lhs.TotalTime > rhs.TotalTime;
+    });
+
+    constexpr size_t MaxScopes = 16;
+    for (size_t i = 0; i < std::min(Scopes.size(), MaxScopes); ++i)
+    {
+        const auto& Scope = Scopes[i];
+        ImGui::Text("%8.3f ms  %4u  %s", static_cast<double>(Scope.TotalTime) * 1e-6, Scope.Count, Scope.Name.c_str());
+    }
+}
+
+} // namespace Diligent
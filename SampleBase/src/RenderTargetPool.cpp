@@ -0,0 +1,204 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#include <algorithm>
+
+#include "RenderTargetPool.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Drivers may add padding and metadata, so this is a lower bound of the actual memory size
+Uint64 EstimateTextureMemorySize(const TextureDesc& Desc)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+
+    const Uint32 BlockWidth  = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? FmtAttribs.BlockWidth : 1;
+    const Uint32 BlockHeight = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? FmtAttribs.BlockHeight : 1;
+    const Uint32 BlockSize   = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ?
+        Uint32{FmtAttribs.ComponentSize} :
+        Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+
+    const Uint32 NumSlices = Desc.Type == RESOURCE_DIM_TEX_3D ? Desc.Depth : Desc.ArraySize;
+
+    Uint64 Size   = 0;
+    Uint32 Width  = Desc.Width;
+    Uint32 Height = Desc.Height;
+    for (Uint32 Mip = 0; Desc.MipLevels == 0 || Mip < Desc.MipLevels; ++Mip)
+    {
+        Size += Uint64{(Width + BlockWidth - 1) / BlockWidth} * Uint64{(Height + BlockHeight - 1) / BlockHeight} * BlockSize;
+        if (Width == 1 && Height == 1)
+            break;
+        Width  = std::max(Width / 2, 1u);
+        Height = std::max(Height / 2, 1u);
+    }
+
+    return Size * NumSlices * std::max(Uint32{Desc.SampleCount}, 1u);
+}
+
+} // namespace
+
+RenderTargetPool::RenderTargetPool(IRenderDevice* pDevice, Uint32 MaxUnusedFrames) :
+    // clang-format off
+    m_pDevice        {pDevice},
+    m_MaxUnusedFrames{MaxUnusedFrames}
+// clang-format on
+{
+}
+
+bool RenderTargetPool::IsAvailable(const PooledTexture& Texture) const
+{
+    if (Texture.IsTransient)
+        return false;
+
+    // The pool holds the only reference when no one else uses a persistent texture. Views of transient
+    // textures share the reference counters and may be kept by the caller, so they are not counted.
+    return !Texture.IsPersistent || Texture.pTexture->GetReferenceCounters()->GetNumStrongRefs() == 1;
+}
+
+RenderTargetPool::PooledTexture* RenderTargetPool::AcquireTexture(const TextureDesc& Desc)
+{
+    for (auto& Texture : m_Textures)
+    {
+        // Texture description comparison ignores the name
+        if (Texture.pTexture->GetDesc() == Desc && IsAvailable(Texture))
+        {
+            Texture.LastUsedFrame = m_FrameNumber;
+            return &Texture;
+        }
+    }
+
+    PooledTexture NewTexture;
+    m_pDevice->CreateTexture(Desc, nullptr, &NewTexture.pTexture);
+    if (!NewTexture.pTexture)
+    {
+        LOG_ERROR_MESSAGE("Failed to create pooled texture '", (Desc.Name != nullptr ? Desc.Name : ""), "'");
+        return nullptr;
+    }
+
+    NewTexture.MemorySize    = EstimateTextureMemorySize(Desc);
+    NewTexture.LastUsedFrame = m_FrameNumber;
+
+    m_Stats.NumTextures += 1;
+    m_Stats.NumCreatedTextures += 1;
+    m_Stats.MemorySize += NewTexture.MemorySize;
+    m_Stats.PeakMemorySize = std::max(m_Stats.PeakMemorySize, m_Stats.MemorySize);
+
+    m_Textures.emplace_back(std::move(NewTexture));
+    return &m_Textures.back();
+}
+
+ITexture* RenderTargetPool::AcquireTransient(const TextureDesc& Desc)
+{
+    auto* pTexture = AcquireTexture(Desc);
+    if (pTexture == nullptr)
+        return nullptr;
+
+    pTexture->IsTransient  = true;
+    pTexture->IsPersistent = false;
+    return pTexture->pTexture;
+}
+
+void RenderTargetPool::ReleaseTransient(ITexture* pTexture)
+{
+    for (auto& Texture : m_Textures)
+    {
+        if (Texture.pTexture.RawPtr() == pTexture)
+        {
+            VERIFY(Texture.IsTransient, "The texture was not acquired as transient");
+            Texture.IsTransient = false;
+            return;
+        }
+    }
+    UNEXPECTED("The texture does not belong to the pool");
+}
+
+RefCntAutoPtr<ITexture> RenderTargetPool::Acquire(const TextureDesc& Desc)
+{
+    auto* pTexture = AcquireTexture(Desc);
+    if (pTexture == nullptr)
+        return {};
+
+    pTexture->IsPersistent = true;
+    return pTexture->pTexture;
+}
+
+void RenderTargetPool::ReleaseTexture(size_t Idx)
+{
+    m_Stats.NumTextures -= 1;
+    m_Stats.MemorySize -= m_Textures[Idx].MemorySize;
+
+    // The device defers the destruction until the GPU is done with the texture
+    m_Textures[Idx] = std::move(m_Textures.back());
+    m_Textures.pop_back();
+}
+
+void RenderTargetPool::NextFrame()
+{
+    for (size_t i = 0; i < m_Textures.size();)
+    {
+        auto& Texture = m_Textures[i];
+
+        Texture.IsTransient = false;
+        if (!IsAvailable(Texture))
+        {
+            // Persistent textures are in use for as long as they are referenced
+            Texture.LastUsedFrame = m_FrameNumber;
+        }
+        else if (m_FrameNumber - Texture.LastUsedFrame >= m_MaxUnusedFrames)
+        {
+            ReleaseTexture(i);
+            continue;
+        }
+        ++i;
+    }
+
+    ++m_FrameNumber;
+}
+
+void RenderTargetPool::ReleaseUnused()
+{
+    for (size_t i = 0; i < m_Textures.size();)
+    {
+        if (IsAvailable(m_Textures[i]))
+            ReleaseTexture(i);
+        else
+            ++i;
+    }
+}
+
+void RenderTargetPool::LogStatistics() const
+{
+    LOG_INFO_MESSAGE("Render target pool: ", m_Stats.NumCreatedTextures, " textures created, peak memory ",
+                     static_cast<double>(m_Stats.PeakMemorySize) / (1 << 20), " MB");
+}
+
+} // namespace Diligent
@@ -26,17 +26,27 @@
 */
 
 #include <sstream>
+#include <cstdio>
 #include <iomanip>
 #include <cstdlib>
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <thread>
 
 #include "PlatformDefinitions.h"
 #include "SampleApp.hpp"
 #include "Errors.hpp"
 #include "StringTools.hpp"
+#include "FileSystem.hpp"
 #include "MapHelper.hpp"
 #include "Image.hpp"
 #include "FileWrapper.hpp"
+#include "HeadlessSwapChain.hpp"
+#include "Timer.hpp"
+#include "ImageDiff.hpp"
+#include "CPUProfiler.hpp"
+#include "AssetArchive.hpp"
 
 #if D3D11_SUPPORTED
 #    include "EngineFactoryD3D11.h"
@@ -72,8 +82,66 @@ SampleApp::SampleApp() :
 
 SampleApp::~SampleApp()
 {
+    if (m_pBenchmark)
+        m_pBenchmark->Finish();
+
+    ReleaseDiligentEngine();
+}
+
+void SampleApp::ReleaseDiligentEngine()
+{
+    if (m_pImageWriter)
+    {
+        m_pImageWriter->WaitForIdle();
+        const auto NumFailed  = m_pImageWriter->GetNumFailedImages();
+        const auto NumDropped = m_pImageWriter->GetNumDroppedImages();
+        const auto NumLate    = m_pImageWriter->GetNumLateImages();
+        if (NumFailed > 0 || NumDropped > 0 || NumLate > 0)
+        {
+            LOG_WARNING_MESSAGE("Screen capture: ", m_pImageWriter->GetNumWrittenImages(), " frames written, ", NumFailed, " failed, ",
+                                NumDropped, " dropped, ", NumLate, " stalled the render thread waiting for the encoder");
+        }
+        m_pImageWriter.reset();
+    }
+
+    if (m_pVideoStreamWriter)
+    {
+        LOG_INFO_MESSAGE("Screen capture: ", m_pVideoStreamWriter->GetNumFrames(), " frames written to the video stream");
+        m_pVideoStreamWriter.reset();
+    }
+
     m_pImGui.reset();
+    // Stop the update thread before the sample is destroyed
+    m_pFramePipeline.reset();
     m_TheSample.reset();
+    m_pShaderCache.reset();
+    m_pTextureLoader.reset();
+    if (m_pRenderTargetPool)
+    {
+        m_pRenderTargetPool->LogStatistics();
+        m_pRenderTargetPool.reset();
+    }
+    if (m_pCameraPath)
+    {
+        if (m_bRecordCameraPath && m_pCameraPath->GetNumKeys() > 0 && m_pCameraPath->Save(m_CameraPathFile.c_str()))
+        {
+            LOG_INFO_MESSAGE("Camera path: ", m_pCameraPath->GetNumKeys(), " keys (", m_pCameraPath->GetDuration(),
+                             " s) written to '", m_CameraPathFile, "'");
+        }
+        m_pCameraPath.reset();
+    }
+    AssetArchive::Unmount();
+
+    if (m_pProfilerOverlay)
+        m_pProfilerOverlay->SetGPUProfiler(nullptr);
+    m_pGPUProfiler.reset();
+
+    // Write the trace after the sample has stopped its threads so that their last scopes are complete
+    if (!m_ProfilerTraceFile.empty())
+    {
+        CPUProfiler::WriteChromeTrace(m_ProfilerTraceFile.c_str());
+        m_ProfilerTraceFile.clear();
+    }
 
     if (m_pImmediateContext)
         m_pImmediateContext->Flush();
@@ -93,6 +161,11 @@ void SampleApp::InitializeDiligentEngine(
     SwapChainDesc SCDesc;
     if (m_ScreenCaptureInfo.AllowCapture)
         SCDesc.Usage |= SWAP_CHAIN_USAGE_COPY_SOURCE;
+    if (m_HeadlessMode.Enabled)
+    {
+        SCDesc.Width  = m_HeadlessMode.Width;
+        SCDesc.Height = m_HeadlessMode.Height;
+    }
 
 #if PLATFORM_MACOS
     // We need at least 3 buffers on Metal to avoid massive
@@ -372,6 +445,14 @@ void SampleApp::InitializeDiligentEngine(
     for (Uint32 ctx = 0; ctx < NumDeferredCtx; ++ctx)
         m_pDeferredContexts[ctx].Attach(ppContexts[1 + ctx]);
 
+    if (m_HeadlessMode.Enabled && !m_pSwapChain)
+    {
+        // There is no window to present to, so render into offscreen buffers instead
+        HeadlessSwapChain::Create(m_pDevice, m_pImmediateContext, SCDesc, &m_pSwapChain);
+        if (!m_pSwapChain)
+            LOG_ERROR_AND_THROW("Failed to create headless swap chain");
+    }
+
     if (m_ScreenCaptureInfo.AllowCapture)
     {
         if (m_GoldenImgMode == GoldenImageMode::Capture || m_GoldenImgMode == GoldenImageMode::Compare)
@@ -381,6 +462,15 @@ void SampleApp::InitializeDiligentEngine(
         }
 
         m_pScreenCapture.reset(new ScreenCapture(m_pDevice));
+
+        if (m_GoldenImgMode != GoldenImageMode::Compare && !m_ScreenCaptureInfo.WriteVideoStream)
+        {
+            auto NumThreads = m_ScreenCaptureInfo.NumThreads;
+            if (NumThreads == 0)
+                NumThreads = std::min(std::max(std::thread::hardware_concurrency() / 2, 1u), 4u);
+            // Allow two images per worker to be in flight so that workers never starve
+            m_pImageWriter.reset(new AsyncImageWriter{NumThreads, NumThreads * 2, m_ScreenCaptureInfo.DropFrames});
+        }
     }
 }
 
@@ -421,9 +511,72 @@ void SampleApp::InitializeSample()
     Uint32 NumDeferredCtx = static_cast<Uint32>(m_pDeferredContexts.size());
     for (size_t ctx = 0; ctx < m_pDeferredContexts.size(); ++ctx)
         ppContexts[1 + ctx] = m_pDeferredContexts[ctx];
+
+    if (m_pProfilerOverlay)
+    {
+        if (m_pDevice->GetDeviceCaps().Features.TimestampQueries)
+        {
+            // Keep queries for all frames queued in the swap chain plus the frames being recorded and read back
+            m_pGPUProfiler.reset(new GPUProfiler{m_pDevice, m_pImmediateContext, SCDesc.BufferCount + 2, 64});
+            m_TheSample->SetGPUProfiler(m_pGPUProfiler.get());
+            m_pProfilerOverlay->SetGPUProfiler(m_pGPUProfiler.get());
+        }
+        else
+        {
+            LOG_WARNING_MESSAGE("Timestamp queries are not supported by this device. GPU profiler is disabled.");
+        }
+    }
+
+    // The archive packed by the build is mounted when it is found in the working directory
+    if (m_AssetArchivePath.empty() && FileSystem::FileExists(DefaultAssetArchive))
+        m_AssetArchivePath = DefaultAssetArchive;
+    if (!m_AssetArchivePath.empty() && m_AssetArchivePath != "none")
+        AssetArchive::Mount(m_AssetArchivePath.c_str());
+
+    m_pShaderCache.reset(new ShaderCache{m_pDevice, m_ShaderCacheDir});
+    m_TheSample->SetShaderCache(m_pShaderCache.get());
+
+    // Leave one core to the main thread that creates the textures
+    const auto NumLoaderThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    m_pTextureLoader.reset(new AsyncTextureLoader{m_pDevice, NumLoaderThreads});
+    m_TheSample->SetTextureLoader(m_pTextureLoader.get());
+
+    m_pRenderTargetPool.reset(new RenderTargetPool{m_pDevice});
+    m_TheSample->SetRenderTargetPool(m_pRenderTargetPool.get());
+
+    if (!m_CameraPathFile.empty())
+    {
+        m_pCameraPath.reset(new CameraPath{});
+        if (m_bRecordCameraPath || m_pCameraPath->Load(m_CameraPathFile.c_str()))
+            m_TheSample->SetCameraPath(m_pCameraPath.get(), m_bRecordCameraPath);
+        else
+            m_pCameraPath.reset();
+    }
+
+    m_TheSample->SetFrameStatistics(&m_FrameStats);
     m_TheSample->Initialize(m_pEngineFactory, m_pDevice, ppContexts.data(), NumDeferredCtx, m_pSwapChain);
 
+    if (!m_ShaderCacheDir.empty())
+        m_pShaderCache->LogStatistics();
+
+    // Golden images must not contain placeholder textures
+    if (m_GoldenImgMode != GoldenImageMode::None)
+        m_pTextureLoader->Flush(m_pImmediateContext);
+
     m_TheSample->WindowResize(SCDesc.Width, SCDesc.Height);
+
+    if (m_TheSample->SupportsPipelinedUpdate())
+    {
+        auto* pSample  = m_TheSample.get();
+        auto  Simulate = [pSample](double CurrTime, double ElapsedTime, Uint32 SnapshotIdx) {
+            pSample->UpdateSimulation(CurrTime, ElapsedTime, SnapshotIdx);
+        };
+        m_pFramePipeline.reset(new FramePipeline{m_MaxFrameLatency, std::move(Simulate)});
+    }
+    else if (m_MaxFrameLatency > 0)
+    {
+        LOG_WARNING_MESSAGE("The sample does not support pipelined update. Maximum frame latency is ignored.");
+    }
 }
 
 void SampleApp::UpdateAdaptersDialog()
@@ -487,12 +640,81 @@ void SampleApp::UpdateAdaptersDialog()
             }
 
             ImGui::Checkbox("VSync", &m_bVSync);
+            if (m_pProfilerOverlay)
+            {
+                ImGui::SameLine();
+                ImGui::Checkbox("Profiler", &m_bShowProfiler);
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Frame stats", &m_bShowFrameStats);
         }
         ImGui::End();
     }
 #endif
 }
 
+void SampleApp::UpdateFrameStatisticsWindow()
+{
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Frame statistics", &m_bShowFrameStats, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        const auto& Stats = m_FrameStats.GetStatistics();
+
+        const auto Budget = m_FrameStats.GetHitchThreshold();
+        ImGui::Text("%.1f FPS (%.2f ms), %u frames", m_FrameStats.GetFPS(), m_FrameStats.GetAverageFrameTime() * 1000.0, m_FrameStats.GetNumFrames());
+        ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", Stats.Median * 1000.0, Stats.P95 * 1000.0, Stats.P99 * 1000.0, Stats.Max * 1000.0);
+        ImGui::Text("Hitches over %.1f ms: %u (%llu total)", Budget * 1000.0, m_FrameStats.GetNumHitches(), static_cast<unsigned long long>(m_FrameStats.GetTotalHitches()));
+        if (m_InputLatencyStats.GetNumFrames() > 0)
+        {
+            const auto& LatencyStats = m_InputLatencyStats.GetStatistics();
+            ImGui::Text("Input to present: last %.2f  p50 %.2f  p95 %.2f  max %.2f ms", m_InputLatencyStats.GetLastFrameTime() * 1000.0,
+                        LatencyStats.Median * 1000.0, LatencyStats.P95 * 1000.0, LatencyStats.Max * 1000.0);
+        }
+        else
+        {
+            ImGui::TextDisabled("Input to present: no input");
+        }
+        if (m_pRenderTargetPool)
+        {
+            const auto& RTStats = m_pRenderTargetPool->GetStatistics();
+            ImGui::Text("Render targets: %u, %.1f MB (peak %.1f MB)", RTStats.NumTextures,
+                        static_cast<double>(RTStats.MemorySize) / (1 << 20), static_cast<double>(RTStats.PeakMemorySize) / (1 << 20));
+        }
+
+        std::vector<double> FrameTimes;
+        m_FrameStats.GetFrameTimes(FrameTimes);
+        if (!FrameTimes.empty())
+        {
+            // Leave some headroom above the budget or the slowest frame, whichever is greater
+            const auto MaxTimeMs = static_cast<float>(std::max(Stats.Max, Budget) * 1000.0 * 1.25);
+
+            std::vector<float> FrameTimesMs(FrameTimes.size());
+            for (size_t i = 0; i < FrameTimes.size(); ++i)
+                FrameTimesMs[i] = static_cast<float>(FrameTimes[i] * 1000.0);
+            ImGui::PlotLines("Frame time", FrameTimesMs.data(), static_cast<int>(FrameTimesMs.size()), 0, nullptr, 0.f, MaxTimeMs, ImVec2(300, 80));
+
+            // Frame times are binned in [0, MaxTimeMs), so the bins of a smooth run are
+            // clustered on the left and hitches stand out on the right
+            static constexpr int NumBins = 40;
+
+            float Histogram[NumBins] = {};
+            for (auto FrameTimeMs : FrameTimesMs)
+            {
+                auto Bin = static_cast<int>(FrameTimeMs / MaxTimeMs * NumBins);
+                Histogram[std::min(std::max(Bin, 0), NumBins - 1)] += 1.f;
+            }
+            std::stringstream ss;
+            ss << "0 - " << std::fixed << std::setprecision(1) << MaxTimeMs << " ms";
+            ImGui::PlotHistogram("Histogram", Histogram, NumBins, 0, ss.str().c_str(), 0.f, FLT_MAX, ImVec2(300, 80));
+        }
+
+        auto BudgetMs = static_cast<float>(Budget * 1000.0);
+        if (ImGui::SliderFloat("Hitch budget, ms", &BudgetMs, 1.f, 100.f, "%.1f"))
+            m_FrameStats.SetHitchThreshold(BudgetMs / 1000.0);
+    }
+    ImGui::End();
+}
+
 
 std::string GetArgument(const char*& pos, const char* ArgName)
 {
@@ -599,9 +821,19 @@ void SampleApp::ProcessCommandLine(const char* CmdLine)
             {
                 m_ScreenCaptureInfo.FileFormat = EImageFileFormat::png;
             }
+            else if (StrCmpNoCase(Arg.c_str(), "y4m", Arg.length()) == 0)
+            {
+                m_ScreenCaptureInfo.WriteVideoStream = true;
+                m_ScreenCaptureInfo.StreamFormat     = VideoStreamWriter::FORMAT::Y4M;
+            }
+            else if (StrCmpNoCase(Arg.c_str(), "raw", Arg.length()) == 0)
+            {
+                m_ScreenCaptureInfo.WriteVideoStream = true;
+                m_ScreenCaptureInfo.StreamFormat     = VideoStreamWriter::FORMAT::Raw;
+            }
             else
             {
-                LOG_ERROR_MESSAGE("Unknown capture format. The following are allowed values: 'jpeg', 'jpg', 'png'");
+                LOG_ERROR_MESSAGE("Unknown capture format. The following are allowed values: 'jpeg', 'jpg', 'png', 'y4m', 'raw'");
             }
         }
         else if (!(Arg = GetArgument(pos, "capture_quality")).empty())
@@ -612,6 +844,16 @@ void SampleApp::ProcessCommandLine(const char* CmdLine)
         {
             m_ScreenCaptureInfo.KeepAlpha = (StrCmpNoCase(Arg.c_str(), "true", Arg.length()) == 0) || Arg == "1";
         }
+        else if (!(Arg = GetArgument(pos, "capture_threads")).empty())
+        {
+            auto NumThreads = atoi(Arg.c_str());
+            VERIFY_EXPR(NumThreads >= 0);
+            m_ScreenCaptureInfo.NumThreads = static_cast<Uint32>(std::max(NumThreads, 0));
+        }
+        else if (!(Arg = GetArgument(pos, "capture_drop")).empty())
+        {
+            m_ScreenCaptureInfo.DropFrames = (StrCmpNoCase(Arg.c_str(), "true", Arg.length()) == 0) || Arg == "1";
+        }
         else if (!(Arg = GetArgument(pos, "width")).empty())
         {
             m_InitialWindowWidth = atoi(Arg.c_str());
@@ -668,13 +910,109 @@ void SampleApp::ProcessCommandLine(const char* CmdLine)
         {
             m_GoldenImgPixelTolerance = atoi(Arg.c_str());
         }
+        else if (!(Arg = GetArgument(pos, "golden_image_diff")).empty())
+        {
+            m_bWriteGoldenImgDiff = (StrCmpNoCase(Arg.c_str(), "true", Arg.length()) == 0) || Arg == "1";
+        }
+        else if (!(Arg = GetArgument(pos, "headless")).empty())
+        {
+            int Width  = 0;
+            int Height = 0;
+            if (sscanf(Arg.c_str(), "%dx%d", &Width, &Height) == 2 && Width > 0 && Height > 0)
+            {
+                m_HeadlessMode.Enabled = true;
+                m_HeadlessMode.Width   = static_cast<Uint32>(Width);
+                m_HeadlessMode.Height  = static_cast<Uint32>(Height);
+            }
+            else
+            {
+                LOG_ERROR_MESSAGE("Invalid headless render target size: '", Arg, "'. Expected format is WxH, for example: 1024x768");
+            }
+        }
+        else if (!(Arg = GetArgument(pos, "headless_frames")).empty())
+        {
+            auto NumFrames = atoi(Arg.c_str());
+            VERIFY_EXPR(NumFrames > 0);
+            m_HeadlessMode.NumFrames = static_cast<Uint32>(std::max(NumFrames, 1));
+        }
+        else if (!(Arg = GetArgument(pos, "bench_frames")).empty())
+        {
+            auto NumFrames = atoi(Arg.c_str());
+            VERIFY_EXPR(NumFrames >= 0);
+            m_BenchmarkInfo.NumFrames = static_cast<Uint32>(std::max(NumFrames, 0));
+        }
+        else if (!(Arg = GetArgument(pos, "bench_warmup")).empty())
+        {
+            auto NumFrames = atoi(Arg.c_str());
+            VERIFY_EXPR(NumFrames >= 0);
+            m_BenchmarkInfo.NumWarmupFrames = static_cast<Uint32>(std::max(NumFrames, 0));
+        }
+        else if (!(Arg = GetArgument(pos, "bench_out")).empty())
+        {
+            m_BenchmarkInfo.OutputFile = std::move(Arg);
+        }
+        else if (!(Arg = GetArgument(pos, "profiler")).empty())
+        {
+            m_bShowProfiler = (StrCmpNoCase(Arg.c_str(), "true", Arg.length()) == 0) || Arg == "1";
+        }
+        else if (!(Arg = GetArgument(pos, "profiler_trace")).empty())
+        {
+            m_ProfilerTraceFile = std::move(Arg);
+        }
+        else if (!(Arg = GetArgument(pos, "shader_cache")).empty())
+        {
+            m_ShaderCacheDir = std::move(Arg);
+        }
+        else if (!(Arg = GetArgument(pos, "asset_archive")).empty())
+        {
+            m_AssetArchivePath = std::move(Arg);
+        }
+        else if (!(Arg = GetArgument(pos, "camera_path")).empty())
+        {
+            m_CameraPathFile    = std::move(Arg);
+            m_bRecordCameraPath = false;
+        }
+        else if (!(Arg = GetArgument(pos, "record_camera_path")).empty())
+        {
+            m_CameraPathFile    = std::move(Arg);
+            m_bRecordCameraPath = true;
+        }
+        else if (!(Arg = GetArgument(pos, "frame_stats")).empty())
+        {
+            m_bShowFrameStats = (StrCmpNoCase(Arg.c_str(), "true", Arg.length()) == 0) || Arg == "1";
+        }
+        else if (!(Arg = GetArgument(pos, "hitch_budget")).empty())
+        {
+            auto BudgetMs = atof(Arg.c_str());
+            if (BudgetMs > 0)
+                m_FrameStats.SetHitchThreshold(BudgetMs / 1000.0);
+            else
+                LOG_ERROR_MESSAGE("Hitch budget must be positive");
+        }
+        else if (!(Arg = GetArgument(pos, "frame_latency")).empty())
+        {
+            auto Latency = atoi(Arg.c_str());
+            VERIFY_EXPR(Latency >= 0);
+            m_MaxFrameLatency = static_cast<Uint32>(std::max(Latency, 0));
+        }
+        else if (!(Arg = GetArgument(pos, "fixed_dt")).empty())
+        {
+            m_BenchmarkInfo.FixedDeltaTime = atof(Arg.c_str());
+            if (m_BenchmarkInfo.FixedDeltaTime < 0)
+            {
+                LOG_ERROR_MESSAGE("Fixed time step must not be negative");
+                m_BenchmarkInfo.FixedDeltaTime = 0;
+            }
+        }
 
         pos = strchr(pos, '-');
     }
 
     if (m_DeviceType == RENDER_DEVICE_TYPE_UNDEFINED)
     {
-        SelectDeviceType();
+        // Device type selection dialog requires a display
+        if (!m_HeadlessMode.Enabled)
+            SelectDeviceType();
         if (m_DeviceType == RENDER_DEVICE_TYPE_UNDEFINED)
         {
 #if D3D12_SUPPORTED
@@ -690,12 +1028,118 @@ void SampleApp::ProcessCommandLine(const char* CmdLine)
     }
 
     m_TheSample->ProcessCommandLine(CmdLine);
+
+    if (m_ScreenCaptureInfo.WriteVideoStream && m_GoldenImgMode != GoldenImageMode::None)
+    {
+        LOG_WARNING_MESSAGE("Video stream capture is not available in golden image mode. Images will be saved in png format.");
+        m_ScreenCaptureInfo.WriteVideoStream = false;
+        m_ScreenCaptureInfo.FileFormat       = EImageFileFormat::png;
+    }
+
+    if (m_BenchmarkInfo.NumFrames > 0)
+    {
+        m_pBenchmark.reset(new FrameBenchmark{m_BenchmarkInfo.NumWarmupFrames, m_BenchmarkInfo.NumFrames, m_BenchmarkInfo.OutputFile});
+    }
+    else if (!m_BenchmarkInfo.OutputFile.empty())
+    {
+        LOG_WARNING_MESSAGE("Benchmark output file is ignored because -bench_frames is not specified");
+    }
+
+    if (m_bShowProfiler || !m_ProfilerTraceFile.empty())
+    {
+        CPUProfiler::SetEnabled(true);
+        CPUProfiler::SetThreadName("Main");
+        m_pProfilerOverlay.reset(new ProfilerOverlay);
+        if (!m_ProfilerTraceFile.empty())
+            m_pProfilerOverlay->SetTraceFile(m_ProfilerTraceFile);
+    }
+
+    if (m_HeadlessMode.Enabled)
+    {
+        // Platform main loops always create a native window, so the headless
+        // run is performed here and the process exits once it is complete.
+        RunHeadless();
+        ReleaseDiligentEngine();
+        std::exit(m_ExitCode);
+    }
+}
+
+// Command line example to run a sample without a window on a software adapter:
+//
+//     -mode vk -adapter sw -headless 1024x768 -headless_frames 300
+//
+void SampleApp::RunHeadless()
+{
+    if (m_DeviceType == RENDER_DEVICE_TYPE_GL || m_DeviceType == RENDER_DEVICE_TYPE_GLES)
+    {
+#if VULKAN_SUPPORTED
+        LOG_WARNING_MESSAGE("OpenGL requires a native window. Falling back to Vulkan in headless mode.");
+        m_DeviceType = RENDER_DEVICE_TYPE_VULKAN;
+#else
+        LOG_ERROR_MESSAGE("Headless mode is not supported in OpenGL. Please select another device type");
+        m_ExitCode = -1;
+        return;
+#endif
+    }
+
+    try
+    {
+        InitializeDiligentEngine(
+#if PLATFORM_LINUX
+            nullptr,
+#endif
+            nullptr);
+
+        const auto& SCDesc = m_pSwapChain->GetDesc();
+        m_pImGui.reset(new ImGuiImplDiligent(m_pDevice, SCDesc.ColorBufferFormat, SCDesc.DepthBufferFormat));
+        ImGui::GetIO().DisplaySize = ImVec2(static_cast<float>(SCDesc.Width), static_cast<float>(SCDesc.Height));
+
+        InitializeSample();
+    }
+    catch (...)
+    {
+        LOG_ERROR_MESSAGE("Failed to initialize Diligent Engine in headless mode.");
+        m_ExitCode = -1;
+        return;
+    }
+
+    // Golden image capture and comparison only need a single frame
+    auto NumFrames = m_HeadlessMode.NumFrames;
+    if (m_GoldenImgMode != GoldenImageMode::None)
+        NumFrames = 1;
+    else if (m_pBenchmark)
+        NumFrames = m_pBenchmark->GetTotalFrameCount();
+
+    Timer  timer;
+    double PrevTime = timer.GetElapsedTime();
+    for (Uint32 frame = 0; frame < NumFrames; ++frame)
+    {
+        auto CurrTime    = timer.GetElapsedTime();
+        auto ElapsedTime = CurrTime - PrevTime;
+        PrevTime         = CurrTime;
+
+        Update(CurrTime, ElapsedTime);
+        Render();
+        Present();
+    }
+
+    m_pImmediateContext->WaitForIdle();
+    LOG_INFO_MESSAGE("Rendered ", NumFrames, " frames in headless mode in ", timer.GetElapsedTime(), " s");
+
+    const auto& Stats = m_FrameStats.GetStatistics();
+    LOG_INFO_MESSAGE("Frame time over the last ", m_FrameStats.GetNumFrames(), " frames, ms: p50 ", Stats.Median * 1000.0,
+                     ", p95 ", Stats.P95 * 1000.0, ", p99 ", Stats.P99 * 1000.0, ", max ", Stats.Max * 1000.0,
+                     "; ", m_FrameStats.GetTotalHitches(), " hitches over ", m_FrameStats.GetHitchThreshold() * 1000.0, " ms");
 }
 
 void SampleApp::WindowResize(int width, int height)
 {
     if (m_pSwapChain)
     {
+        if (m_pFramePipeline)
+            m_pFramePipeline->WaitForUpdate();
+
+        m_TheSample->PreWindowResize();
         m_pSwapChain->Resize(width, height);
         auto SCWidth  = m_pSwapChain->GetDesc().Width;
         auto SCHeight = m_pSwapChain->GetDesc().Height;
@@ -705,8 +1149,22 @@ void SampleApp::WindowResize(int width, int height)
 
 void SampleApp::Update(double CurrTime, double ElapsedTime)
 {
+    if (m_pProfilerOverlay)
+        m_pProfilerOverlay->NewFrame();
+    CPU_PROFILER_SCOPE("Update");
+
+    if (m_BenchmarkInfo.FixedDeltaTime > 0)
+    {
+        // Replace wall-clock time with the synthetic clock to make runs reproducible
+        ElapsedTime = m_BenchmarkInfo.FixedDeltaTime;
+        CurrTime    = static_cast<double>(m_BenchmarkInfo.FrameIndex) * m_BenchmarkInfo.FixedDeltaTime;
+    }
+    ++m_BenchmarkInfo.FrameIndex;
+
     m_CurrentTime = CurrTime;
 
+    const auto UpdateStartTime = m_FrameTimer.GetElapsedTime();
+
     if (m_pImGui)
     {
         m_pImGui->NewFrame();
@@ -714,12 +1172,34 @@ void SampleApp::Update(double CurrTime, double ElapsedTime)
         {
             UpdateAdaptersDialog();
         }
+        if (m_pProfilerOverlay && m_bShowProfiler)
+        {
+            m_pProfilerOverlay->Draw(&m_bShowProfiler);
+        }
+        if (m_bShowFrameStats)
+        {
+            UpdateFrameStatisticsWindow();
+        }
     }
     if (m_pDevice)
     {
+        // The sample may change the simulation state while handling UI and input
+        if (m_pFramePipeline)
+            m_pFramePipeline->WaitForUpdate();
+
+        m_pTextureLoader->Update(m_pImmediateContext);
+        m_pRenderTargetPool->NextFrame();
+
         m_TheSample->Update(CurrTime, ElapsedTime);
         m_TheSample->GetInputController().ClearState();
+
+        if (m_pFramePipeline)
+        {
+            m_pFramePipeline->BeginUpdate(CurrTime, ElapsedTime);
+            m_TheSample->SetRenderSnapshot(m_pFramePipeline->GetRenderSnapshotIndex());
+        }
     }
+    m_FrameTimings.Update = m_FrameTimer.GetElapsedTime() - UpdateStartTime;
 }
 
 void SampleApp::Render()
@@ -727,11 +1207,30 @@ void SampleApp::Render()
     if (!m_pImmediateContext)
         return;
 
+    CPU_PROFILER_SCOPE("Render");
+
+    const auto RenderStartTime = m_FrameTimer.GetElapsedTime();
+
     ITextureView* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
     ITextureView* pDSV = m_pSwapChain->GetDepthBufferDSV();
     m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 
-    m_TheSample->Render();
+    if (m_pGPUProfiler)
+        m_pGPUProfiler->BeginFrame();
+
+    if (m_TheSample->SupportsLateInputLatching())
+    {
+        CPU_PROFILER_SCOPE("LateLatchInput");
+        PollInput();
+        m_TheSample->LateLatchInput(m_CurrentTime);
+    }
+    // All input received so far has been applied to this frame
+    m_LatchedInputTime = m_TheSample->GetInputController().LatchEventTime();
+
+    {
+        GPU_PROFILER_SCOPE(m_pGPUProfiler.get(), "Sample");
+        m_TheSample->Render();
+    }
 
     // Restore default render target in case the sample has changed it
     m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
@@ -739,6 +1238,7 @@ void SampleApp::Render()
     {
         if (m_bShowUI)
         {
+            GPU_PROFILER_SCOPE(m_pGPUProfiler.get(), "UI");
             // No need to call EndFrame as ImGui::Render calls it automatically
             m_pImGui->Render(m_pImmediateContext);
         }
@@ -747,6 +1247,11 @@ void SampleApp::Render()
             m_pImGui->EndFrame();
         }
     }
+
+    if (m_pGPUProfiler)
+        m_pGPUProfiler->EndFrame();
+
+    m_FrameTimings.Render = m_FrameTimer.GetElapsedTime() - RenderStartTime;
 }
 
 void SampleApp::CompareGoldenImage(const std::string& FileName, ScreenCapture::CaptureInfo& Capture)
@@ -777,25 +1282,72 @@ void SampleApp::CompareGoldenImage(const std::string& FileName, ScreenCapture::C
 
     MappedTextureSubresource TexData;
     m_pImmediateContext->MapTextureSubresource(Capture.pTexture, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, TexData);
-    auto CapturedPixels = Image::ConvertImageData(TexDesc.Width, TexDesc.Height,
+
+    ImageDiffAttribs DiffAttribs;
+    DiffAttribs.Width          = TexDesc.Width;
+    DiffAttribs.Height         = TexDesc.Height;
+    DiffAttribs.pData0         = TexData.pData;
+    DiffAttribs.Stride0        = TexData.Stride;
+    DiffAttribs.Format0        = TexDesc.Format;
+    DiffAttribs.pData1         = pGoldenImg->GetData()->GetDataPtr();
+    DiffAttribs.Stride1        = GoldenImgDesc.RowStride;
+    DiffAttribs.NumComponents1 = GoldenImgDesc.NumComponents;
+    DiffAttribs.Tolerance      = static_cast<Uint32>(std::max(m_GoldenImgPixelTolerance, 0));
+
+    std::vector<Uint8> HeatMap;
+    if (m_bWriteGoldenImgDiff)
+        DiffAttribs.pHeatMap = &HeatMap;
+
+    // Compare the mapped data directly when possible, otherwise convert it to RGBA first
+    std::vector<Uint8> ConvertedPixels;
+    ImageDiffStats     DiffStats;
+    if (!ComputeImageDiff(DiffAttribs, DiffStats))
+    {
+        ConvertedPixels = Image::ConvertImageData(TexDesc.Width, TexDesc.Height,
                                                   reinterpret_cast<const Uint8*>(TexData.pData), TexData.Stride,
-                                                  TexDesc.Format, TEX_FORMAT_RGBA8_UNORM, false /*Keep alpha*/);
+                                                  TexDesc.Format, TEX_FORMAT_RGBA8_UNORM, true /*Keep alpha*/);
+        DiffAttribs.pData0  = ConvertedPixels.data();
+        DiffAttribs.Stride0 = TexDesc.Width * 4;
+        DiffAttribs.Format0 = TEX_FORMAT_RGBA8_UNORM;
+        ComputeImageDiff(DiffAttribs, DiffStats);
+    }
     m_pImmediateContext->UnmapTextureSubresource(Capture.pTexture, 0, 0);
     m_pScreenCapture->RecycleStagingTexture(std::move(Capture.pTexture));
 
-    auto* pGoldenImgPixels = reinterpret_cast<const Uint8*>(pGoldenImg->GetData()->GetDataPtr());
+    // The exit code is truncated to 8 bits by the shell, so only the verdict is returned and the number
+    // of mismatched pixels is logged
+    m_ExitCode = DiffStats.NumMismatchedPixels > 0 ? 1 : 0;
+    LOG_INFO_MESSAGE("Golden image comparison: ", DiffStats.NumMismatchedPixels, " mismatched pixels, max error: ", DiffStats.MaxError,
+                     ", mean error: ", DiffStats.MeanError, ", PSNR: ", DiffStats.PSNR, " dB");
 
-    m_ExitCode = 0;
-    for (Uint32 row = 0; row < TexDesc.Height; ++row)
+    if (m_bWriteGoldenImgDiff && DiffStats.NumMismatchedPixels > 0)
     {
-        for (Uint32 col = 0; col < TexDesc.Width; ++col)
+        auto DiffFileName = FileName;
+        auto ExtPos       = DiffFileName.find_last_of('.');
+        if (ExtPos != std::string::npos)
+            DiffFileName.erase(ExtPos);
+        DiffFileName += "_diff.png";
+
+        Image::EncodeInfo Info;
+        Info.Width      = TexDesc.Width;
+        Info.Height     = TexDesc.Height;
+        Info.TexFormat  = TEX_FORMAT_RGBA8_UNORM;
+        Info.KeepAlpha  = false;
+        Info.pData      = HeatMap.data();
+        Info.Stride     = TexDesc.Width * 4;
+        Info.FileFormat = EImageFileFormat::png;
+
+        RefCntAutoPtr<IDataBlob> pEncodedImage;
+        Image::Encode(Info, &pEncodedImage);
+
+        FileWrapper pFile(DiffFileName.c_str(), EFileAccessMode::Overwrite);
+        if (pFile && pEncodedImage && pFile->Write(pEncodedImage->GetDataPtr(), pEncodedImage->GetSize()))
+        {
+            LOG_INFO_MESSAGE("Golden image difference is saved to ", DiffFileName);
+        }
+        else
         {
-            const auto* SrcPixel = &CapturedPixels[(col + row * TexDesc.Width) * 3];
-            const auto* DstPixel = pGoldenImgPixels + row * GoldenImgDesc.RowStride + col * GoldenImgDesc.NumComponents;
-            if (std::abs(int{SrcPixel[0]} - int{DstPixel[0]}) > m_GoldenImgPixelTolerance ||
-                std::abs(int{SrcPixel[1]} - int{DstPixel[1]}) > m_GoldenImgPixelTolerance ||
-                std::abs(int{SrcPixel[2]} - int{DstPixel[2]}) > m_GoldenImgPixelTolerance)
-                ++m_ExitCode;
+            LOG_ERROR_MESSAGE("Failed to write golden image difference to ", DiffFileName);
         }
     }
 }
@@ -816,25 +1368,75 @@ void SampleApp::SaveScreenCapture(const std::string& FileName, ScreenCapture::Ca
     Info.FileFormat  = m_ScreenCaptureInfo.FileFormat;
     Info.JpegQuality = m_ScreenCaptureInfo.JpegQuality;
 
-    RefCntAutoPtr<IDataBlob> pEncodedImage;
-    Image::Encode(Info, &pEncodedImage);
+    // The writer copies the pixels, so the staging texture can be recycled right away.
+    // Encoding and file writes happen on the writer's worker threads.
+    m_pImageWriter->Enqueue(FileName, Info);
     m_pImmediateContext->UnmapTextureSubresource(Capture.pTexture, 0, 0);
     m_pScreenCapture->RecycleStagingTexture(std::move(Capture.pTexture));
+}
 
-    FileWrapper pFile(FileName.c_str(), EFileAccessMode::Overwrite);
-    if (pFile)
+// Command line example to record a video stream that can be encoded offline:
+//
+//     -mode vk -capture_path . -capture_name capture -capture_format y4m -capture_fps 60 -capture_frames 600
+//
+// Use "-capture_name -" to write the stream to the standard output, for example:
+//
+//     ... -capture_name - -capture_format y4m | ffmpeg -i - -c:v libx264 capture.mp4
+//
+void SampleApp::WriteVideoFrame(ScreenCapture::CaptureInfo& Capture)
+{
+    const auto& TexDesc = Capture.pTexture->GetDesc();
+    if (!m_pVideoStreamWriter)
     {
-        auto res = pFile->Write(pEncodedImage->GetDataPtr(), pEncodedImage->GetSize());
-        if (!res)
+        std::string FilePath;
+        if (m_ScreenCaptureInfo.FileName == "-")
         {
-            LOG_ERROR_MESSAGE("Failed to write screen capture file '", FileName, "'.");
+            FilePath = m_ScreenCaptureInfo.FileName;
+        }
+        else
+        {
+            std::stringstream FilePathSS;
+            if (!m_ScreenCaptureInfo.Directory.empty())
+            {
+                FilePathSS << m_ScreenCaptureInfo.Directory;
+                if (m_ScreenCaptureInfo.Directory.back() != '/')
+                    FilePathSS << '/';
+            }
+            FilePathSS << m_ScreenCaptureInfo.FileName;
+            FilePathSS << (m_ScreenCaptureInfo.StreamFormat == VideoStreamWriter::FORMAT::Y4M ? ".y4m" : ".rgba");
+            FilePath = FilePathSS.str();
+        }
+
+        try
+        {
+            m_pVideoStreamWriter.reset(new VideoStreamWriter{FilePath, m_ScreenCaptureInfo.StreamFormat, TexDesc.Width, TexDesc.Height, m_ScreenCaptureInfo.CaptureFPS});
+        }
+        catch (...)
+        {
+            LOG_ERROR_MESSAGE("Failed to create video stream. Video capture will be disabled.");
+            m_ScreenCaptureInfo.AllowCapture    = false;
+            m_ScreenCaptureInfo.FramesToCapture = 0;
         }
-        pFile.Close();
     }
-    else
+
+    if (m_pVideoStreamWriter)
     {
-        LOG_ERROR_MESSAGE("Failed to create screen capture file '", FileName, "'. Verify that the directory exists and the app has sufficient rights to write to this directory.");
+        if (TexDesc.Width == m_pVideoStreamWriter->GetWidth() && TexDesc.Height == m_pVideoStreamWriter->GetHeight())
+        {
+            // Convert the frame directly from the mapped staging texture into the stream
+            MappedTextureSubresource TexData;
+            m_pImmediateContext->MapTextureSubresource(Capture.pTexture, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, TexData);
+            m_pVideoStreamWriter->WriteFrame(TexData.pData, TexData.Stride, TexDesc.Format);
+            m_pImmediateContext->UnmapTextureSubresource(Capture.pTexture, 0, 0);
+        }
+        else
+        {
+            LOG_ERROR_MESSAGE("Frame size (", TexDesc.Width, "x", TexDesc.Height, ") does not match the video stream size (",
+                              m_pVideoStreamWriter->GetWidth(), "x", m_pVideoStreamWriter->GetHeight(), "). The frame is skipped.");
+        }
     }
+
+    m_pScreenCapture->RecycleStagingTexture(std::move(Capture.pTexture));
 }
 
 void SampleApp::Present()
@@ -842,6 +1444,10 @@ void SampleApp::Present()
     if (!m_pSwapChain)
         return;
 
+    CPU_PROFILER_SCOPE("Present");
+
+    const auto PresentStartTime = m_FrameTimer.GetElapsedTime();
+
     if (m_pScreenCapture && m_ScreenCaptureInfo.FramesToCapture > 0)
     {
         if (m_CurrentTime - m_ScreenCaptureInfo.LastCaptureTime >= 1.0 / m_ScreenCaptureInfo.CaptureFPS)
@@ -869,11 +1475,24 @@ void SampleApp::Present()
     }
 
     m_pSwapChain->Present(m_bVSync ? 1 : 0);
+    m_TheSample->PostPresent();
+
+    if (m_LatchedInputTime >= 0)
+    {
+        m_InputLatencyStats.AddFrame(InputControllerBase::GetEventTime() - m_LatchedInputTime);
+        m_LatchedInputTime = -1;
+    }
 
     if (m_pScreenCapture)
     {
         while (auto Capture = m_pScreenCapture->GetCapture())
         {
+            if (m_ScreenCaptureInfo.WriteVideoStream)
+            {
+                WriteVideoFrame(Capture);
+                continue;
+            }
+
             std::string FileName;
             {
                 std::stringstream FileNameSS;
@@ -902,6 +1521,17 @@ void SampleApp::Present()
             }
         }
     }
+
+    const auto FrameEndTime = m_FrameTimer.GetElapsedTime();
+    m_FrameTimings.Present  = FrameEndTime - PresentStartTime;
+    // The first frame has no predecessor, so only the time spent in the frame itself is known.
+    // Frame time is measured with the wall clock even when the sample is fed a fixed time step.
+    m_FrameTimings.Frame = m_LastFrameEndTime >= 0 ? FrameEndTime - m_LastFrameEndTime : m_FrameTimings.Total();
+    m_LastFrameEndTime   = FrameEndTime;
+
+    m_FrameStats.AddFrame(m_FrameTimings.Frame);
+    if (m_pBenchmark)
+        m_pBenchmark->AddFrame(m_FrameTimings);
 }
 
 } // namespace Diligent
@@ -25,8 +25,11 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
+
 #include "PlatformDefinitions.h"
 #include "SampleBase.hpp"
+#include "CPUProfiler.hpp"
 #include "Errors.hpp"
 
 namespace Diligent
@@ -95,4 +98,104 @@ void SampleBase::GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType, E
     }
 }
 
+void SampleBase::SetNumWorkerThreads(Uint32 NumWorkerThreads)
+{
+    if (NumWorkerThreads > GetMaxWorkerThreads())
+    {
+        LOG_WARNING_MESSAGE("The number of worker threads is limited to ", GetMaxWorkerThreads(), " by the number of deferred contexts");
+        NumWorkerThreads = GetMaxWorkerThreads();
+    }
+
+    m_pJobSystem.reset();
+    m_pJobSystem.reset(new JobSystem{NumWorkerThreads});
+}
+
+void SampleBase::RecordCommandsInParallel(Uint32 NumItems, const RecordCommandsFunction& RecordCommands)
+{
+    if (!m_pJobSystem || m_pJobSystem->GetNumWorkerThreads() == 0)
+    {
+        CPU_PROFILER_SCOPE("RecordSubset");
+        RecordCommands(m_pImmediateContext, 0, 0, NumItems);
+        return;
+    }
+
+    RecordCommandLists(NumItems, RecordCommands, m_WorkerCmdLists);
+
+    {
+        CPU_PROFILER_SCOPE("ExecuteCommandLists");
+        for (auto& pCmdList : m_WorkerCmdLists)
+        {
+            m_pImmediateContext->ExecuteCommandList(pCmdList);
+            // Release command lists now to release all outstanding references
+            // In d3d11 mode, command lists hold references to the swap chain's back buffer
+            // that cause swap chain resize to fail
+            pCmdList.Release();
+        }
+    }
+
+    // IMPORTANT: we must wait until the command lists are submitted for execution
+    // because FinishFrame() invalidates all dynamic resources.
+    FinishWorkerContextFrames();
+}
+
+void SampleBase::RecordCommandLists(Uint32 NumItems, const RecordCommandsFunction& RecordCommands, std::vector<RefCntAutoPtr<ICommandList>>& CmdLists)
+{
+    BeginRecordCommandLists(NumItems, RecordCommands, CmdLists);
+    WaitForCommandLists();
+}
+
+void SampleBase::BeginRecordCommandLists(Uint32 NumItems, RecordCommandsFunction RecordCommands, std::vector<RefCntAutoPtr<ICommandList>>& CmdLists)
+{
+    VERIFY(m_pJobSystem, "Job system has not been created");
+    VERIFY(!m_pDeferredContexts.empty(), "Command lists can only be recorded by deferred contexts");
+
+    const auto NumThreads = m_pJobSystem->GetNumThreads();
+    const auto MaxChunks  = NumThreads * CommandListChunksPerThread;
+    const auto ChunkSize  = std::max((NumItems + MaxChunks - 1) / MaxChunks, 1u);
+    const auto NumChunks  = (NumItems + ChunkSize - 1) / ChunkSize;
+    CmdLists.clear();
+    CmdLists.resize(NumChunks);
+
+    // The chunks may be recorded after the method returns, so everything the function uses is captured by value
+    auto* pCmdLists   = CmdLists.data();
+    auto  RecordChunk = [this, RecordCommands, pCmdLists, ChunkSize](Uint32 First, Uint32 Last, Uint32 ThreadIdx) {
+        CPU_PROFILER_SCOPE("RecordSubset");
+
+        // Every thread uses its own deferred context
+        auto* pDeferredCtx = GetWorkerContext(ThreadIdx);
+        RecordCommands(pDeferredCtx, 1 + ThreadIdx, First, Last);
+        pDeferredCtx->FinishCommandList(&pCmdLists[First / ChunkSize]);
+    };
+    m_pJobSystem->ParallelForAsync(NumItems, ChunkSize, std::move(RecordChunk));
+}
+
+void SampleBase::WaitForCommandLists()
+{
+    if (m_pJobSystem)
+        m_pJobSystem->Wait();
+}
+
+void SampleBase::FinishWorkerContextFrames()
+{
+    // Call FinishFrame() to release dynamic resources allocated by deferred contexts
+    const auto NumThreads = m_pJobSystem ? m_pJobSystem->GetNumThreads() : 0;
+    for (Uint32 ThreadIdx = 0; ThreadIdx < NumThreads; ++ThreadIdx)
+        GetWorkerContext(ThreadIdx)->FinishFrame();
+}
+
+void SampleBase::UpdateCameraPose(double CurrTime, CameraPose& Pose)
+{
+    if (m_pCameraPath == nullptr)
+        return;
+
+    if (m_CameraPathStartTime < 0)
+        m_CameraPathStartTime = CurrTime;
+
+    const auto PathTime = CurrTime - m_CameraPathStartTime;
+    if (m_bRecordCameraPath)
+        m_pCameraPath->Record(PathTime, Pose);
+    else
+        Pose = m_pCameraPath->Evaluate(PathTime);
+}
+
 } // namespace Diligent
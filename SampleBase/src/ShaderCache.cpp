@@ -0,0 +1,348 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+#include "ShaderCache.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "Timer.hpp"
+#include "Errors.hpp"
+#include "CPUProfiler.hpp"
+
+#if VULKAN_SUPPORTED
+#    include "ShaderVk.h"
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Every cache file starts with this header followed by the bytecode.
+// The version must be incremented whenever the file format or the hashed data change.
+struct CacheFileHeader
+{
+    Uint32 Magic   = 0;
+    Uint32 Version = 0;
+    Uint64 Hash    = 0;
+    Uint64 Size    = 0;
+};
+
+static constexpr Uint32 CacheFileMagic   = 0x43485344; // "DSHC"
+static constexpr Uint32 CacheFileVersion = 1;
+
+// 64-bit FNV-1a hash. Unlike std::hash, it produces the same values in every run and on every platform.
+class FNV1aHasher
+{
+public:
+    void Update(const void* pData, size_t Size)
+    {
+        const auto* pBytes = static_cast<const Uint8*>(pData);
+        for (size_t i = 0; i < Size; ++i)
+        {
+            m_Hash ^= pBytes[i];
+            m_Hash *= 0x100000001B3ull;
+        }
+    }
+
+    // The terminating null is hashed too so that consecutive strings are separated
+    void Update(const Char* Str)
+    {
+        if (Str == nullptr)
+            Str = "";
+        Update(Str, strlen(Str) + 1);
+    }
+
+    template <typename T>
+    void UpdateValue(const T& Value)
+    {
+        Update(&Value, sizeof(Value));
+    }
+
+    Uint64 Get() const { return m_Hash; }
+
+private:
+    Uint64 m_Hash = 0xCBF29CE484222325ull;
+};
+
+bool ReadSourceFile(IShaderSourceInputStreamFactory* pFactory, const Char* FilePath, std::string& Source)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    pFactory->CreateInputStream(FilePath, &pStream);
+    if (!pStream)
+        return false;
+
+    Source.resize(pStream->GetSize());
+    return Source.empty() || pStream->Read(&Source[0], Source.size());
+}
+
+// Hashes the source and, recursively, all files it includes. Include directives are found by a simple
+// scan that ignores comments and conditional compilation, which at worst hashes more files than necessary.
+void HashSource(const std::string&               Source,
+                IShaderSourceInputStreamFactory* pFactory,
+                std::unordered_set<std::string>& VisitedFiles,
+                FNV1aHasher&                     Hasher)
+{
+    Hasher.Update(Source.data(), Source.size());
+    if (pFactory == nullptr)
+        return;
+
+    static constexpr char IncludeDirective[] = "include";
+
+    size_t Pos = 0;
+    while ((Pos = Source.find('#', Pos)) != std::string::npos)
+    {
+        ++Pos;
+        Pos = Source.find_first_not_of(" \t", Pos);
+        if (Pos == std::string::npos || Source.compare(Pos, sizeof(IncludeDirective) - 1, IncludeDirective) != 0)
+            continue;
+
+        Pos = Source.find_first_not_of(" \t", Pos + sizeof(IncludeDirective) - 1);
+        if (Pos == std::string::npos || (Source[Pos] != '"' && Source[Pos] != '<'))
+            continue;
+
+        const auto NameEnd = Source.find_first_of(Source[Pos] == '"' ? "\"\n" : ">\n", Pos + 1);
+        if (NameEnd == std::string::npos || Source[NameEnd] == '\n')
+            continue;
+
+        std::string IncludeName = Source.substr(Pos + 1, NameEnd - Pos - 1);
+        Pos                     = NameEnd + 1;
+        if (!VisitedFiles.insert(IncludeName).second)
+            continue;
+
+        // Files that cannot be loaded through the factory, e.g. built-in engine headers,
+        // only contribute their names to the hash
+        Hasher.Update(IncludeName.c_str());
+        std::string IncludeSource;
+        if (ReadSourceFile(pFactory, IncludeName.c_str(), IncludeSource))
+            HashSource(IncludeSource, pFactory, VisitedFiles, Hasher);
+    }
+}
+
+bool GetShaderByteCode(IShader* pShader, std::vector<Uint8>& ByteCode)
+{
+#if VULKAN_SUPPORTED
+    RefCntAutoPtr<IShaderVk> pShaderVk{pShader, IID_ShaderVk};
+    if (pShaderVk)
+    {
+        const auto& SPIRV  = pShaderVk->GetSPIRV();
+        const auto* pBytes = reinterpret_cast<const Uint8*>(SPIRV.data());
+        ByteCode.assign(pBytes, pBytes + SPIRV.size() * sizeof(SPIRV[0]));
+        return !ByteCode.empty();
+    }
+#endif
+
+    return false;
+}
+
+} // namespace
+
+ShaderCache::ShaderCache(IRenderDevice* pDevice, std::string Directory) :
+    m_pDevice{pDevice},
+    m_Directory{std::move(Directory)}
+{
+    if (m_Directory.empty())
+        return;
+
+    if (m_pDevice->GetDeviceCaps().DevType != RENDER_DEVICE_TYPE_VULKAN)
+    {
+        LOG_WARNING_MESSAGE("Compiled shader bytecode is only available in Vulkan. Shader cache is disabled.");
+        m_Directory.clear();
+        return;
+    }
+
+    if (!FileSystem::PathExists(m_Directory.c_str()) && !FileSystem::CreateDirectory(m_Directory.c_str()))
+    {
+        LOG_ERROR_MESSAGE("Failed to create shader cache directory '", m_Directory, "'. Shader cache is disabled.");
+        m_Directory.clear();
+        return;
+    }
+
+    if (m_Directory.back() != '/' && m_Directory.back() != '\\')
+        m_Directory.push_back('/');
+}
+
+void ShaderCache::CreateShader(const ShaderCreateInfo& ShaderCI, IShader** ppShader)
+{
+    CPU_PROFILER_SCOPE("CreateShader");
+
+    Timer timer;
+
+    Uint64 Hash = 0;
+    if (!IsEnabled() || ShaderCI.ByteCode != nullptr || !ComputeHash(ShaderCI, Hash))
+    {
+        m_pDevice->CreateShader(ShaderCI, ppShader);
+        ++m_Stats.Uncached;
+        m_Stats.CreationTime += timer.GetElapsedTime();
+        return;
+    }
+
+    const auto FilePath = GetCacheFilePath(Hash);
+
+    std::vector<Uint8> ByteCode;
+    if (LoadByteCode(FilePath, Hash, ByteCode))
+    {
+        auto CachedShaderCI                       = ShaderCI;
+        CachedShaderCI.FilePath                   = nullptr;
+        CachedShaderCI.Source                     = nullptr;
+        CachedShaderCI.pShaderSourceStreamFactory = nullptr;
+        CachedShaderCI.Macros                     = nullptr;
+        CachedShaderCI.ByteCode                   = ByteCode.data();
+        CachedShaderCI.ByteCodeSize               = ByteCode.size();
+        m_pDevice->CreateShader(CachedShaderCI, ppShader);
+        if (*ppShader != nullptr)
+        {
+            ++m_Stats.Hits;
+            m_Stats.CreationTime += timer.GetElapsedTime();
+            return;
+        }
+
+        LOG_WARNING_MESSAGE("Failed to create shader '", (ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : ""),
+                            "' from cached bytecode. The shader will be recompiled.");
+    }
+
+    m_pDevice->CreateShader(ShaderCI, ppShader);
+    if (*ppShader != nullptr && GetShaderByteCode(*ppShader, ByteCode))
+    {
+        StoreByteCode(FilePath, Hash, ByteCode);
+        ++m_Stats.Misses;
+    }
+    else
+    {
+        ++m_Stats.Uncached;
+    }
+    m_Stats.CreationTime += timer.GetElapsedTime();
+}
+
+bool ShaderCache::ComputeHash(const ShaderCreateInfo& ShaderCI, Uint64& Hash) const
+{
+    FNV1aHasher Hasher;
+    Hasher.UpdateValue(CacheFileVersion);
+    Hasher.UpdateValue(m_pDevice->GetDeviceCaps().DevType);
+    Hasher.UpdateValue(ShaderCI.Desc.ShaderType);
+    Hasher.UpdateValue(ShaderCI.SourceLanguage);
+    Hasher.Update(ShaderCI.EntryPoint);
+    Hasher.UpdateValue(ShaderCI.UseCombinedTextureSamplers);
+    Hasher.Update(ShaderCI.CombinedSamplerSuffix);
+    for (const auto* pMacro = ShaderCI.Macros; pMacro != nullptr && pMacro->Name != nullptr; ++pMacro)
+    {
+        Hasher.Update(pMacro->Name);
+        Hasher.Update(pMacro->Definition);
+    }
+
+    std::unordered_set<std::string> VisitedFiles;
+    if (ShaderCI.Source != nullptr)
+    {
+        HashSource(ShaderCI.Source, ShaderCI.pShaderSourceStreamFactory, VisitedFiles, Hasher);
+    }
+    else if (ShaderCI.FilePath != nullptr && ShaderCI.pShaderSourceStreamFactory != nullptr)
+    {
+        std::string Source;
+        if (!ReadSourceFile(ShaderCI.pShaderSourceStreamFactory, ShaderCI.FilePath, Source))
+            return false;
+
+        VisitedFiles.insert(ShaderCI.FilePath);
+        HashSource(Source, ShaderCI.pShaderSourceStreamFactory, VisitedFiles, Hasher);
+    }
+    else
+    {
+        return false;
+    }
+
+    Hash = Hasher.Get();
+    return true;
+}
+
+std::string ShaderCache::GetCacheFilePath(Uint64 Hash) const
+{
+    std::stringstream ss;
+    ss << m_Directory << std::hex << std::setw(16) << std::setfill('0') << Hash << ".bin";
+    return ss.str();
+}
+
+bool ShaderCache::LoadByteCode(const std::string& FilePath, Uint64 Hash, std::vector<Uint8>& ByteCode) const
+{
+    if (!FileSystem::FileExists(FilePath.c_str()))
+        return false;
+
+    FileWrapper pFile(FilePath.c_str(), EFileAccessMode::Read);
+    if (!pFile)
+        return false;
+
+    CacheFileHeader Header;
+
+    const auto FileSize = pFile->GetSize();
+    if (FileSize < sizeof(Header) || !pFile->Read(&Header, sizeof(Header)) ||
+        Header.Magic != CacheFileMagic || Header.Version != CacheFileVersion || Header.Hash != Hash ||
+        Header.Size == 0 || Header.Size != FileSize - sizeof(Header))
+    {
+        LOG_WARNING_MESSAGE("Shader cache file '", FilePath, "' is invalid and will be overwritten.");
+        return false;
+    }
+
+    ByteCode.resize(static_cast<size_t>(Header.Size));
+    if (!pFile->Read(ByteCode.data(), ByteCode.size()))
+    {
+        LOG_WARNING_MESSAGE("Failed to read shader cache file '", FilePath, "'.");
+        return false;
+    }
+
+    return true;
+}
+
+void ShaderCache::StoreByteCode(const std::string& FilePath, Uint64 Hash, const std::vector<Uint8>& ByteCode) const
+{
+    FileWrapper pFile(FilePath.c_str(), EFileAccessMode::Overwrite);
+    if (!pFile)
+    {
+        LOG_WARNING_MESSAGE("Failed to create shader cache file '", FilePath, "'.");
+        return;
+    }
+
+    CacheFileHeader Header;
+    Header.Magic   = CacheFileMagic;
+    Header.Version = CacheFileVersion;
+    Header.Hash    = Hash;
+    Header.Size    = ByteCode.size();
+    if (!pFile->Write(&Header, sizeof(Header)) || !pFile->Write(ByteCode.data(), ByteCode.size()))
+    {
+        LOG_WARNING_MESSAGE("Failed to write shader cache file '", FilePath, "'.");
+    }
+}
+
+void ShaderCache::LogStatistics() const
+{
+    LOG_INFO_MESSAGE("Shader cache: ", m_Stats.Hits, " hits, ", m_Stats.Misses, " misses, ", m_Stats.Uncached,
+                     " shaders not cached. Shader creation took ", m_Stats.CreationTime * 1000.0, " ms");
+}
+
+} // namespace Diligent
@@ -0,0 +1,595 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "PlatformDefinitions.h"
+#include "VideoStreamWriter.hpp"
+#include "Errors.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define VIDEO_STREAM_USE_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define VIDEO_STREAM_USE_SSE2 0
+#endif
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <Windows.h>
+#    include <io.h>
+#    include <fcntl.h>
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+// Memory mapping requires posix_fallocate(), which is not available on Apple platforms
+#    define VIDEO_STREAM_USE_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace Diligent
+{
+
+class VideoStreamWriter::IOutput
+{
+public:
+    virtual ~IOutput() {}
+
+    // Returns a pointer to Size bytes at the current stream position that remains valid until Commit()
+    virtual Uint8* Reserve(size_t Size) = 0;
+
+    // Appends Size bytes previously returned by Reserve() to the stream
+    virtual bool Commit(size_t Size) = 0;
+};
+
+namespace
+{
+
+// Writes the stream through a FILE handle. Used for pipes and the standard output.
+class BufferedOutput final : public VideoStreamWriter::IOutput
+{
+public:
+    BufferedOutput(FILE* pFile, bool OwnsFile) :
+        m_pFile{pFile},
+        m_OwnsFile{OwnsFile}
+    {}
+
+    ~BufferedOutput()
+    {
+        if (m_OwnsFile)
+            fclose(m_pFile);
+        else
+            fflush(m_pFile);
+    }
+
+    virtual Uint8* Reserve(size_t Size) override final
+    {
+        if (m_Buffer.size() < Size)
+            m_Buffer.resize(Size);
+        return m_Buffer.data();
+    }
+
+    virtual bool Commit(size_t Size) override final
+    {
+        return fwrite(m_Buffer.data(), 1, Size, m_pFile) == Size;
+    }
+
+private:
+    FILE* const        m_pFile;
+    const bool         m_OwnsFile;
+    std::vector<Uint8> m_Buffer;
+};
+
+#if PLATFORM_WIN32 || VIDEO_STREAM_USE_MMAP
+
+// Writes the stream through memory-mapped views of a regular file. The file is grown
+// in large chunks and truncated to the actual stream size when the output is closed.
+// The disk space of every chunk is allocated before it is mapped, since writing to a mapped page
+// that has no space on the disk raises a signal rather than an error. If the space can't be
+// allocated, the rest of the stream is written through a FILE handle.
+class MappedFileOutput final : public VideoStreamWriter::IOutput
+{
+public:
+    static constexpr Uint64 ChunkSize = Uint64{64} << 20;
+
+    ~MappedFileOutput()
+    {
+        UnmapView();
+#    if PLATFORM_WIN32
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER EndOfFile;
+            EndOfFile.QuadPart = static_cast<LONGLONG>(m_WriteOffset);
+            SetFilePointerEx(m_hFile, EndOfFile, nullptr, FILE_BEGIN);
+            SetEndOfFile(m_hFile);
+            CloseHandle(m_hFile);
+        }
+#    else
+        // The fallback output owns the file descriptor
+        m_pFallbackOutput.reset();
+        if (m_fd >= 0)
+        {
+            if (ftruncate(m_fd, static_cast<off_t>(m_WriteOffset)) != 0)
+                LOG_ERROR_MESSAGE("Failed to truncate video stream file");
+            close(m_fd);
+        }
+#    endif
+    }
+
+    // Returns false if the path is not a regular file or can't be opened for mapping
+    bool Open(const char* Path)
+    {
+#    if PLATFORM_WIN32
+        m_hFile = CreateFileA(Path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+            return false;
+        if (GetFileType(m_hFile) != FILE_TYPE_DISK)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        SYSTEM_INFO SysInfo;
+        GetSystemInfo(&SysInfo);
+        m_Granularity = SysInfo.dwAllocationGranularity;
+#    else
+        m_fd = open(Path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0)
+            return false;
+        struct stat Stat;
+        if (fstat(m_fd, &Stat) != 0 || !S_ISREG(Stat.st_mode))
+        {
+            close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        m_Granularity = static_cast<Uint64>(sysconf(_SC_PAGESIZE));
+#    endif
+        return true;
+    }
+
+    virtual Uint8* Reserve(size_t Size) override final
+    {
+#    if VIDEO_STREAM_USE_MMAP
+        if (m_pFallbackOutput)
+            return m_pFallbackOutput->Reserve(Size);
+#    endif
+
+        if (m_pView != nullptr && m_WriteOffset + Size <= m_ViewOffset + m_ViewSize)
+            return m_pView + (m_WriteOffset - m_ViewOffset);
+
+        UnmapView();
+
+        // Views must start at a multiple of the allocation granularity
+        m_ViewOffset = m_WriteOffset - m_WriteOffset % m_Granularity;
+        m_ViewSize   = std::max(ChunkSize, m_WriteOffset - m_ViewOffset + Size);
+        m_ViewSize   = (m_ViewSize + m_Granularity - 1) / m_Granularity * m_Granularity;
+
+#    if PLATFORM_WIN32
+        // Creating the mapping grows the file to the requested size and allocates its disk space
+        const Uint64 FileSize = m_ViewOffset + m_ViewSize;
+        m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READWRITE, static_cast<DWORD>(FileSize >> 32), static_cast<DWORD>(FileSize & 0xFFFFFFFFu), nullptr);
+        if (m_hMapping == nullptr)
+            return nullptr;
+        m_pView = static_cast<Uint8*>(MapViewOfFile(m_hMapping, FILE_MAP_WRITE, static_cast<DWORD>(m_ViewOffset >> 32), static_cast<DWORD>(m_ViewOffset & 0xFFFFFFFFu), static_cast<SIZE_T>(m_ViewSize)));
+        if (m_pView == nullptr)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+            return nullptr;
+        }
+#    else
+        // Unlike ftruncate(), posix_fallocate() allocates the blocks, so the file is not sparse
+        const auto Err = posix_fallocate(m_fd, static_cast<off_t>(m_ViewOffset), static_cast<off_t>(m_ViewSize));
+        if (Err != 0)
+        {
+            LOG_WARNING_MESSAGE("Failed to allocate ", m_ViewSize >> 20, " MB for the video stream (error ", Err, "). The rest of the stream will be written without memory mapping.");
+            return StartFallbackOutput() ? m_pFallbackOutput->Reserve(Size) : nullptr;
+        }
+        auto* pView = mmap(nullptr, static_cast<size_t>(m_ViewSize), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(m_ViewOffset));
+        if (pView == MAP_FAILED)
+            return nullptr;
+        m_pView = static_cast<Uint8*>(pView);
+#    endif
+        return m_pView + (m_WriteOffset - m_ViewOffset);
+    }
+
+    virtual bool Commit(size_t Size) override final
+    {
+#    if VIDEO_STREAM_USE_MMAP
+        if (m_pFallbackOutput)
+            return m_pFallbackOutput->Commit(Size);
+#    endif
+
+        VERIFY_EXPR(m_pView != nullptr && m_WriteOffset + Size <= m_ViewOffset + m_ViewSize);
+        m_WriteOffset += Size;
+        return true;
+    }
+
+private:
+    void UnmapView()
+    {
+        if (m_pView == nullptr)
+            return;
+#    if PLATFORM_WIN32
+        UnmapViewOfFile(m_pView);
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+#    else
+        munmap(m_pView, static_cast<size_t>(m_ViewSize));
+#    endif
+        m_pView = nullptr;
+    }
+
+#    if VIDEO_STREAM_USE_MMAP
+    bool StartFallbackOutput()
+    {
+        // Drop the space beyond the written data and continue writing at the end of the file
+        if (ftruncate(m_fd, static_cast<off_t>(m_WriteOffset)) != 0 || lseek(m_fd, 0, SEEK_END) < 0)
+            return false;
+        FILE* pFile = fdopen(m_fd, "wb");
+        if (pFile == nullptr)
+            return false;
+        m_fd = -1;
+        m_pFallbackOutput.reset(new BufferedOutput{pFile, true});
+        return true;
+    }
+#    endif
+
+#    if PLATFORM_WIN32
+    HANDLE m_hFile    = INVALID_HANDLE_VALUE;
+    HANDLE m_hMapping = nullptr;
+#    else
+    int                             m_fd = -1;
+    std::unique_ptr<BufferedOutput> m_pFallbackOutput;
+#    endif
+
+    Uint64 m_Granularity = 4096;
+    Uint8* m_pView       = nullptr;
+    Uint64 m_ViewOffset  = 0;
+    Uint64 m_ViewSize    = 0;
+    Uint64 m_WriteOffset = 0;
+};
+
+#endif
+
+// Full-range BT.601 (JPEG) conversion coefficients in 8.8 fixed point
+// clang-format off
+constexpr int YR =  77, YG =  150, YB =  29;
+constexpr int UR = -43, UG = -85,  UB =  128;
+constexpr int VR = 128, VG = -107, VB = -21;
+// clang-format on
+
+inline Uint8 ClampToUint8(int Val)
+{
+    return static_cast<Uint8>(std::min(std::max(Val, 0), 255));
+}
+
+// Channel offsets of red and blue components in the source pixels
+struct ChannelOrder
+{
+    int R;
+    int B;
+};
+
+#if VIDEO_STREAM_USE_SSE2
+
+inline __m128i CoeffsToM128i(int CR, int CG, int CB, const ChannelOrder& Order)
+{
+    alignas(16) Int16 Coeffs[4] = {};
+    Coeffs[Order.R]             = static_cast<Int16>(CR);
+    Coeffs[1]                   = static_cast<Int16>(CG);
+    Coeffs[Order.B]             = static_cast<Int16>(CB);
+    return _mm_setr_epi16(Coeffs[0], Coeffs[1], Coeffs[2], Coeffs[3], Coeffs[0], Coeffs[1], Coeffs[2], Coeffs[3]);
+}
+
+// Computes (C0 * c0 + C1 * c1 + C2 * c2 + 128) >> 8 for four 8-bit 4-component pixels
+inline __m128i Dot4(__m128i Pixels, __m128i Coeffs)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    // Every 32-bit lane contains the sum of two products
+    __m128i Lo = _mm_madd_epi16(_mm_unpacklo_epi8(Pixels, Zero), Coeffs);
+    __m128i Hi = _mm_madd_epi16(_mm_unpackhi_epi8(Pixels, Zero), Coeffs);
+    // Gather even and odd lanes and add them together
+    __m128 Even = _mm_shuffle_ps(_mm_castsi128_ps(Lo), _mm_castsi128_ps(Hi), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 Odd  = _mm_shuffle_ps(_mm_castsi128_ps(Lo), _mm_castsi128_ps(Hi), _MM_SHUFFLE(3, 1, 3, 1));
+    __m128i Sum = _mm_add_epi32(_mm_castps_si128(Even), _mm_castps_si128(Odd));
+    return _mm_srai_epi32(_mm_add_epi32(Sum, _mm_set1_epi32(128)), 8);
+}
+
+#endif
+
+void ConvertRowToLuma(const Uint8* pSrc, Uint8* pDstY, Uint32 Width, const ChannelOrder& Order)
+{
+    Uint32 x = 0;
+#if VIDEO_STREAM_USE_SSE2
+    const __m128i YCoeffs = CoeffsToM128i(YR, YG, YB, Order);
+    for (; x + 16 <= Width; x += 16)
+    {
+        const auto* pSrcPixels = reinterpret_cast<const __m128i*>(pSrc + x * 4);
+
+        __m128i Y0 = Dot4(_mm_loadu_si128(pSrcPixels + 0), YCoeffs);
+        __m128i Y1 = Dot4(_mm_loadu_si128(pSrcPixels + 1), YCoeffs);
+        __m128i Y2 = Dot4(_mm_loadu_si128(pSrcPixels + 2), YCoeffs);
+        __m128i Y3 = Dot4(_mm_loadu_si128(pSrcPixels + 3), YCoeffs);
+
+        __m128i Y = _mm_packus_epi16(_mm_packs_epi32(Y0, Y1), _mm_packs_epi32(Y2, Y3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstY + x), Y);
+    }
+#endif
+    for (; x < Width; ++x)
+    {
+        const Uint8* Pixel = pSrc + x * 4;
+        pDstY[x]           = ClampToUint8((YR * Pixel[Order.R] + YG * Pixel[1] + YB * Pixel[Order.B] + 128) >> 8);
+    }
+}
+
+// Converts two rows of pixels into one row of 2x2-subsampled chroma samples
+void ConvertRowsToChroma(const Uint8* pSrc0, const Uint8* pSrc1, Uint8* pDstU, Uint8* pDstV, Uint32 Width, const ChannelOrder& Order)
+{
+    const Uint32 ChromaWidth = (Width + 1) / 2;
+
+    Uint32 cx = 0;
+#if VIDEO_STREAM_USE_SSE2
+    const __m128i UCoeffs = CoeffsToM128i(UR, UG, UB, Order);
+    const __m128i VCoeffs = CoeffsToM128i(VR, VG, VB, Order);
+    const __m128i Offset  = _mm_set1_epi32(128);
+
+    auto Average2x2 = [&](Uint32 x) {
+        // Average the rows, then average horizontally adjacent pixels
+        __m128i A = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc0 + x * 4)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc1 + x * 4)));
+        __m128i B = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc0 + x * 4 + 16)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc1 + x * 4 + 16)));
+
+        __m128 Even = _mm_shuffle_ps(_mm_castsi128_ps(A), _mm_castsi128_ps(B), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 Odd  = _mm_shuffle_ps(_mm_castsi128_ps(A), _mm_castsi128_ps(B), _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_avg_epu8(_mm_castps_si128(Even), _mm_castps_si128(Odd));
+    };
+
+    for (; cx * 2 + 16 <= Width; cx += 8)
+    {
+        __m128i C0 = Average2x2(cx * 2);
+        __m128i C1 = Average2x2(cx * 2 + 8);
+
+        __m128i U = _mm_packs_epi32(_mm_add_epi32(Dot4(C0, UCoeffs), Offset), _mm_add_epi32(Dot4(C1, UCoeffs), Offset));
+        __m128i V = _mm_packs_epi32(_mm_add_epi32(Dot4(C0, VCoeffs), Offset), _mm_add_epi32(Dot4(C1, VCoeffs), Offset));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDstU + cx), _mm_packus_epi16(U, U));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDstV + cx), _mm_packus_epi16(V, V));
+    }
+#endif
+    for (; cx < ChromaWidth; ++cx)
+    {
+        const Uint32 x0 = cx * 2;
+        const Uint32 x1 = std::min(x0 + 1, Width - 1);
+
+        int Sum[4] = {};
+        for (int c = 0; c < 4; ++c)
+            Sum[c] = (pSrc0[x0 * 4 + c] + pSrc0[x1 * 4 + c] + pSrc1[x0 * 4 + c] + pSrc1[x1 * 4 + c] + 2) >> 2;
+
+        pDstU[cx] = ClampToUint8(((UR * Sum[Order.R] + UG * Sum[1] + UB * Sum[Order.B] + 128) >> 8) + 128);
+        pDstV[cx] = ClampToUint8(((VR * Sum[Order.R] + VG * Sum[1] + VB * Sum[Order.B] + 128) >> 8) + 128);
+    }
+}
+
+void ConvertRowToRGBA(const Uint8* pSrc, Uint8* pDst, Uint32 Width, const ChannelOrder& Order)
+{
+    if (Order.R == 0)
+    {
+        memcpy(pDst, pSrc, size_t{Width} * 4);
+        return;
+    }
+
+    // Swap red and blue channels
+    Uint32 x = 0;
+#if VIDEO_STREAM_USE_SSE2
+    const __m128i GAMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+    const __m128i RBMask = _mm_set1_epi32(0x000000FF);
+    for (; x + 4 <= Width; x += 4)
+    {
+        __m128i Pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x * 4));
+
+        __m128i Swapped = _mm_or_si128(_mm_and_si128(Pixels, GAMask),
+                                       _mm_or_si128(_mm_and_si128(_mm_srli_epi32(Pixels, 16), RBMask),
+                                                    _mm_slli_epi32(_mm_and_si128(Pixels, RBMask), 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 4), Swapped);
+    }
+#endif
+    for (; x < Width; ++x)
+    {
+        pDst[x * 4 + 0] = pSrc[x * 4 + 2];
+        pDst[x * 4 + 1] = pSrc[x * 4 + 1];
+        pDst[x * 4 + 2] = pSrc[x * 4 + 0];
+        pDst[x * 4 + 3] = pSrc[x * 4 + 3];
+    }
+}
+
+bool GetChannelOrder(TEXTURE_FORMAT Format, ChannelOrder& Order)
+{
+    switch (Format)
+    {
+        case TEX_FORMAT_RGBA8_UNORM:
+        case TEX_FORMAT_RGBA8_UNORM_SRGB:
+            Order = ChannelOrder{0, 2};
+            return true;
+
+        case TEX_FORMAT_BGRA8_UNORM:
+        case TEX_FORMAT_BGRA8_UNORM_SRGB:
+            Order = ChannelOrder{2, 0};
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+VideoStreamWriter::VideoStreamWriter(const std::string& FilePath,
+                                     FORMAT             Format,
+                                     Uint32             Width,
+                                     Uint32             Height,
+                                     double             FrameRate) :
+    // clang-format off
+    m_Format{Format},
+    m_Width {Width},
+    m_Height{Height}
+// clang-format on
+{
+    if (FilePath == "-")
+    {
+#if PLATFORM_WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        m_pOutput.reset(new BufferedOutput{stdout, false});
+    }
+    else
+    {
+#if PLATFORM_WIN32 || VIDEO_STREAM_USE_MMAP
+        std::unique_ptr<MappedFileOutput> pMappedOutput{new MappedFileOutput};
+        if (pMappedOutput->Open(FilePath.c_str()))
+            m_pOutput = std::move(pMappedOutput);
+#endif
+        if (!m_pOutput)
+        {
+            // Not a regular file (e.g. a named pipe) or memory mapping is not available
+            FILE* pFile = fopen(FilePath.c_str(), "wb");
+            if (pFile == nullptr)
+            {
+                LOG_ERROR_AND_THROW("Failed to open video stream file '", FilePath, "'. Verify that the directory exists and the app has sufficient rights to write to this directory.");
+            }
+            m_pOutput.reset(new BufferedOutput{pFile, true});
+        }
+    }
+
+    if (m_Format == FORMAT::Y4M)
+    {
+        // Express the frame rate as a ratio with millihertz precision
+        const auto FrameRateNum = static_cast<Uint32>(std::max(std::round(FrameRate * 1000.0), 1.0));
+
+        char Header[128];
+        const auto HeaderLen = snprintf(Header, sizeof(Header), "YUV4MPEG2 W%u H%u F%u:1000 Ip A1:1 C420jpeg\n", m_Width, m_Height, FrameRateNum);
+        VERIFY_EXPR(HeaderLen > 0 && static_cast<size_t>(HeaderLen) < sizeof(Header));
+
+        auto* pDst = m_pOutput->Reserve(HeaderLen);
+        if (pDst == nullptr)
+            LOG_ERROR_AND_THROW("Failed to write video stream header");
+        memcpy(pDst, Header, HeaderLen);
+        m_pOutput->Commit(HeaderLen);
+    }
+}
+
+VideoStreamWriter::~VideoStreamWriter()
+{
+}
+
+bool VideoStreamWriter::WriteFrame(const void* pData, Uint32 Stride, TEXTURE_FORMAT Format)
+{
+    ChannelOrder Order;
+    if (!GetChannelOrder(Format, Order))
+    {
+        LOG_ERROR_MESSAGE("Video stream capture only supports RGBA8 and BGRA8 formats");
+        return false;
+    }
+
+    const auto* pSrc = static_cast<const Uint8*>(pData);
+
+    if (m_Format == FORMAT::Y4M)
+    {
+        static constexpr char   FrameHeader[]   = "FRAME\n";
+        static constexpr size_t FrameHeaderSize = sizeof(FrameHeader) - 1;
+
+        const size_t LumaSize    = size_t{m_Width} * size_t{m_Height};
+        const size_t ChromaWidth = (m_Width + 1) / 2;
+        const size_t ChromaSize  = ChromaWidth * ((m_Height + 1) / 2);
+        const size_t FrameSize   = FrameHeaderSize + LumaSize + ChromaSize * 2;
+
+        auto* pDst = m_pOutput->Reserve(FrameSize);
+        if (pDst == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to allocate space for the video frame");
+            return false;
+        }
+        memcpy(pDst, FrameHeader, FrameHeaderSize);
+
+        Uint8* pDstY = pDst + FrameHeaderSize;
+        Uint8* pDstU = pDstY + LumaSize;
+        Uint8* pDstV = pDstU + ChromaSize;
+        for (Uint32 row = 0; row < m_Height; ++row)
+        {
+            ConvertRowToLuma(pSrc + size_t{row} * Stride, pDstY + size_t{row} * m_Width, m_Width, Order);
+        }
+        for (Uint32 row = 0; row < m_Height; row += 2)
+        {
+            // Replicate the last row if the height is odd
+            const auto* pSrc0 = pSrc + size_t{row} * Stride;
+            const auto* pSrc1 = pSrc + size_t{std::min(row + 1, m_Height - 1)} * Stride;
+            ConvertRowsToChroma(pSrc0, pSrc1, pDstU + (row / 2) * ChromaWidth, pDstV + (row / 2) * ChromaWidth, m_Width, Order);
+        }
+
+        if (!m_pOutput->Commit(FrameSize))
+        {
+            LOG_ERROR_MESSAGE("Failed to write video frame");
+            return false;
+        }
+    }
+    else
+    {
+        const size_t RowSize   = size_t{m_Width} * 4;
+        const size_t FrameSize = RowSize * m_Height;
+
+        auto* pDst = m_pOutput->Reserve(FrameSize);
+        if (pDst == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to allocate space for the video frame");
+            return false;
+        }
+
+        for (Uint32 row = 0; row < m_Height; ++row)
+        {
+            ConvertRowToRGBA(pSrc + size_t{row} * Stride, pDst + row * RowSize, m_Width, Order);
+        }
+
+        if (!m_pOutput->Commit(FrameSize))
+        {
+            LOG_ERROR_MESSAGE("Failed to write video frame");
+            return false;
+        }
+    }
+
+    ++m_NumFrames;
+    return true;
+}
+
+} // namespace Diligent
@@ -36,6 +36,7 @@
 #include "imGuIZMO.h"
 #include "PlatformMisc.hpp"
 #include "ImGuiUtils.hpp"
+#include "CPUProfiler.hpp"
 
 namespace Diligent
 {
@@ -135,6 +136,8 @@ void AtmosphereSample::Initialize(IEngineFactory* pEngineFactory, IRenderDevice*
     m_EarthHemisphere.Create(m_pElevDataSource.get(),
                              m_TerrainRenderParams,
                              m_pDevice,
+                             m_pShaderCache,
+                             m_pTextureLoader,
                              m_pImmediateContext,
                              m_strMtrlMaskFile.c_str(),
                              strTileTexPaths,
@@ -144,6 +147,8 @@ void AtmosphereSample::Initialize(IEngineFactory* pEngineFactory, IRenderDevice*
                              pcMediaScatteringParams);
 
     CreateShadowMap();
+
+    m_pFrameGraph.reset(new FrameGraph{pDevice});
 }
 
 void AtmosphereSample::UpdateUI()
@@ -470,6 +475,9 @@ void AtmosphereSample::RenderShadowMap(IDeviceContext* pContext,
                                        const float4x4& mCameraView,
                                        const float4x4& mCameraProj)
 {
+    CPU_PROFILER_SCOPE("RenderShadowMap");
+    GPU_PROFILER_SCOPE(m_pGPUProfiler, "RenderShadowMap");
+
     auto& ShadowAttribs = LightAttribs.ShadowAttribs;
 
     ShadowMapManager::DistributeCascadeInfo DistrInfo;
@@ -502,10 +510,15 @@ void AtmosphereSample::RenderShadowMap(IDeviceContext* pContext,
     // Render cascades
     for (int iCascade = 0; iCascade < m_TerrainRenderParams.m_iNumShadowCascades; ++iCascade)
     {
+        static constexpr const char* CascadeScopeNames[] = {"Cascade 0", "Cascade 1", "Cascade 2", "Cascade 3", "Cascade 4", "Cascade 5", "Cascade 6", "Cascade 7"};
+        VERIFY_EXPR(static_cast<size_t>(iCascade) < _countof(CascadeScopeNames));
+        GPU_PROFILER_SCOPE(m_pGPUProfiler, CascadeScopeNames[iCascade]);
+
         auto* pCascadeDSV = m_ShadowMapMgr.GetCascadeDSV(iCascade);
 
-        m_pImmediateContext->SetRenderTargets(0, nullptr, pCascadeDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-        m_pImmediateContext->ClearDepthStencil(pCascadeDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        // Shadow map is transitioned to DEPTH_WRITE state by the frame graph
+        m_pImmediateContext->SetRenderTargets(0, nullptr, pCascadeDSV, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        m_pImmediateContext->ClearDepthStencil(pCascadeDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
         const auto CascadeProjMatr = m_ShadowMapMgr.GetCascadeTranform(iCascade).Proj;
 
@@ -546,38 +559,30 @@ void AtmosphereSample::Render()
     // m_iFirstCascade must be initialized before calling RenderShadowMap()!
     m_PPAttribs.iFirstCascadeToRayMarch = std::min(m_PPAttribs.iFirstCascadeToRayMarch, m_TerrainRenderParams.m_iNumShadowCascades - 1);
 
-    RenderShadowMap(m_pImmediateContext, LightAttrs, m_mCameraView, m_mCameraProj);
-
-    LightAttrs.ShadowAttribs.bVisualizeCascades = m_ShadowSettings.bVisualizeCascades ? TRUE : FALSE;
-
-    {
-        MapHelper<LightAttribs> LightAttribsCBData(m_pImmediateContext, m_pcbLightAttribs, MAP_WRITE, MAP_FLAG_DISCARD);
-        *LightAttribsCBData = LightAttrs;
-    }
-
-    // The first time GetAmbientSkyLightSRV() is called, the ambient sky light texture
-    // is computed and render target is set. So we need to query the texture before setting
-    // render targets
-    auto* pAmbientSkyLightSRV = m_pLightSctrPP->GetAmbientSkyLightSRV(m_pDevice, m_pImmediateContext);
-
-    auto* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
-    auto* pDSV = m_pSwapChain->GetDepthBufferDSV();
-    m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-
-    const float ClearColor[] = {0.350f, 0.350f, 0.350f, 1.0f};
-    const float Zero[]       = {0.f, 0.f, 0.f, 0.f};
-    m_pImmediateContext->ClearRenderTarget(pRTV, m_bEnableLightScattering ? Zero : ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    auto* pBackBufferRTV  = m_pSwapChain->GetCurrentBackBufferRTV();
+    auto* pDepthBufferDSV = m_pSwapChain->GetDepthBufferDSV();
 
+    ITexture* pOffscreenColorBuffer = nullptr;
+    ITexture* pOffscreenDepthBuffer = nullptr;
     if (m_bEnableLightScattering)
     {
-        pRTV = m_pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
-        pDSV = m_pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
-        m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-        m_pImmediateContext->ClearRenderTarget(pRTV, Zero, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        TextureDesc ColorBuffDesc;
+        ColorBuffDesc.Name      = "Offscreen color buffer";
+        ColorBuffDesc.Type      = RESOURCE_DIM_TEX_2D;
+        ColorBuffDesc.Width     = m_pSwapChain->GetDesc().Width;
+        ColorBuffDesc.Height    = m_pSwapChain->GetDesc().Height;
+        ColorBuffDesc.MipLevels = 1;
+        ColorBuffDesc.Format    = OffscreenColorFormat;
+        ColorBuffDesc.BindFlags = BIND_SHADER_RESOURCE | BIND_RENDER_TARGET;
+        pOffscreenColorBuffer   = m_pRenderTargetPool->AcquireTransient(ColorBuffDesc);
+
+        TextureDesc DepthBuffDesc = ColorBuffDesc;
+        DepthBuffDesc.Name        = "Offscreen depth buffer";
+        DepthBuffDesc.Format      = OffscreenDepthFormat;
+        DepthBuffDesc.BindFlags   = BIND_SHADER_RESOURCE | BIND_DEPTH_STENCIL;
+        pOffscreenDepthBuffer     = m_pRenderTargetPool->AcquireTransient(DepthBuffDesc);
     }
 
-    m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-
     CameraAttribs CamAttribs;
     CamAttribs.mViewT        = m_mCameraView.Transpose();
     CamAttribs.mProjT        = m_mCameraProj.Transpose();
@@ -593,61 +598,125 @@ void AtmosphereSample::Render()
     CamAttribs.f4ViewportSize.z = 1.f / CamAttribs.f4ViewportSize.x;
     CamAttribs.f4ViewportSize.w = 1.f / CamAttribs.f4ViewportSize.y;
 
-    {
-        MapHelper<CameraAttribs> CamAttribsCBData(m_pImmediateContext, m_pcbCameraAttribs, MAP_WRITE, MAP_FLAG_DISCARD);
-        *CamAttribsCBData = CamAttribs;
-    }
+    // All passes are executed before Render() returns, so they may reference local variables
+    m_pFrameGraph->Clear();
 
-    // Render terrain
-    auto* pPrecomputedNetDensitySRV    = m_pLightSctrPP->GetPrecomputedNetDensitySRV();
-    m_TerrainRenderParams.DstRTVFormat = m_bEnableLightScattering ? m_pOffscreenColorBuffer->GetDesc().Format : m_pSwapChain->GetDesc().ColorBufferFormat;
-    m_EarthHemisphere.Render(m_pImmediateContext,
-                             m_TerrainRenderParams,
-                             m_f3CameraPos,
-                             mViewProj,
-                             m_ShadowMapMgr.GetSRV(),
-                             pPrecomputedNetDensitySRV,
-                             pAmbientSkyLightSRV,
-                             false);
+    const auto ShadowMap   = m_pFrameGraph->ImportTexture(m_ShadowMapMgr.GetSRV()->GetTexture());
+    const auto BackBuffer  = m_pFrameGraph->ImportTexture(pBackBufferRTV->GetTexture());
+    const auto DepthBuffer = m_pFrameGraph->ImportTexture(pDepthBufferDSV->GetTexture());
+    m_pFrameGraph->MarkOutput(BackBuffer);
+
+    const auto ShadowPass = m_pFrameGraph->AddPass("Shadow map", [&](IDeviceContext* /*pCtx*/) {
+        RenderShadowMap(m_pImmediateContext, LightAttrs, m_mCameraView, m_mCameraProj);
+    });
+    m_pFrameGraph->AddWrite(ShadowPass, ShadowMap, RESOURCE_STATE_DEPTH_WRITE);
+
+    const auto TerrainPass = m_pFrameGraph->AddPass("Terrain", [&](IDeviceContext* /*pCtx*/) {
+        LightAttrs.ShadowAttribs.bVisualizeCascades = m_ShadowSettings.bVisualizeCascades ? TRUE : FALSE;
+
+        {
+            MapHelper<LightAttribs> LightAttribsCBData(m_pImmediateContext, m_pcbLightAttribs, MAP_WRITE, MAP_FLAG_DISCARD);
+            *LightAttribsCBData = LightAttrs;
+        }
+
+        // The first time GetAmbientSkyLightSRV() is called, the ambient sky light texture
+        // is computed and render target is set. So we need to query the texture before setting
+        // render targets
+        auto* pAmbientSkyLightSRV = m_pLightSctrPP->GetAmbientSkyLightSRV(m_pDevice, m_pImmediateContext);
+
+        // Render targets are transitioned to the required states by the frame graph
+        ITextureView* pRTV = pBackBufferRTV;
+        ITextureView* pDSV = pDepthBufferDSV;
+        m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+        const float ClearColor[] = {0.350f, 0.350f, 0.350f, 1.0f};
+        const float Zero[]       = {0.f, 0.f, 0.f, 0.f};
+        m_pImmediateContext->ClearRenderTarget(pRTV, m_bEnableLightScattering ? Zero : ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+        if (m_bEnableLightScattering)
+        {
+            pRTV = pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+            pDSV = pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
+            m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+            m_pImmediateContext->ClearRenderTarget(pRTV, Zero, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        }
+
+        m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+        {
+            MapHelper<CameraAttribs> CamAttribsCBData(m_pImmediateContext, m_pcbCameraAttribs, MAP_WRITE, MAP_FLAG_DISCARD);
+            *CamAttribsCBData = CamAttribs;
+        }
+
+        // Render terrain
+        auto* pPrecomputedNetDensitySRV    = m_pLightSctrPP->GetPrecomputedNetDensitySRV();
+        m_TerrainRenderParams.DstRTVFormat = m_bEnableLightScattering ? OffscreenColorFormat : m_pSwapChain->GetDesc().ColorBufferFormat;
+        m_EarthHemisphere.Render(m_pImmediateContext,
+                                 m_TerrainRenderParams,
+                                 m_f3CameraPos,
+                                 mViewProj,
+                                 m_ShadowMapMgr.GetSRV(),
+                                 pPrecomputedNetDensitySRV,
+                                 pAmbientSkyLightSRV,
+                                 false);
+    });
+    m_pFrameGraph->AddRead(TerrainPass, ShadowMap, RESOURCE_STATE_SHADER_RESOURCE);
+    m_pFrameGraph->AddWrite(TerrainPass, BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+    m_pFrameGraph->AddWrite(TerrainPass, DepthBuffer, RESOURCE_STATE_DEPTH_WRITE);
 
     if (m_bEnableLightScattering)
     {
-        EpipolarLightScattering::FrameAttribs FrameAttribs;
-
-        FrameAttribs.pDevice        = m_pDevice;
-        FrameAttribs.pDeviceContext = m_pImmediateContext;
-        FrameAttribs.dElapsedTime   = m_fElapsedTime;
-        FrameAttribs.pLightAttribs  = &LightAttrs;
-        FrameAttribs.pCameraAttribs = &CamAttribs;
-
-        m_PPAttribs.iNumCascades = m_TerrainRenderParams.m_iNumShadowCascades;
-        m_PPAttribs.fNumCascades = (float)m_TerrainRenderParams.m_iNumShadowCascades;
-
-        FrameAttribs.pcbLightAttribs  = m_pcbLightAttribs;
-        FrameAttribs.pcbCameraAttribs = m_pcbCameraAttribs;
-
-        m_PPAttribs.fMaxShadowMapStep = static_cast<float>(m_ShadowSettings.Resolution / 4);
-
-        m_PPAttribs.f2ShadowMapTexelSize = float2(1.f / static_cast<float>(m_ShadowSettings.Resolution), 1.f / static_cast<float>(m_ShadowSettings.Resolution));
-        m_PPAttribs.uiMaxSamplesOnTheRay = m_ShadowSettings.Resolution;
-        // During the ray marching, on each step we move by the texel size in either horz
-        // or vert direction. So resolution of min/max mipmap should be the same as the
-        // resolution of the original shadow map
-        m_PPAttribs.uiMinMaxShadowMapResolution    = m_ShadowSettings.Resolution;
-        m_PPAttribs.uiInitialSampleStepInSlice     = std::min(m_PPAttribs.uiInitialSampleStepInSlice, m_PPAttribs.uiMaxSamplesInSlice);
-        m_PPAttribs.uiEpipoleSamplingDensityFactor = std::min(m_PPAttribs.uiEpipoleSamplingDensityFactor, m_PPAttribs.uiInitialSampleStepInSlice);
-
-        FrameAttribs.ptex2DSrcColorBufferSRV = m_pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        FrameAttribs.ptex2DSrcColorBufferRTV = m_pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
-        FrameAttribs.ptex2DSrcDepthBufferSRV = m_pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        FrameAttribs.ptex2DSrcDepthBufferDSV = m_pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
-        FrameAttribs.ptex2DDstColorBufferRTV = m_pSwapChain->GetCurrentBackBufferRTV();
-        FrameAttribs.ptex2DDstDepthBufferDSV = m_pSwapChain->GetDepthBufferDSV();
-        FrameAttribs.ptex2DShadowMapSRV      = m_ShadowMapMgr.GetSRV();
-
-        // Perform the post processing
-        m_pLightSctrPP->PerformPostProcessing(FrameAttribs, m_PPAttribs);
+        const auto OffscreenColor = m_pFrameGraph->ImportTexture(pOffscreenColorBuffer);
+        const auto OffscreenDepth = m_pFrameGraph->ImportTexture(pOffscreenDepthBuffer);
+        m_pFrameGraph->AddWrite(TerrainPass, OffscreenColor, RESOURCE_STATE_RENDER_TARGET);
+        m_pFrameGraph->AddWrite(TerrainPass, OffscreenDepth, RESOURCE_STATE_DEPTH_WRITE);
+
+        const auto LightScatteringPass = m_pFrameGraph->AddPass("Light scattering", [&](IDeviceContext* /*pCtx*/) {
+            EpipolarLightScattering::FrameAttribs FrameAttribs;
+
+            FrameAttribs.pDevice        = m_pDevice;
+            FrameAttribs.pDeviceContext = m_pImmediateContext;
+            FrameAttribs.dElapsedTime   = m_fElapsedTime;
+            FrameAttribs.pLightAttribs  = &LightAttrs;
+            FrameAttribs.pCameraAttribs = &CamAttribs;
+
+            m_PPAttribs.iNumCascades = m_TerrainRenderParams.m_iNumShadowCascades;
+            m_PPAttribs.fNumCascades = (float)m_TerrainRenderParams.m_iNumShadowCascades;
+
+            FrameAttribs.pcbLightAttribs  = m_pcbLightAttribs;
+            FrameAttribs.pcbCameraAttribs = m_pcbCameraAttribs;
+
+            m_PPAttribs.fMaxShadowMapStep = static_cast<float>(m_ShadowSettings.Resolution / 4);
+
+            m_PPAttribs.f2ShadowMapTexelSize = float2(1.f / static_cast<float>(m_ShadowSettings.Resolution), 1.f / static_cast<float>(m_ShadowSettings.Resolution));
+            m_PPAttribs.uiMaxSamplesOnTheRay = m_ShadowSettings.Resolution;
+            // During the ray marching, on each step we move by the texel size in either horz
+            // or vert direction. So resolution of min/max mipmap should be the same as the
+            // resolution of the original shadow map
+            m_PPAttribs.uiMinMaxShadowMapResolution    = m_ShadowSettings.Resolution;
+            m_PPAttribs.uiInitialSampleStepInSlice     = std::min(m_PPAttribs.uiInitialSampleStepInSlice, m_PPAttribs.uiMaxSamplesInSlice);
+            m_PPAttribs.uiEpipoleSamplingDensityFactor = std::min(m_PPAttribs.uiEpipoleSamplingDensityFactor, m_PPAttribs.uiInitialSampleStepInSlice);
+
+            FrameAttribs.ptex2DSrcColorBufferSRV = pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+            FrameAttribs.ptex2DSrcColorBufferRTV = pOffscreenColorBuffer->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+            FrameAttribs.ptex2DSrcDepthBufferSRV = pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+            FrameAttribs.ptex2DSrcDepthBufferDSV = pOffscreenDepthBuffer->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
+            FrameAttribs.ptex2DDstColorBufferRTV = pBackBufferRTV;
+            FrameAttribs.ptex2DDstDepthBufferDSV = pDepthBufferDSV;
+            FrameAttribs.ptex2DShadowMapSRV      = m_ShadowMapMgr.GetSRV();
+
+            // Perform the post processing
+            GPU_PROFILER_SCOPE(m_pGPUProfiler, "EpipolarLightScattering");
+            m_pLightSctrPP->PerformPostProcessing(FrameAttribs, m_PPAttribs);
+        });
+        m_pFrameGraph->AddRead(LightScatteringPass, OffscreenColor, RESOURCE_STATE_SHADER_RESOURCE);
+        m_pFrameGraph->AddRead(LightScatteringPass, OffscreenDepth, RESOURCE_STATE_SHADER_RESOURCE);
+        m_pFrameGraph->AddRead(LightScatteringPass, ShadowMap, RESOURCE_STATE_SHADER_RESOURCE);
+        m_pFrameGraph->AddWrite(LightScatteringPass, BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+        m_pFrameGraph->AddWrite(LightScatteringPass, DepthBuffer, RESOURCE_STATE_DEPTH_WRITE);
     }
+
+    m_pFrameGraph->Execute(m_pImmediateContext);
 }
 
 
@@ -745,6 +814,51 @@ void ComputeApproximateNearFarPlaneDist(const float3&   CameraPos,
 
 
 void AtmosphereSample::Update(double CurrTime, double ElapsedTime)
+{
+    SampleBase::Update(CurrTime, ElapsedTime);
+    UpdateUI();
+
+    m_fElapsedTime = static_cast<float>(ElapsedTime);
+
+    UpdateView(CurrTime);
+
+#if 0
+    if( m_bAnimateSun )
+    {
+        auto &LightOrientationMatrix = *m_pDirLightOrienationCamera->GetParentMatrix();
+        float3 RotationAxis( 0.5f, 0.3f, 0.0f );
+        float3 LightDir = m_pDirLightOrienationCamera->GetLook() * -1;
+        float fRotationScaler = ( LightDir.y > +0.2f ) ? 50.f : 1.f;
+        float4x4 RotationMatrix = float4x4RotationAxis(RotationAxis, 0.02f * (float)deltaSeconds * fRotationScaler);
+        LightOrientationMatrix = LightOrientationMatrix * RotationMatrix;
+        m_pDirLightOrienationCamera->SetParentMatrix(LightOrientationMatrix);
+    }
+
+    float dt = (float)ElapsedTime;
+    if (m_Animate && dt > 0 && dt < 0.2f)
+    {
+        float3 axis;
+        float angle = 0;
+        AxisAngleFromRotation(axis, angle, m_Rotation);
+        if (length(axis) < 1.0e-6f) 
+            axis[1] = 1;
+        angle += m_AnimationSpeed * dt;
+        if (angle >= 2.0f*FLOAT_PI)
+            angle -= 2.0f*FLOAT_PI;
+        else if (angle <= 0)
+            angle += 2.0f*FLOAT_PI;
+        m_Rotation = RotationFromAxisAngle(axis, angle);
+    }
+#endif
+}
+
+void AtmosphereSample::LateLatchInput(double CurrTime)
+{
+    // Recompute the view with the mouse motion received since the update
+    UpdateView(CurrTime);
+}
+
+void AtmosphereSample::UpdateView(double CurrTime)
 {
     const auto& mouseState = m_InputController.GetMouseState();
 
@@ -764,13 +878,25 @@ void AtmosphereSample::Update(double CurrTime, double ElapsedTime)
         m_fCameraYaw += MouseDeltaX * CameraRotationSpeed;
         m_fCameraPitch += MouseDeltaY * CameraRotationSpeed;
     }
-    m_CameraRotation =
-        Quaternion::RotationFromAxisAngle(float3{1, 0, 0}, -m_fCameraPitch) *
-        Quaternion::RotationFromAxisAngle(float3{0, 1, 0}, -m_fCameraYaw);
     m_f3CameraPos.y += mouseState.WheelDelta * 500.f;
     m_f3CameraPos.y = std::max(m_f3CameraPos.y, 2000.f);
     m_f3CameraPos.y = std::min(m_f3CameraPos.y, 100000.f);
 
+    {
+        CameraPose Pose;
+        Pose.Position = m_f3CameraPos;
+        Pose.Yaw      = m_fCameraYaw;
+        Pose.Pitch    = m_fCameraPitch;
+        UpdateCameraPose(CurrTime, Pose);
+        m_f3CameraPos  = Pose.Position;
+        m_fCameraYaw   = Pose.Yaw;
+        m_fCameraPitch = Pose.Pitch;
+    }
+
+    m_CameraRotation =
+        Quaternion::RotationFromAxisAngle(float3{1, 0, 0}, -m_fCameraPitch) *
+        Quaternion::RotationFromAxisAngle(float3{0, 1, 0}, -m_fCameraYaw);
+
     auto CameraRotationMatrix = m_CameraRotation.ToMatrix();
 
     if ((m_LastMouseState.ButtonFlags & MouseState::BUTTON_FLAG_RIGHT) != 0)
@@ -786,11 +912,6 @@ void AtmosphereSample::Update(double CurrTime, double ElapsedTime)
             float4x4::RotationArbitrary(WorldRight, fPitchDelta);
     }
 
-    SampleBase::Update(CurrTime, ElapsedTime);
-    UpdateUI();
-
-    m_fElapsedTime = static_cast<float>(ElapsedTime);
-
     const auto& SCDesc = m_pSwapChain->GetDesc();
     // Set world/view/proj matrices and global shader constants
     float aspectRatio = (float)SCDesc.Width / SCDesc.Height;
@@ -821,35 +942,6 @@ void AtmosphereSample::Update(double CurrTime, double ElapsedTime)
     fFarPlaneZ  = std::max(fFarPlaneZ, 1000.f);
 
     m_mCameraProj = float4x4::Projection(FOV, aspectRatio, fNearPlaneZ, fFarPlaneZ, m_bIsGLDevice);
-
-#if 0
-    if( m_bAnimateSun )
-    {
-        auto &LightOrientationMatrix = *m_pDirLightOrienationCamera->GetParentMatrix();
-        float3 RotationAxis( 0.5f, 0.3f, 0.0f );
-        float3 LightDir = m_pDirLightOrienationCamera->GetLook() * -1;
-        float fRotationScaler = ( LightDir.y > +0.2f ) ? 50.f : 1.f;
-        float4x4 RotationMatrix = float4x4RotationAxis(RotationAxis, 0.02f * (float)deltaSeconds * fRotationScaler);
-        LightOrientationMatrix = LightOrientationMatrix * RotationMatrix;
-        m_pDirLightOrienationCamera->SetParentMatrix(LightOrientationMatrix);
-    }
-
-    float dt = (float)ElapsedTime;
-    if (m_Animate && dt > 0 && dt < 0.2f)
-    {
-        float3 axis;
-        float angle = 0;
-        AxisAngleFromRotation(axis, angle, m_Rotation);
-        if (length(axis) < 1.0e-6f) 
-            axis[1] = 1;
-        angle += m_AnimationSpeed * dt;
-        if (angle >= 2.0f*FLOAT_PI)
-            angle -= 2.0f*FLOAT_PI;
-        else if (angle <= 0)
-            angle += 2.0f*FLOAT_PI;
-        m_Rotation = RotationFromAxisAngle(axis, angle);
-    }
-#endif
 }
 
 void AtmosphereSample::WindowResize(Uint32 Width, Uint32 Height)
@@ -862,24 +954,8 @@ void AtmosphereSample::WindowResize(Uint32 Width, Uint32 Height)
     // not by Intel driver, which results in memory exhaustion.
     m_pImmediateContext->Flush();
 
-    m_pOffscreenColorBuffer.Release();
-    m_pOffscreenDepthBuffer.Release();
-
-    TextureDesc ColorBuffDesc;
-    ColorBuffDesc.Name      = "Offscreen color buffer";
-    ColorBuffDesc.Type      = RESOURCE_DIM_TEX_2D;
-    ColorBuffDesc.Width     = Width;
-    ColorBuffDesc.Height    = Height;
-    ColorBuffDesc.MipLevels = 1;
-    ColorBuffDesc.Format    = TEX_FORMAT_R11G11B10_FLOAT;
-    ColorBuffDesc.BindFlags = BIND_SHADER_RESOURCE | BIND_RENDER_TARGET;
-    m_pDevice->CreateTexture(ColorBuffDesc, nullptr, &m_pOffscreenColorBuffer);
-
-    TextureDesc DepthBuffDesc = ColorBuffDesc;
-    DepthBuffDesc.Name        = "Offscreen depth buffer";
-    DepthBuffDesc.Format      = TEX_FORMAT_D32_FLOAT;
-    DepthBuffDesc.BindFlags   = BIND_SHADER_RESOURCE | BIND_DEPTH_STENCIL;
-    m_pDevice->CreateTexture(DepthBuffDesc, nullptr, &m_pOffscreenDepthBuffer);
+    // Offscreen buffers of the new size are allocated from the pool when the next frame is
+    // rendered, and the buffers of the old size are released by the pool once they are unused
 }
 
 } // namespace Diligent
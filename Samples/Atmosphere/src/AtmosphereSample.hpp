@@ -33,6 +33,7 @@
 #include "ElevationDataSource.hpp"
 #include "EpipolarLightScattering.hpp"
 #include "ShadowMapManager.hpp"
+#include "FrameGraph.hpp"
 
 namespace Diligent
 {
@@ -50,11 +51,14 @@ public:
                                    ISwapChain*      pSwapChain) override final;
     virtual void        Render() override final;
     virtual void        Update(double CurrTime, double ElapsedTime) override final;
+    virtual bool        SupportsLateInputLatching() const override final { return true; }
+    virtual void        LateLatchInput(double CurrTime) override final;
     virtual void        WindowResize(Uint32 Width, Uint32 Height) override final;
     virtual const Char* GetSampleName() const override final { return "Atmosphere Sample"; }
 
 private:
     void UpdateUI();
+    void UpdateView(double CurrTime);
     void CreateShadowMap();
     void RenderShadowMap(IDeviceContext* pContext,
                          LightAttribs&   LightAttribs,
@@ -72,6 +76,9 @@ private:
     RefCntAutoPtr<IBuffer> m_pcbLightAttribs;
 
     ShadowMapManager m_ShadowMapMgr;
+
+    std::unique_ptr<FrameGraph> m_pFrameGraph;
+
     struct ShadowSettings
     {
         Uint32 Resolution                 = 1024;
@@ -102,8 +109,9 @@ private:
     float  m_fElapsedTime           = 0.f;
     float3 m_f3CustomRlghBeta, m_f3CustomMieBeta;
 
-    RefCntAutoPtr<ITexture> m_pOffscreenColorBuffer;
-    RefCntAutoPtr<ITexture> m_pOffscreenDepthBuffer;
+    // Offscreen buffers are allocated from the render target pool every frame
+    static constexpr TEXTURE_FORMAT OffscreenColorFormat = TEX_FORMAT_R11G11B10_FLOAT;
+    static constexpr TEXTURE_FORMAT OffscreenDepthFormat = TEX_FORMAT_D32_FLOAT;
 
     float      m_fCameraYaw   = 0.23f;
     float      m_fCameraPitch = 0.18f;
@@ -47,6 +47,7 @@
 #include <cfloat>
 
 #include "EarthHemisphere.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -64,6 +65,7 @@ namespace Diligent
 #include "ShaderMacroHelper.hpp"
 #include "TextureUtilities.h"
 #include "CommonlyUsedStates.h"
+#include "CPUProfiler.hpp"
 
 namespace Diligent
 {
@@ -293,6 +295,8 @@ void GenerateSphereGeometry(IRenderDevice*                 pDevice,
                             std::vector<HemisphereVertex>& VB,
                             std::vector<RingSectorMesh>&   SphereMeshes)
 {
+    CPU_PROFILER_SCOPE("GenerateSphereGeometry");
+
     if ((iGridDimension - 1) % 4 != 0)
     {
         iGridDimension = RenderingParams().m_iRingDimension;
@@ -555,7 +559,7 @@ void EarthHemsiphere::RenderNormalMap(IRenderDevice*  pDevice,
 
 
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders\\;shaders\\terrain", &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pDevice->GetEngineFactory(), "shaders\\;shaders\\terrain", &pShaderSourceFactory);
 
     ShaderCreateInfo ShaderCI;
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
@@ -566,7 +570,7 @@ void EarthHemsiphere::RenderNormalMap(IRenderDevice*  pDevice,
     ShaderCI.Desc.ShaderType            = SHADER_TYPE_VERTEX;
     ShaderCI.Desc.Name                  = "GenerateScreenSizeQuadVS";
     RefCntAutoPtr<IShader> pScreenSizeQuadVS;
-    pDevice->CreateShader(ShaderCI, &pScreenSizeQuadVS);
+    m_pShaderCache->CreateShader(ShaderCI, &pScreenSizeQuadVS);
 
     ShaderCI.FilePath        = "GenerateNormalMapPS.fx";
     ShaderCI.EntryPoint      = "GenerateNormalMapPS";
@@ -574,7 +578,7 @@ void EarthHemsiphere::RenderNormalMap(IRenderDevice*  pDevice,
     ShaderCI.Desc.Name       = "GenerateNormalMapPS";
 
     RefCntAutoPtr<IShader> pGenerateNormalMapPS;
-    pDevice->CreateShader(ShaderCI, &pGenerateNormalMapPS);
+    m_pShaderCache->CreateShader(ShaderCI, &pGenerateNormalMapPS);
 
     PipelineStateDesc PSODesc;
 
@@ -644,6 +648,8 @@ void EarthHemsiphere::RenderNormalMap(IRenderDevice*  pDevice,
 void EarthHemsiphere::Create(class ElevationDataSource* pDataSource,
                              const RenderingParams&     Params,
                              IRenderDevice*             pDevice,
+                             ShaderCache*               pShaderCache,
+                             AsyncTextureLoader*        pTextureLoader,
                              IDeviceContext*            pContext,
                              const Char*                MaterialMaskPath,
                              const Char*                TileTexturePath[],
@@ -652,8 +658,9 @@ void EarthHemsiphere::Create(class ElevationDataSource* pDataSource,
                              IBuffer*                   pcbLightAttribs,
                              IBuffer*                   pcMediaScatteringParams)
 {
-    m_Params  = Params;
-    m_pDevice = pDevice;
+    m_Params       = Params;
+    m_pDevice      = pDevice;
+    m_pShaderCache = pShaderCache;
 
     const Uint16* pHeightMap;
     size_t        HeightMapPitch;
@@ -692,40 +699,41 @@ void EarthHemsiphere::Create(class ElevationDataSource* pDataSource,
     ResMappingDesc.pEntries = pEntries;
     pDevice->CreateResourceMapping(ResMappingDesc, &m_pResMapping);
 
+    // Material mask and tile textures are decoded on the texture loader threads while the normal map is rendered
     RefCntAutoPtr<ITexture> ptex2DMtrlMask;
-    CreateTextureFromFile(MaterialMaskPath, TextureLoadInfo(), pDevice, &ptex2DMtrlMask);
-    auto ptex2DMtrlMaskSRV = ptex2DMtrlMask->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-    m_pResMapping->AddResource("g_tex2DMtrlMap", ptex2DMtrlMaskSRV, true);
-
-    // Load tiles
-    IDeviceObject*          ptex2DTileDiffuseSRV[NUM_TILE_TEXTURES] = {};
     RefCntAutoPtr<ITexture> ptex2DTileDiffuse[NUM_TILE_TEXTURES];
-    IDeviceObject*          ptex2DTileNMSRV[NUM_TILE_TEXTURES] = {};
     RefCntAutoPtr<ITexture> ptex2DTileNM[NUM_TILE_TEXTURES];
+    pTextureLoader->LoadTexture(MaterialMaskPath, TextureLoadInfo(), [&](ITexture* pTexture) { ptex2DMtrlMask = pTexture; });
     for (int iTileTex = 0; iTileTex < (int)NUM_TILE_TEXTURES; iTileTex++)
     {
-        {
-            TextureLoadInfo DiffMapLoadInfo;
-            DiffMapLoadInfo.IsSRGB = false;
-            CreateTextureFromFile(TileTexturePath[iTileTex], DiffMapLoadInfo, pDevice, &ptex2DTileDiffuse[iTileTex]);
-            ptex2DTileDiffuseSRV[iTileTex] = ptex2DTileDiffuse[iTileTex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        }
-
-        {
-
-            CreateTextureFromFile(TileNormalMapPath[iTileTex], TextureLoadInfo(), pDevice, &ptex2DTileNM[iTileTex]);
-            ptex2DTileNMSRV[iTileTex] = ptex2DTileNM[iTileTex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        }
+        TextureLoadInfo DiffMapLoadInfo;
+        DiffMapLoadInfo.IsSRGB = false;
+        pTextureLoader->LoadTexture(TileTexturePath[iTileTex], DiffMapLoadInfo, [&, iTileTex](ITexture* pTexture) { ptex2DTileDiffuse[iTileTex] = pTexture; });
+        pTextureLoader->LoadTexture(TileNormalMapPath[iTileTex], TextureLoadInfo(), [&, iTileTex](ITexture* pTexture) { ptex2DTileNM[iTileTex] = pTexture; });
     }
-    m_pResMapping->AddResourceArray("g_tex2DTileDiffuse", 0, ptex2DTileDiffuseSRV, NUM_TILE_TEXTURES, true);
-    m_pResMapping->AddResourceArray("g_tex2DTileNM", 0, ptex2DTileNMSRV, NUM_TILE_TEXTURES, true);
 
     m_pDevice->CreateSampler(Sam_ComparsionLinearClamp, &m_pComparisonSampler);
 
     RenderNormalMap(pDevice, pContext, pHeightMap, HeightMapPitch, iHeightMapDim, ptex2DNormalMap);
 
+    // The textures are bound as static resources, so the placeholders can't be used
+    pTextureLoader->Flush(pContext);
+
+    auto ptex2DMtrlMaskSRV = ptex2DMtrlMask->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    m_pResMapping->AddResource("g_tex2DMtrlMap", ptex2DMtrlMaskSRV, true);
+
+    IDeviceObject* ptex2DTileDiffuseSRV[NUM_TILE_TEXTURES] = {};
+    IDeviceObject* ptex2DTileNMSRV[NUM_TILE_TEXTURES]      = {};
+    for (int iTileTex = 0; iTileTex < (int)NUM_TILE_TEXTURES; iTileTex++)
+    {
+        ptex2DTileDiffuseSRV[iTileTex] = ptex2DTileDiffuse[iTileTex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+        ptex2DTileNMSRV[iTileTex]      = ptex2DTileNM[iTileTex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    }
+    m_pResMapping->AddResourceArray("g_tex2DTileDiffuse", 0, ptex2DTileDiffuseSRV, NUM_TILE_TEXTURES, true);
+    m_pResMapping->AddResourceArray("g_tex2DTileNM", 0, ptex2DTileNMSRV, NUM_TILE_TEXTURES, true);
+
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders;shaders\\terrain;", &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pDevice->GetEngineFactory(), "shaders;shaders\\terrain;", &pShaderSourceFactory);
 
     {
         ShaderCreateInfo ShaderCI;
@@ -737,7 +745,7 @@ void EarthHemsiphere::Create(class ElevationDataSource* pDataSource,
         ShaderCI.Desc.ShaderType            = SHADER_TYPE_VERTEX;
         ShaderCI.Desc.Name                  = "HemisphereVS";
 
-        pDevice->CreateShader(ShaderCI, &m_pHemisphereVS);
+        m_pShaderCache->CreateShader(ShaderCI, &m_pHemisphereVS);
     }
 
 
@@ -751,7 +759,7 @@ void EarthHemsiphere::Create(class ElevationDataSource* pDataSource,
         ShaderCI.Desc.ShaderType            = SHADER_TYPE_VERTEX;
         ShaderCI.Desc.Name                  = "HemisphereZOnlyVS";
         RefCntAutoPtr<IShader> pHemisphereZOnlyVS;
-        pDevice->CreateShader(ShaderCI, &pHemisphereZOnlyVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pHemisphereZOnlyVS);
 
         PipelineStateDesc PSODesc;
         PSODesc.Name                                          = "Render Hemisphere Z Only";
@@ -831,7 +839,7 @@ void EarthHemsiphere::Render(IDeviceContext*        pContext,
         Attrs.UseCombinedTextureSamplers = true;
         Attrs.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
         RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-        m_pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders;shaders\\terrain;", &pShaderSourceFactory);
+        CreateAssetShaderSourceStreamFactory(m_pDevice->GetEngineFactory(), "shaders;shaders\\terrain;", &pShaderSourceFactory);
         Attrs.pShaderSourceStreamFactory = pShaderSourceFactory;
 
         StaticSamplerDesc StaticSamplers[5];
@@ -873,7 +881,7 @@ void EarthHemsiphere::Render(IDeviceContext*        pContext,
         Attrs.Macros = Macros;
 
         RefCntAutoPtr<IShader> pHemispherePS;
-        m_pDevice->CreateShader(Attrs, &pHemispherePS);
+        m_pShaderCache->CreateShader(Attrs, &pHemispherePS);
 
         LayoutElement Inputs[] =
             {
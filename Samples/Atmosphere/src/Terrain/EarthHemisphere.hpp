@@ -55,6 +55,8 @@
 #include "TextureView.h"
 #include "GraphicsTypes.h"
 #include "RefCntAutoPtr.hpp"
+#include "ShaderCache.hpp"
+#include "AsyncTextureLoader.hpp"
 
 #include "AdvancedMath.hpp"
 
@@ -128,6 +130,8 @@ public:
     void Create(class ElevationDataSource* pDataSource,
                 const RenderingParams&     Params,
                 IRenderDevice*             pDevice,
+                ShaderCache*               pShaderCache,
+                AsyncTextureLoader*        pTextureLoader,
                 IDeviceContext*            pContext,
                 const char*                MaterialMaskPath,
                 const char*                TileTexturePath[],
@@ -152,6 +156,7 @@ private:
     RenderingParams m_Params;
 
     RefCntAutoPtr<IRenderDevice> m_pDevice;
+    ShaderCache*                 m_pShaderCache = nullptr;
 
     RefCntAutoPtr<IBuffer>      m_pcbTerrainAttribs;
     RefCntAutoPtr<IBuffer>      m_pVertBuff;
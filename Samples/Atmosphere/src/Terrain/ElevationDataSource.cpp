@@ -53,6 +53,7 @@
 #include "BasicFileStream.hpp"
 #include "TextureUtilities.h"
 #include "GraphicsAccessories.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -67,7 +68,7 @@ ElevationDataSource::ElevationDataSource(const Char* strSrcDemFile) :
 
 #if 1
     RefCntAutoPtr<Image> pHeightMap;
-    CreateImageFromFile(strSrcDemFile, &pHeightMap);
+    CreateImageFromAsset(strSrcDemFile, &pHeightMap, nullptr);
 
     const auto& ImgInfo    = pHeightMap->GetDesc();
     auto*       pImageData = pHeightMap->GetData();
@@ -37,6 +37,7 @@
 #include "FileSystem.hpp"
 #include "imgui.h"
 #include "imGuIZMO.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -276,7 +277,7 @@ void GLTFViewer::CreateEnvMapPSO()
 {
     ShaderCreateInfo                               ShaderCI;
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory("shaders", &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, "shaders", &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
     ShaderCI.UseCombinedTextureSamplers = true;
@@ -290,14 +291,14 @@ void GLTFViewer::CreateEnvMapPSO()
     ShaderCI.EntryPoint      = "main";
     ShaderCI.FilePath        = "env_map.vsh";
     RefCntAutoPtr<IShader> pVS;
-    m_pDevice->CreateShader(ShaderCI, &pVS);
+    m_pShaderCache->CreateShader(ShaderCI, &pVS);
 
     ShaderCI.Desc.Name       = "Environment map PS";
     ShaderCI.EntryPoint      = "main";
     ShaderCI.FilePath        = "env_map.psh";
     ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
     RefCntAutoPtr<IShader> pPS;
-    m_pDevice->CreateShader(ShaderCI, &pPS);
+    m_pShaderCache->CreateShader(ShaderCI, &pPS);
 
     PipelineStateDesc PSODesc;
     PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
@@ -428,55 +429,76 @@ void GLTFViewer::Render()
 }
 
 
-void GLTFViewer::Update(double CurrTime, double ElapsedTime)
+void GLTFViewer::UpdateView(double CurrTime)
 {
+    const auto& mouseState = m_InputController.GetMouseState();
+
+    float MouseDeltaX = 0;
+    float MouseDeltaY = 0;
+    if (m_LastMouseState.PosX >= 0 && m_LastMouseState.PosY >= 0 &&
+        m_LastMouseState.ButtonFlags != MouseState::BUTTON_FLAG_NONE)
     {
-        const auto& mouseState = m_InputController.GetMouseState();
+        MouseDeltaX = mouseState.PosX - m_LastMouseState.PosX;
+        MouseDeltaY = mouseState.PosY - m_LastMouseState.PosY;
+    }
+    m_LastMouseState = mouseState;
 
-        float MouseDeltaX = 0;
-        float MouseDeltaY = 0;
-        if (m_LastMouseState.PosX >= 0 && m_LastMouseState.PosY >= 0 &&
-            m_LastMouseState.ButtonFlags != MouseState::BUTTON_FLAG_NONE)
-        {
-            MouseDeltaX = mouseState.PosX - m_LastMouseState.PosX;
-            MouseDeltaY = mouseState.PosY - m_LastMouseState.PosY;
-        }
-        m_LastMouseState = mouseState;
+    constexpr float RotationSpeed = 0.005f;
 
-        constexpr float RotationSpeed = 0.005f;
+    float fYawDelta   = MouseDeltaX * RotationSpeed;
+    float fPitchDelta = MouseDeltaY * RotationSpeed;
+    if (mouseState.ButtonFlags & MouseState::BUTTON_FLAG_LEFT)
+    {
+        m_CameraYaw += fYawDelta;
+        m_CameraPitch += fPitchDelta;
+        m_CameraPitch = std::max(m_CameraPitch, -PI_F / 2.f);
+        m_CameraPitch = std::min(m_CameraPitch, +PI_F / 2.f);
+    }
 
-        float fYawDelta   = MouseDeltaX * RotationSpeed;
-        float fPitchDelta = MouseDeltaY * RotationSpeed;
-        if (mouseState.ButtonFlags & MouseState::BUTTON_FLAG_LEFT)
-        {
-            m_CameraYaw += fYawDelta;
-            m_CameraPitch += fPitchDelta;
-            m_CameraPitch = std::max(m_CameraPitch, -PI_F / 2.f);
-            m_CameraPitch = std::min(m_CameraPitch, +PI_F / 2.f);
-        }
+    m_CameraDist -= mouseState.WheelDelta * 0.25f;
+    m_CameraDist = clamp(m_CameraDist, 0.1f, 5.f);
 
-        // Apply extra rotations to adjust the view to match Khronos GLTF viewer
-        m_CameraRotation =
-            Quaternion::RotationFromAxisAngle(float3{1, 0, 0}, -m_CameraPitch) *
-            Quaternion::RotationFromAxisAngle(float3{0, 1, 0}, -m_CameraYaw) *
-            Quaternion::RotationFromAxisAngle(float3{0.75f, 0.0f, 0.75f}, PI_F);
+    {
+        // The distance to the model is stored in the z component of the position
+        CameraPose Pose;
+        Pose.Position = float3{0, 0, m_CameraDist};
+        Pose.Yaw      = m_CameraYaw;
+        Pose.Pitch    = m_CameraPitch;
+        UpdateCameraPose(CurrTime, Pose);
+        m_CameraDist  = Pose.Position.z;
+        m_CameraYaw   = Pose.Yaw;
+        m_CameraPitch = Pose.Pitch;
+    }
 
-        if (mouseState.ButtonFlags & MouseState::BUTTON_FLAG_RIGHT)
-        {
-            auto CameraView  = m_CameraRotation.ToMatrix();
-            auto CameraWorld = CameraView.Transpose();
-
-            float3 CameraRight = float3::MakeVector(CameraWorld[0]);
-            float3 CameraUp    = float3::MakeVector(CameraWorld[1]);
-            m_ModelRotation =
-                Quaternion::RotationFromAxisAngle(CameraRight, -fPitchDelta) *
-                Quaternion::RotationFromAxisAngle(CameraUp, -fYawDelta) *
-                m_ModelRotation;
-        }
+    // Apply extra rotations to adjust the view to match Khronos GLTF viewer
+    m_CameraRotation =
+        Quaternion::RotationFromAxisAngle(float3{1, 0, 0}, -m_CameraPitch) *
+        Quaternion::RotationFromAxisAngle(float3{0, 1, 0}, -m_CameraYaw) *
+        Quaternion::RotationFromAxisAngle(float3{0.75f, 0.0f, 0.75f}, PI_F);
 
-        m_CameraDist -= mouseState.WheelDelta * 0.25f;
-        m_CameraDist = clamp(m_CameraDist, 0.1f, 5.f);
+    if (mouseState.ButtonFlags & MouseState::BUTTON_FLAG_RIGHT)
+    {
+        auto CameraView  = m_CameraRotation.ToMatrix();
+        auto CameraWorld = CameraView.Transpose();
+
+        float3 CameraRight = float3::MakeVector(CameraWorld[0]);
+        float3 CameraUp    = float3::MakeVector(CameraWorld[1]);
+        m_ModelRotation =
+            Quaternion::RotationFromAxisAngle(CameraRight, -fPitchDelta) *
+            Quaternion::RotationFromAxisAngle(CameraUp, -fYawDelta) *
+            m_ModelRotation;
     }
+}
+
+void GLTFViewer::LateLatchInput(double CurrTime)
+{
+    // Recompute the camera rotation with the mouse motion received since the update
+    UpdateView(CurrTime);
+}
+
+void GLTFViewer::Update(double CurrTime, double ElapsedTime)
+{
+    UpdateView(CurrTime);
 
     if ((m_InputController.GetKeyState(InputKeys::Reset) & INPUT_KEY_STATE_FLAG_KEY_IS_DOWN) != 0)
         ResetView();
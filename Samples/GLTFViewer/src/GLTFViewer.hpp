@@ -49,6 +49,9 @@ public:
     virtual void Render() override final;
     virtual void Update(double CurrTime, double ElapsedTime) override final;
 
+    virtual bool SupportsLateInputLatching() const override final { return true; }
+    virtual void LateLatchInput(double CurrTime) override final;
+
     virtual const Char* GetSampleName() const override final { return "GLTF Viewer"; }
 
 private:
@@ -57,6 +60,7 @@ private:
     void LoadModel(const char* Path);
     void ResetView();
     void UpdateUI();
+    void UpdateView(double CurrTime);
 
     enum class BackgroundMode : int
     {
@@ -36,6 +36,8 @@
 #include "imgui.h"
 #include "imGuIZMO.h"
 #include "ImGuiUtils.hpp"
+#include "CPUProfiler.hpp"
+#include "AssetArchive.hpp"
 
 
 namespace Diligent
@@ -95,6 +97,8 @@ void ShadowsSample::Initialize(IEngineFactory* pEngineFactory, IRenderDevice* pD
     CreatePipelineStates();
 
     CreateShadowMap();
+
+    m_pFrameGraph.reset(new FrameGraph{pDevice});
 }
 
 void ShadowsSample::UpdateUI()
@@ -307,7 +311,7 @@ void ShadowsSample::CreatePipelineStates()
 {
     ShaderCreateInfo                               ShaderCI;
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory("shaders", &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, "shaders", &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
     ShaderCI.UseCombinedTextureSamplers = true;
@@ -326,14 +330,14 @@ void ShadowsSample::CreatePipelineStates()
     ShaderCI.EntryPoint      = "MeshVS";
     ShaderCI.FilePath        = "MeshVS.vsh";
     RefCntAutoPtr<IShader> pVS;
-    m_pDevice->CreateShader(ShaderCI, &pVS);
+    m_pShaderCache->CreateShader(ShaderCI, &pVS);
 
     ShaderCI.Desc.Name       = "Mesh PS";
     ShaderCI.EntryPoint      = "MeshPS";
     ShaderCI.FilePath        = "MeshPS.psh";
     ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
     RefCntAutoPtr<IShader> pPS;
-    m_pDevice->CreateShader(ShaderCI, &pPS);
+    m_pShaderCache->CreateShader(ShaderCI, &pPS);
 
     Macros.AddShaderMacro("SHADOW_PASS", true);
     ShaderCI.Desc.ShaderType = SHADER_TYPE_VERTEX;
@@ -342,7 +346,7 @@ void ShadowsSample::CreatePipelineStates()
     ShaderCI.FilePath        = "MeshVS.vsh";
     ShaderCI.Macros          = Macros;
     RefCntAutoPtr<IShader> pShadowVS;
-    m_pDevice->CreateShader(ShaderCI, &pShadowVS);
+    m_pShaderCache->CreateShader(ShaderCI, &pShadowVS);
 
     m_PSOIndex.resize(m_Mesh.GetNumVBs());
     m_RenderMeshPSO.clear();
@@ -515,9 +519,16 @@ void ShadowsSample::CreateShadowMap()
 
 void ShadowsSample::RenderShadowMap()
 {
+    CPU_PROFILER_SCOPE("RenderShadowMap");
+    GPU_PROFILER_SCOPE(m_pGPUProfiler, "RenderShadowMap");
+
     auto iNumShadowCascades = m_LightAttribs.ShadowAttribs.iNumCascades;
     for (int iCascade = 0; iCascade < iNumShadowCascades; ++iCascade)
     {
+        static constexpr const char* CascadeScopeNames[] = {"Cascade 0", "Cascade 1", "Cascade 2", "Cascade 3", "Cascade 4", "Cascade 5", "Cascade 6", "Cascade 7"};
+        VERIFY_EXPR(static_cast<size_t>(iCascade) < _countof(CascadeScopeNames));
+        GPU_PROFILER_SCOPE(m_pGPUProfiler, CascadeScopeNames[iCascade]);
+
         const auto CascadeProjMatr = m_ShadowMapMgr.GetCascadeTranform(iCascade).Proj;
 
         auto WorldToLightViewSpaceMatr = m_LightAttribs.ShadowAttribs.mWorldToLightViewT.Transpose();
@@ -539,33 +550,65 @@ void ShadowsSample::RenderShadowMap()
             *CameraData = ShadowCameraAttribs;
         }
 
+        // Shadow map is transitioned to DEPTH_WRITE state by the frame graph
         auto* pCascadeDSV = m_ShadowMapMgr.GetCascadeDSV(iCascade);
-        m_pImmediateContext->SetRenderTargets(0, nullptr, pCascadeDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-        m_pImmediateContext->ClearDepthStencil(pCascadeDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        m_pImmediateContext->SetRenderTargets(0, nullptr, pCascadeDSV, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        m_pImmediateContext->ClearDepthStencil(pCascadeDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
         ViewFrustumExt Frutstum;
         ExtractViewFrustumPlanesFromMatrix(WorldToLightProjSpaceMatr, Frutstum, m_pDevice->GetDeviceCaps().IsGLDevice());
         DrawMesh(m_pImmediateContext, true, Frutstum);
     }
-
-    if (m_ShadowSettings.iShadowMode > SHADOW_MODE_PCF)
-        m_ShadowMapMgr.ConvertToFilterable(m_pImmediateContext, m_LightAttribs.ShadowAttribs);
 }
 
 // Render a frame
 void ShadowsSample::Render()
 {
-    RenderShadowMap();
-
-    // Reset default framebuffer
     auto* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
     auto* pDSV = m_pSwapChain->GetDepthBufferDSV();
-    m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    m_pFrameGraph->Clear();
+
+    // In PCF mode, the scene samples the shadow map directly, otherwise it samples the filterable shadow map
+    const auto ShadowMap   = m_pFrameGraph->ImportTexture(m_ShadowMapMgr.GetCascadeDSV(0)->GetTexture());
+    const auto ShadowSRV   = m_pFrameGraph->ImportTexture(m_ShadowMapMgr.GetSRV()->GetTexture());
+    const auto BackBuffer  = m_pFrameGraph->ImportTexture(pRTV->GetTexture());
+    const auto DepthBuffer = m_pFrameGraph->ImportTexture(pDSV->GetTexture());
+    m_pFrameGraph->MarkOutput(BackBuffer);
+
+    const auto ShadowPass = m_pFrameGraph->AddPass("Shadow map", [this](IDeviceContext* /*pCtx*/) {
+        RenderShadowMap();
+    });
+    m_pFrameGraph->AddWrite(ShadowPass, ShadowMap, RESOURCE_STATE_DEPTH_WRITE);
+
+    if (m_ShadowSettings.iShadowMode > SHADOW_MODE_PCF)
+    {
+        const auto FilterPass = m_pFrameGraph->AddPass("Filterable shadow map", [this](IDeviceContext* pCtx) {
+            m_ShadowMapMgr.ConvertToFilterable(pCtx, m_LightAttribs.ShadowAttribs);
+        });
+        m_pFrameGraph->AddRead(FilterPass, ShadowMap, RESOURCE_STATE_SHADER_RESOURCE);
+        m_pFrameGraph->AddWrite(FilterPass, ShadowSRV, RESOURCE_STATE_RENDER_TARGET);
+    }
+
+    const auto ScenePass = m_pFrameGraph->AddPass("Scene", [this, pRTV, pDSV](IDeviceContext* /*pCtx*/) {
+        RenderScene(pRTV, pDSV);
+    });
+    m_pFrameGraph->AddRead(ScenePass, ShadowSRV, RESOURCE_STATE_SHADER_RESOURCE);
+    m_pFrameGraph->AddWrite(ScenePass, BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+    m_pFrameGraph->AddWrite(ScenePass, DepthBuffer, RESOURCE_STATE_DEPTH_WRITE);
+
+    m_pFrameGraph->Execute(m_pImmediateContext);
+}
+
+void ShadowsSample::RenderScene(ITextureView* pRTV, ITextureView* pDSV)
+{
+    // Render targets are transitioned to the required states by the frame graph
+    m_pImmediateContext->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
     // Clear the back buffer
     const float ClearColor[] = {0.23f, 0.5f, 0.74f, 1.0f};
-    m_pImmediateContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-    m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    m_pImmediateContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+    m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
     {
         MapHelper<LightAttribs> LightData(m_pImmediateContext, m_LightAttribsCB, MAP_WRITE, MAP_FLAG_DISCARD);
@@ -638,8 +681,24 @@ void ShadowsSample::Update(double CurrTime, double ElapsedTime)
 {
     SampleBase::Update(CurrTime, ElapsedTime);
     UpdateUI();
+    UpdateView(CurrTime, static_cast<float>(ElapsedTime));
+}
 
-    m_Camera.Update(m_InputController, static_cast<float>(ElapsedTime));
+void ShadowsSample::LateLatchInput(double CurrTime)
+{
+    // Apply the mouse motion received since the update. The time step is zero, so
+    // the camera only rotates and the keys do not move it for the second time.
+    UpdateView(CurrTime, 0);
+}
+
+void ShadowsSample::UpdateView(double CurrTime, float ElapsedTime)
+{
+    m_Camera.Update(m_InputController, ElapsedTime);
+    {
+        auto Pose = m_Camera.GetPose();
+        UpdateCameraPose(CurrTime, Pose);
+        m_Camera.SetPose(Pose);
+    }
     {
         const auto& mouseState = m_InputController.GetMouseState();
         if (m_LastMouseState.PosX >= 0 &&
@@ -32,6 +32,7 @@
 #include "DXSDKMeshLoader.hpp"
 #include "FirstPersonCamera.hpp"
 #include "ShadowMapManager.hpp"
+#include "FrameGraph.hpp"
 
 namespace Diligent
 {
@@ -55,6 +56,9 @@ public:
     virtual void Render() override final;
     virtual void Update(double CurrTime, double ElapsedTime) override final;
 
+    virtual bool SupportsLateInputLatching() const override final { return true; }
+    virtual void LateLatchInput(double CurrTime) override final;
+
     virtual const Char* GetSampleName() const override final { return "Shadows Sample"; }
 
     virtual void WindowResize(Uint32 Width, Uint32 Height) override final;
@@ -65,7 +69,9 @@ private:
     void InitializeResourceBindings();
     void CreateShadowMap();
     void RenderShadowMap();
+    void RenderScene(ITextureView* pRTV, ITextureView* pDSV);
     void UpdateUI();
+    void UpdateView(double CurrTime, float ElapsedTime);
 
     static void DXSDKMESH_VERTEX_ELEMENTtoInputLayoutDesc(const DXSDKMESH_VERTEX_ELEMENT* VertexElement,
                                                           Uint32                          Stride,
@@ -95,6 +101,8 @@ private:
 
     ShadowMapManager m_ShadowMapMgr;
 
+    std::unique_ptr<FrameGraph> m_pFrameGraph;
+
     RefCntAutoPtr<IBuffer>                             m_CameraAttribsCB;
     RefCntAutoPtr<IBuffer>                             m_LightAttribsCB;
     std::vector<Uint32>                                m_PSOIndex;
@@ -0,0 +1,248 @@
+#!/bin/bash
+
+#  Linux counterpart of ProcessGoldenImages.bat that runs the samples in parallel
+#  in headless mode with the software adapter.
+#
+#  usage: ProcessGoldenImages.sh [options] build_folder mode backend...
+#
+#    build_folder: path to the root of the build tree
+#    mode:         capture or compare
+#    backend...:   rendering backends to run (vk; gl falls back to vk in headless mode)
+#
+#  options:
+#    -j jobs:      number of samples to run at once (default: number of CPU cores)
+#    -t seconds:   per-sample timeout (default: 300)
+#    -r prefix:    report file prefix; prefix.json and prefix.xml (JUnit) are written
+#                  (default: golden_images_report)
+#
+#  example:  ./ProcessGoldenImages.sh -j 8 -t 120 ~/Projects/DiligentEngine/build compare vk
+
+img_width=512
+img_height=512
+
+num_jobs=$(nproc)
+timeout_sec=300
+report_prefix=golden_images_report
+
+while getopts "j:t:r:" opt; do
+    case $opt in
+        j) num_jobs=$OPTARG ;;
+        t) timeout_sec=$OPTARG ;;
+        r) report_prefix=$OPTARG ;;
+        *) echo "Usage: $0 [-j jobs] [-t timeout] [-r report_prefix] build_folder mode backend..."; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -lt 3 ]; then
+    echo "Usage: $0 [-j jobs] [-t timeout] [-r report_prefix] build_folder mode backend..."
+    exit 1
+fi
+
+build_folder=$(realpath "$1")
+golden_img_mode=$2
+shift 2
+backends=("$@")
+
+if [ "$golden_img_mode" != "capture" ] && [ "$golden_img_mode" != "compare" ]; then
+    echo "Unknown golden image mode '$golden_img_mode'. Allowed values: capture, compare"
+    exit 1
+fi
+
+tests_dir=$(realpath "$(dirname "${BASH_SOURCE[0]}")")
+samples_root=$(realpath "$tests_dir/../..")
+
+tutorials="Tutorial01_HelloTriangle
+           Tutorial02_Cube
+           Tutorial03_Texturing
+           Tutorial03_Texturing-C
+           Tutorial04_Instancing
+           Tutorial05_TextureArray
+           Tutorial06_Multithreading
+           Tutorial07_GeometryShader
+           Tutorial08_Tessellation
+           Tutorial09_Quads
+           Tutorial10_DataStreaming
+           Tutorial11_ResourceUpdates
+           Tutorial12_RenderTarget
+           Tutorial13_ShadowMap
+           Tutorial14_ComputeShader
+           Tutorial16_BindlessResources
+           Tutorial17_MSAA"
+
+samples="Atmosphere
+         GLTFViewer
+         NuklearDemo
+         Shadows"
+
+#  ImguiDemo has fps counter in the UI, so we have to skip it
+
+results_dir=$(mktemp -d)
+trap 'rm -rf "$results_dir"' EXIT
+
+# Runs a single sample with a single backend and writes the result to $results_dir
+run_golden_img_test() {
+    local app_folder=$1
+    local app_name=$2
+    local backend=$3
+    local test_id=$4
+
+    local show_ui=1
+    if [ "$app_folder" == "Samples" ]; then
+        show_ui=0
+    fi
+
+    local app_path="$build_folder/DiligentSamples/$app_folder/$app_name/$app_name"
+    local golden_img_dir="$tests_dir/$app_folder/$app_name"
+    local log_file="$results_dir/$test_id.log"
+    mkdir -p "$golden_img_dir"
+
+    local start_time
+    start_time=$(date +%s.%N)
+
+    local exit_code
+    if [ -x "$app_path" ]; then
+        # Samples load their assets from the current directory
+        (cd "$samples_root/$app_folder/$app_name/assets" &&
+            timeout --kill-after=10 "$timeout_sec" "$app_path" \
+                -mode "$backend" -adapter sw -headless ${img_width}x${img_height} \
+                -golden_image_mode "$golden_img_mode" -golden_image_diff 1 \
+                -capture_path "$golden_img_dir" -capture_name "${app_name}_gi_${backend}" -capture_format png \
+                -adapters_dialog 0 -show_ui $show_ui) > "$log_file" 2>&1
+        exit_code=$?
+    else
+        echo "Executable $app_path is not found" > "$log_file"
+        exit_code=127
+    fi
+
+    local end_time
+    end_time=$(date +%s.%N)
+
+    local status=passed
+    if [ $exit_code -eq 124 ] || [ $exit_code -eq 137 ]; then
+        status=timeout
+    elif [ $exit_code -ne 0 ]; then
+        status=failed
+    fi
+
+    local wall_time
+    wall_time=$(awk "BEGIN { printf \"%.3f\", $end_time - $start_time }")
+
+    # The exit code only tells whether the images match, the number of mismatched
+    # pixels is taken from the log. It is 'none' when no comparison was made.
+    local mismatched_pixels
+    mismatched_pixels=$(sed -n 's/.*Golden image comparison: \([0-9]\+\) mismatched pixels.*/\1/p' "$log_file" | tail -n 1)
+    [ -n "$mismatched_pixels" ] || mismatched_pixels=none
+
+    echo "$app_folder $app_name $backend $status $exit_code $wall_time $mismatched_pixels" > "$results_dir/$test_id.result"
+
+    case $status in
+        passed)  echo "Golden image $golden_img_mode passed for $app_name [$backend] in ${wall_time}s" ;;
+        timeout) echo "Golden image $golden_img_mode timed out for $app_name [$backend] after ${timeout_sec}s" ;;
+        *)       echo "Golden image $golden_img_mode failed for $app_name [$backend]: exit code $exit_code, mismatched pixels: $mismatched_pixels" ;;
+    esac
+}
+
+xml_escape() {
+    sed -e 's/&/\&amp;/g' -e 's/</\&lt;/g' -e 's/>/\&gt;/g' -e 's/"/\&quot;/g'
+}
+
+json_escape() {
+    sed -e 's/\\/\\\\/g' -e 's/"/\\"/g' -e 's/\t/\\t/g' | awk 'BEGIN { ORS = "" } { if (NR > 1) print "\\n"; print }'
+}
+
+total_start_time=$(date +%s.%N)
+
+test_id=0
+for backend in "${backends[@]}"; do
+    for app_folder in Tutorials Samples; do
+        if [ "$app_folder" == "Tutorials" ]; then
+            apps=$tutorials
+        else
+            apps=$samples
+        fi
+
+        for app_name in $apps; do
+            # Limit the number of concurrently running samples
+            while [ "$(jobs -rp | wc -l)" -ge "$num_jobs" ]; do
+                wait -n
+            done
+            test_id=$((test_id + 1))
+            run_golden_img_test "$app_folder" "$app_name" "$backend" "$(printf "%04d" $test_id)" &
+        done
+    done
+done
+wait
+
+total_end_time=$(date +%s.%N)
+total_time=$(awk "BEGIN { printf \"%.3f\", $total_end_time - $total_start_time }")
+
+num_tests=0
+num_failures=0
+num_timeouts=0
+
+json_results=""
+junit_cases=""
+for result_file in "$results_dir"/*.result; do
+    [ -e "$result_file" ] || continue
+    read -r app_folder app_name backend status exit_code wall_time mismatched_pixels < "$result_file"
+    log_file="${result_file%.result}.log"
+
+    num_tests=$((num_tests + 1))
+    [ "$status" == "failed" ] && num_failures=$((num_failures + 1))
+    [ "$status" == "timeout" ] && num_timeouts=$((num_timeouts + 1))
+
+    [ -n "$json_results" ] && json_results+=","
+    json_results+="
+    {\"folder\": \"$app_folder\", \"name\": \"$app_name\", \"backend\": \"$backend\", \"status\": \"$status\", \"exit_code\": $exit_code, \"time\": $wall_time"
+    if [ "$mismatched_pixels" == "none" ]; then
+        json_results+=", \"mismatched_pixels\": null"
+    else
+        json_results+=", \"mismatched_pixels\": $mismatched_pixels"
+    fi
+    if [ "$status" != "passed" ]; then
+        json_results+=", \"log\": \"$(tail -n 50 "$log_file" | json_escape)\""
+    fi
+    json_results+="}"
+
+    junit_cases+="
+    <testcase classname=\"$app_folder.$backend\" name=\"$app_name\" time=\"$wall_time\">"
+    case $status in
+        failed)  junit_cases+="
+      <failure message=\"Exit code $exit_code, mismatched pixels: $mismatched_pixels\">$(tail -n 50 "$log_file" | xml_escape)</failure>" ;;
+        timeout) junit_cases+="
+      <error message=\"Timed out after ${timeout_sec}s\">$(tail -n 50 "$log_file" | xml_escape)</error>" ;;
+    esac
+    junit_cases+="
+    </testcase>"
+done
+
+cat > "$report_prefix.json" << EOF
+{
+  "mode": "$golden_img_mode",
+  "jobs": $num_jobs,
+  "time": $total_time,
+  "tests": $num_tests,
+  "failures": $num_failures,
+  "timeouts": $num_timeouts,
+  "results": [$json_results
+  ]
+}
+EOF
+
+cat > "$report_prefix.xml" << EOF
+<?xml version="1.0" encoding="UTF-8"?>
+<testsuites tests="$num_tests" failures="$num_failures" errors="$num_timeouts" time="$total_time">
+  <testsuite name="GoldenImages.$golden_img_mode" tests="$num_tests" failures="$num_failures" errors="$num_timeouts" time="$total_time">$junit_cases
+  </testsuite>
+</testsuites>
+EOF
+
+echo
+echo "$num_tests tests, $num_failures failed, $num_timeouts timed out in ${total_time}s"
+echo "Reports: $report_prefix.json, $report_prefix.xml"
+
+if [ $num_failures -ne 0 ] || [ $num_timeouts -ne 0 ]; then
+    exit 1
+fi
+exit 0
@@ -138,17 +138,22 @@ RefCntAutoPtr<IBuffer> CreateIndexBuffer(IRenderDevice* pDevice)
     return pBuffer;
 }
 
-RefCntAutoPtr<ITexture> LoadTexture(IRenderDevice* pDevice, const char* Path)
+void LoadTexture(AsyncTextureLoader* pLoader, const char* Path, std::function<void(ITextureView* pTextureSRV)> SetTexture)
 {
     TextureLoadInfo loadInfo;
     loadInfo.IsSRGB = true;
-    RefCntAutoPtr<ITexture> pTex;
-    CreateTextureFromFile(Path, loadInfo, pDevice, &pTex);
-    return pTex;
+
+    // The placeholder is kept if the texture fails to load
+    auto* pPlaceholderSRV = pLoader->LoadTexture(Path, loadInfo, [SetTexture](ITexture* pTexture) {
+        if (pTexture != nullptr)
+            SetTexture(pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+    });
+    SetTexture(pPlaceholderSRV);
 }
 
 
 RefCntAutoPtr<IPipelineState> CreatePipelineState(IRenderDevice*                   pDevice,
+                                                  ShaderCache*                     pShaderCache,
                                                   TEXTURE_FORMAT                   RTVFormat,
                                                   TEXTURE_FORMAT                   DSVFormat,
                                                   IShaderSourceInputStreamFactory* pShaderSourceFactory,
@@ -199,7 +204,7 @@ RefCntAutoPtr<IPipelineState> CreatePipelineState(IRenderDevice*
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = VSFilePath;
-        pDevice->CreateShader(ShaderCI, &pVS);
+        pShaderCache->CreateShader(ShaderCI, &pVS);
     }
 
     // Create a pixel shader
@@ -209,7 +214,7 @@ RefCntAutoPtr<IPipelineState> CreatePipelineState(IRenderDevice*
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = PSFilePath;
-        pDevice->CreateShader(ShaderCI, &pPS);
+        pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     // Define vertex shader input layout
@@ -27,9 +27,13 @@
 
 #pragma once
 
+#include <functional>
+
 #include "RenderDevice.h"
 #include "Buffer.h"
 #include "RefCntAutoPtr.hpp"
+#include "ShaderCache.hpp"
+#include "AsyncTextureLoader.hpp"
 
 namespace Diligent
 {
@@ -39,9 +43,14 @@ namespace TexturedCube
 
 RefCntAutoPtr<IBuffer>  CreateVertexBuffer(IRenderDevice* pDevice);
 RefCntAutoPtr<IBuffer>  CreateIndexBuffer(IRenderDevice* pDevice);
-RefCntAutoPtr<ITexture> LoadTexture(IRenderDevice* pDevice, const char* Path);
+
+// Loads the sRGB texture in the background. SetTexture is called right away with the placeholder SRV, and
+// again from AsyncTextureLoader::Update() with the SRV of the loaded texture. The texture is in the shader
+// resource state by then. Mutable shader variables can only be set once, so SetTexture typically creates a new SRB.
+void LoadTexture(AsyncTextureLoader* pLoader, const char* Path, std::function<void(ITextureView* pTextureSRV)> SetTexture);
 
 RefCntAutoPtr<IPipelineState> CreatePipelineState(IRenderDevice*                   pDevice,
+                                                  ShaderCache*                     pShaderCache,
                                                   TEXTURE_FORMAT                   RTVFormat,
                                                   TEXTURE_FORMAT                   DSVFormat,
                                                   IShaderSourceInputStreamFactory* pShaderSourceFactory,
@@ -133,7 +133,7 @@ void Tutorial01_HelloTriangle::Initialize(IEngineFactory*  pEngineFactory,
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Triangle vertex shader";
         ShaderCI.Source          = VSSource;
-        pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
     }
 
     // Create a pixel shader
@@ -143,7 +143,7 @@ void Tutorial01_HelloTriangle::Initialize(IEngineFactory*  pEngineFactory,
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Triangle pixel shader";
         ShaderCI.Source          = PSSource;
-        pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     // Finally, create the pipeline state
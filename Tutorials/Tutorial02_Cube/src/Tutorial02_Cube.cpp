@@ -28,6 +28,7 @@
 #include "Tutorial02_Cube.hpp"
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -75,7 +76,7 @@ void Tutorial02_Cube::CreatePipelineState()
     // In this tutorial, we will load shaders from file. To be able to do that,
     // we need to create a shader source stream factory
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -84,7 +85,7 @@ void Tutorial02_Cube::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = "cube.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
         BufferDesc CBDesc;
@@ -103,7 +104,7 @@ void Tutorial02_Cube::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = "cube.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     // clang-format off
@@ -29,6 +29,8 @@
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -75,7 +77,7 @@ void Tutorial03_Texturing::CreatePipelineState()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -84,7 +86,7 @@ void Tutorial03_Texturing::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = "cube.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
         CreateUniformBuffer(m_pDevice, sizeof(float4x4), "VS constants CB", &m_VSConstants);
@@ -97,7 +99,7 @@ void Tutorial03_Texturing::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = "cube.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     // clang-format off
@@ -262,7 +264,7 @@ void Tutorial03_Texturing::LoadTexture()
     TextureLoadInfo loadInfo;
     loadInfo.IsSRGB = true;
     RefCntAutoPtr<ITexture> Tex;
-    CreateTextureFromFile("DGLogo.png", loadInfo, m_pDevice, &Tex);
+    CreateTextureFromFilePreferCooked("DGLogo.png", loadInfo, m_pDevice, &Tex);
     // Get shader resource view from the texture
     m_TextureSRV = Tex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
 
@@ -33,6 +33,7 @@
 #include "TextureUtilities.h"
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -70,9 +71,10 @@ void Tutorial04_Instancing::CreatePipelineState()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     m_pPSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                               m_pShaderCache,
                                                m_pSwapChain->GetDesc().ColorBufferFormat,
                                                m_pSwapChain->GetDesc().DepthBufferFormat,
                                                pShaderSourceFactory,
@@ -134,9 +136,15 @@ void Tutorial04_Instancing::Initialize(IEngineFactory*  pEngineFactory,
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
     m_CubeIndexBuffer  = TexturedCube::CreateIndexBuffer(pDevice);
-    m_TextureSRV       = TexturedCube::LoadTexture(pDevice, "DGLogo.png")->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-    // Set cube texture SRV in the SRB
-    m_SRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureSRV);
+    // Load the texture in the background. Mutable variables can only be set once, so a new SRB
+    // is created when the placeholder texture is replaced with the loaded one.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_TextureSRV = pTextureSRV;
+        m_SRB.Release();
+        m_pPSO->CreateShaderResourceBinding(&m_SRB, true);
+        // Set cube texture SRV in the SRB
+        m_SRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureSRV);
+    });
 
     CreateInstanceBuffer();
 }
@@ -34,6 +34,7 @@
 #include "TextureUtilities.h"
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -84,9 +85,10 @@ void Tutorial05_TextureArray::CreatePipelineState()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     m_pPSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                               m_pShaderCache,
                                                m_pSwapChain->GetDesc().ColorBufferFormat,
                                                m_pSwapChain->GetDesc().DepthBufferFormat,
                                                pShaderSourceFactory,
@@ -124,36 +126,62 @@ void Tutorial05_TextureArray::CreateInstanceBuffer()
 
 void Tutorial05_TextureArray::LoadTextures()
 {
-    // Load a texture array
-    RefCntAutoPtr<ITexture> pTexArray;
+    TextureLoadInfo loadInfo;
+    loadInfo.IsSRGB = true;
+
+    // Load the textures in the background. The texture array is created when all of them
+    // are loaded, and the cubes are not drawn until then.
     for (int tex = 0; tex < NumTextures; ++tex)
     {
-        // Load current texture
         std::stringstream FileNameSS;
         FileNameSS << "DGLogo" << tex << ".png";
-        auto                    FileName = FileNameSS.str();
-        RefCntAutoPtr<ITexture> SrcTex   = TexturedCube::LoadTexture(m_pDevice, FileName.c_str());
-        const auto&             TexDesc  = SrcTex->GetDesc();
-        if (pTexArray == nullptr)
+        auto FileName = FileNameSS.str();
+        m_pTextureLoader->LoadTexture(FileName.c_str(), loadInfo, [this, tex](ITexture* pTexture) //
+                                      {
+                                          m_SrcTextures[tex] = pTexture;
+                                          if (++m_NumLoadedTextures == NumTextures)
+                                              CreateTextureArray();
+                                      });
+    }
+}
+
+void Tutorial05_TextureArray::CreateTextureArray()
+{
+    for (int tex = 0; tex < NumTextures; ++tex)
+    {
+        if (!m_SrcTextures[tex])
         {
-            //	Create texture array
-            auto TexArrDesc      = TexDesc;
-            TexArrDesc.ArraySize = NumTextures;
-            TexArrDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
-            TexArrDesc.Usage     = USAGE_DEFAULT;
-            TexArrDesc.BindFlags = BIND_SHADER_RESOURCE;
-            m_pDevice->CreateTexture(TexArrDesc, nullptr, &pTexArray);
+            LOG_ERROR_MESSAGE("Failed to load texture ", tex, ": the texture array can't be created");
+            return;
         }
+    }
+
+    // Create texture array
+    RefCntAutoPtr<ITexture> pTexArray;
+    {
+        auto TexArrDesc      = m_SrcTextures[0]->GetDesc();
+        TexArrDesc.ArraySize = NumTextures;
+        TexArrDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+        TexArrDesc.Usage     = USAGE_DEFAULT;
+        TexArrDesc.BindFlags = BIND_SHADER_RESOURCE;
+        m_pDevice->CreateTexture(TexArrDesc, nullptr, &pTexArray);
+    }
+
+    for (int tex = 0; tex < NumTextures; ++tex)
+    {
         // Copy current texture into the texture array
+        const auto& TexDesc = m_SrcTextures[tex]->GetDesc();
         for (Uint32 mip = 0; mip < TexDesc.MipLevels; ++mip)
         {
-            CopyTextureAttribs CopyAttribs(SrcTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+            CopyTextureAttribs CopyAttribs(m_SrcTextures[tex], RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
                                            pTexArray, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
             CopyAttribs.SrcMipLevel = mip;
             CopyAttribs.DstMipLevel = mip;
             CopyAttribs.DstSlice    = tex;
             m_pImmediateContext->CopyTexture(CopyAttribs);
         }
+        // The source texture is no longer needed
+        m_SrcTextures[tex].Release();
     }
 
     // Get shader resource view from the texture array
@@ -249,6 +277,10 @@ void Tutorial05_TextureArray::Render()
     m_pImmediateContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
     m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 
+    // The texture array is created when all textures are loaded
+    if (!m_TextureSRV)
+        return;
+
     {
         // Map the buffer and write current world-view-projection matrix
         MapHelper<float4x4> CBConstants(m_pImmediateContext, m_VSConstants, MAP_WRITE, MAP_FLAG_DISCARD);
@@ -51,6 +51,7 @@ private:
     void CreatePipelineState();
     void CreateInstanceBuffer();
     void LoadTextures();
+    void CreateTextureArray();
     void UpdateUI();
     void PopulateInstanceBuffer();
 
@@ -68,6 +69,10 @@ private:
     static constexpr int MaxGridSize  = 32;
     static constexpr int MaxInstances = MaxGridSize * MaxGridSize * MaxGridSize;
     static constexpr int NumTextures  = 4;
+
+    // Source textures of the array that have been loaded so far
+    RefCntAutoPtr<ITexture> m_SrcTextures[NumTextures];
+    int                     m_NumLoadedTextures = 0;
 };
 
 } // namespace Diligent
@@ -25,17 +25,24 @@
  *  of the possibility of such damages.
  */
 
-#include <random>
 #include <string>
 #include <algorithm>
+#include <thread>
 
 #include "Tutorial06_Multithreading.hpp"
-#include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
+#include "AssetArchive.hpp"
+#include "Timer.hpp"
+#include "CPUProfiler.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define TUTORIAL06_USE_SSE2 1
+#    include <emmintrin.h>
+#endif
 
 namespace Diligent
 {
@@ -45,9 +52,102 @@ SampleBase* CreateSample()
     return new Tutorial06_Multithreading();
 }
 
+namespace
+{
+
+// Counter-based random number generator: every value is a hash of the instance index and the index
+// of the value within the instance, so the result does not depend on the number of threads or on
+// the order in which the instances are generated.
+class InstanceRandom
+{
+public:
+    explicit InstanceRandom(Uint32 InstanceIdx) :
+        m_Counter{InstanceIdx * NumValuesPerInstance}
+    {}
+
+    // Returns a uniformly distributed value in [Min, Max)
+    float operator()(float Min, float Max)
+    {
+        return Min + (Max - Min) * static_cast<float>(Next() >> 8) * (1.f / 16777216.f);
+    }
+
+    // Returns a uniformly distributed value in [0, Count)
+    Uint32 operator()(Uint32 Count)
+    {
+        return static_cast<Uint32>((Uint64{Next()} * Count) >> 32);
+    }
+
+    static constexpr Uint32 NumValuesPerInstance = 8;
+
+private:
+    Uint32 Next()
+    {
+        // Integer hash with low bias (https://nullprogram.com/blog/2018/07/31/)
+        Uint32 x = m_Counter++;
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    Uint32 m_Counter;
+};
+
+// Computes the upper 3x3 block of A * B, where the fourth rows and columns of A and B are (0, 0, 0, 1)
+void MultiplyRotations(const float4x4& A, const float4x4& B, float4x4& Res)
+{
+#if TUTORIAL06_USE_SSE2
+    // Every row of the product is a linear combination of the rows of B
+    const __m128 B0 = _mm_loadu_ps(B[0]);
+    const __m128 B1 = _mm_loadu_ps(B[1]);
+    const __m128 B2 = _mm_loadu_ps(B[2]);
+    for (int r = 0; r < 3; ++r)
+    {
+        __m128 Row = _mm_mul_ps(_mm_set1_ps(A[r][0]), B0);
+        Row        = _mm_add_ps(Row, _mm_mul_ps(_mm_set1_ps(A[r][1]), B1));
+        Row        = _mm_add_ps(Row, _mm_mul_ps(_mm_set1_ps(A[r][2]), B2));
+        _mm_storeu_ps(Res[r], Row);
+    }
+#else
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+            Res[r][c] = A[r][0] * B[0][c] + A[r][1] * B[1][c] + A[r][2] * B[2][c];
+        Res[r][3] = 0;
+    }
+#endif
+}
+
+// Writes rotation * scale(Scale) * translation(Offset) to Res. Since the rotation only
+// has the upper 3x3 block, the scale and the translation do not require matrix products.
+void ComposeInstanceMatrix(const float4x4& Rotation, float Scale, const float3& Offset, float4x4& Res)
+{
+#if TUTORIAL06_USE_SSE2
+    const __m128 vScale = _mm_set1_ps(Scale);
+    for (int r = 0; r < 3; ++r)
+        _mm_storeu_ps(Res[r], _mm_mul_ps(_mm_loadu_ps(Rotation[r]), vScale));
+#else
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+            Res[r][c] = Rotation[r][c] * Scale;
+    }
+#endif
+    Res[3][0] = Offset.x;
+    Res[3][1] = Offset.y;
+    Res[3][2] = Offset.z;
+    Res[3][3] = 1;
+}
+
+} // namespace
+
 Tutorial06_Multithreading::~Tutorial06_Multithreading()
 {
-    StopWorkerThreads();
+    // The worker threads may still be recording the next frame or generating the instances
+    WaitForCommandLists();
+    DiscardNextFrame();
 }
 
 void Tutorial06_Multithreading::GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
@@ -55,12 +155,28 @@ void Tutorial06_Multithreading::GetEngineInitializationAttribs(RENDER_DEVICE_TYP
                                                                SwapChainDesc&     SCDesc)
 {
     SampleBase::GetEngineInitializationAttribs(DeviceType, Attribs, SCDesc);
-    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency() - 1, 2u);
+    // Every job system thread, including the main thread, records commands into its own deferred context
+    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency(), 2u);
 #if VULKAN_SUPPORTED
     if (DeviceType == RENDER_DEVICE_TYPE_VULKAN)
     {
-        auto& VkAttrs           = static_cast<EngineVkCreateInfo&>(Attribs);
-        VkAttrs.DynamicHeapSize = 26 << 20; // Enough space for 32x32x32x256 bytes allocations for 3 frames
+        // Every map of the instance data ring buffer with MAP_FLAG_DISCARD allocates a new copy of the buffer
+        // in the dynamic heap, which is only released when the GPU has finished the frame. Every command list
+        // discards the buffer when it starts and whenever the buffer is full, and all command lists of the frame
+        // together draw at most MaxGridSize^3 instances.
+        const Uint32 MaxCmdListsPerFrame = Attribs.NumDeferredContexts * CommandListChunksPerThread;
+        const Uint32 MaxGridInstances    = MaxGridSize * MaxGridSize * MaxGridSize;
+        const Uint32 MaxDiscardsPerFrame = MaxCmdListsPerFrame + (MaxGridInstances + InstanceRingBufferSize - 1) / InstanceRingBufferSize;
+
+        // Up to 3 frames may be in flight on the GPU, and the worker threads record one more frame while
+        // the current one is presented. Every context may also leave one dynamic heap page partially used.
+        static constexpr Uint32 MaxFramesInFlight = 3;
+
+        auto&        VkAttrs        = static_cast<EngineVkCreateInfo&>(Attribs);
+        const Uint64 RingBufferSize = sizeof(float4x4) * InstanceRingBufferSize;
+        const Uint64 FrameHeapSize  = MaxDiscardsPerFrame * RingBufferSize + (Attribs.NumDeferredContexts + 1) * Uint64{VkAttrs.DynamicHeapPageSize};
+        const Uint64 HeapSize       = (MaxFramesInFlight + 1) * FrameHeapSize;
+        VkAttrs.DynamicHeapSize     = static_cast<Uint32>(std::max(HeapSize, Uint64{VkAttrs.DynamicHeapSize}));
     }
 #endif
 }
@@ -69,55 +185,207 @@ void Tutorial06_Multithreading::CreatePipelineState(std::vector<StateTransitionD
 {
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
+
+    // clang-format off
+    LayoutElement LayoutElems[] =
+    {
+        // Per-vertex data - first buffer slot
+        // Attribute 0 - vertex position
+        LayoutElement{0, 0, 3, VT_FLOAT32, False},
+        // Attribute 1 - texture coordinates
+        LayoutElement{1, 0, 2, VT_FLOAT32, False},
+
+        // Per-instance data - second buffer slot
+        // Instance transform matrix rows are read from the instance data ring buffer
+        LayoutElement{2, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{3, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{4, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{5, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE}
+    };
+    // clang-format on
 
     m_pPSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                               m_pShaderCache,
                                                m_pSwapChain->GetDesc().ColorBufferFormat,
                                                m_pSwapChain->GetDesc().DepthBufferFormat,
                                                pShaderSourceFactory,
                                                "cube.vsh",
-                                               "cube.psh");
-
-    // Create dynamic uniform buffer that will store our transformation matrix
-    // Dynamic buffers can be frequently updated by the CPU
-    CreateUniformBuffer(m_pDevice, sizeof(float4x4) * 2, "VS constants CB", &m_VSConstants);
-    CreateUniformBuffer(m_pDevice, sizeof(float4x4), "Instance constants CB", &m_InstanceConstants);
-    // Explicitly transition the buffers to RESOURCE_STATE_CONSTANT_BUFFER state
+                                               "cube.psh",
+                                               LayoutElems,
+                                               _countof(LayoutElems));
+
+    // Create uniform buffer that will store our transformation matrices. The matrices are the same for all
+    // contexts, so the buffer is updated once per frame by the immediate context rather than mapped by every
+    // deferred context. This also lets cached command lists reference the buffer in later frames.
+    BufferDesc CBDesc;
+    CBDesc.Name          = "VS constants CB";
+    CBDesc.uiSizeInBytes = sizeof(float4x4) * 2;
+    CBDesc.Usage         = USAGE_DEFAULT;
+    CBDesc.BindFlags     = BIND_UNIFORM_BUFFER;
+    m_pDevice->CreateBuffer(CBDesc, nullptr, &m_VSConstants);
+    // Explicitly transition the buffer to RESOURCE_STATE_CONSTANT_BUFFER state
     Barriers.emplace_back(m_VSConstants, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_CONSTANT_BUFFER, true);
-    Barriers.emplace_back(m_InstanceConstants, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_CONSTANT_BUFFER, true);
 
-    // Since we did not explcitly specify the type for 'Constants' and 'InstanceData' variables,
-    // default type (SHADER_RESOURCE_VARIABLE_TYPE_STATIC) will be used. Static variables
+    // Instance matrices are sub-allocated from a ring buffer that every context maps once
+    // rather than mapping a constant buffer for every draw call
+    m_pInstanceDataBuffer.reset(new DynamicRingBuffer{m_pDevice, "Instance data ring buffer", BIND_VERTEX_BUFFER,
+                                                      sizeof(float4x4) * InstanceRingBufferSize,
+                                                      static_cast<Uint32>(1 + m_pDeferredContexts.size())});
+    Barriers.emplace_back(m_pInstanceDataBuffer->GetBuffer(), RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true);
+
+    // Since we did not explcitly specify the type for 'Constants' variable, default
+    // type (SHADER_RESOURCE_VARIABLE_TYPE_STATIC) will be used. Static variables
     // never change and are bound directly to the pipeline state object.
     m_pPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "Constants")->Set(m_VSConstants);
-    m_pPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "InstanceData")->Set(m_InstanceConstants);
 }
 
-void Tutorial06_Multithreading::LoadTextures(std::vector<StateTransitionDesc>& Barriers)
+void Tutorial06_Multithreading::CreateInstancedPipelineState(std::vector<StateTransitionDesc>& Barriers)
 {
-    // Load textures
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
+
+    // clang-format off
+    LayoutElement LayoutElems[] =
+    {
+        // Per-vertex data - first buffer slot
+        // Attribute 0 - vertex position
+        LayoutElement{0, 0, 3, VT_FLOAT32, False},
+        // Attribute 1 - texture coordinates
+        LayoutElement{1, 0, 2, VT_FLOAT32, False},
+
+        // Per-instance data - second buffer slot
+        // Attributes 2 to 5 - instance transform matrix rows
+        LayoutElement{2, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{3, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{4, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        LayoutElement{5, 1, 4, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE},
+        // Attribute 6 - texture array index
+        LayoutElement{6, 1, 1, VT_FLOAT32, False, INPUT_ELEMENT_FREQUENCY_PER_INSTANCE}
+    };
+    // clang-format on
+
+    m_pInstancedPSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                                        m_pShaderCache,
+                                                        m_pSwapChain->GetDesc().ColorBufferFormat,
+                                                        m_pSwapChain->GetDesc().DepthBufferFormat,
+                                                        pShaderSourceFactory,
+                                                        "cube_inst.vsh",
+                                                        "cube_inst.psh",
+                                                        LayoutElems,
+                                                        _countof(LayoutElems));
+    m_pInstancedPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "Constants")->Set(m_VSConstants);
+
+    BufferDesc InstBuffDesc;
+    InstBuffDesc.Name = "Instance data buffer";
+    // Use default usage as this buffer is only updated when the grid size changes
+    InstBuffDesc.Usage         = USAGE_DEFAULT;
+    InstBuffDesc.BindFlags     = BIND_VERTEX_BUFFER;
+    InstBuffDesc.uiSizeInBytes = sizeof(InstanceAttribs) * MaxGridSize * MaxGridSize * MaxGridSize;
+    m_pDevice->CreateBuffer(InstBuffDesc, nullptr, &m_InstanceBuffer);
+    Barriers.emplace_back(m_InstanceBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true);
+}
+
+void Tutorial06_Multithreading::LoadTextures()
+{
+    TextureLoadInfo LoadInfo;
+    LoadInfo.IsSRGB = true;
+
+    // Load textures in the background. Until a texture is loaded, its SRB references the placeholder texture.
     for (int tex = 0; tex < NumTextures; ++tex)
     {
-        // Load current texture
         std::stringstream FileNameSS;
         FileNameSS << "DGLogo" << tex << ".png";
         auto FileName = FileNameSS.str();
 
-        RefCntAutoPtr<ITexture> SrcTex = TexturedCube::LoadTexture(m_pDevice, FileName.c_str());
-        // Get shader resource view from the texture
-        m_TextureSRV[tex] = SrcTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        // Transition textures to shader resource state
-        Barriers.emplace_back(SrcTex, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
+        auto* pPlaceholderSRV = m_pTextureLoader->LoadTexture(
+            FileName.c_str(), LoadInfo,
+            [this, tex](ITexture* pTexture) //
+            {
+                if (pTexture != nullptr)
+                    SetTexture(tex, pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+            });
+        SetTexture(tex, pPlaceholderSRV);
+    }
+}
+
+void Tutorial06_Multithreading::SetTexture(int TexIdx, ITextureView* pTextureSRV)
+{
+    // Commands of the next frame may have been recorded with the old SRB
+    DiscardNextFrame();
+
+    m_TextureSRV[TexIdx] = pTextureSRV;
+
+    // Create one Shader Resource Binding for every texture
+    // http://diligentgraphics.com/2016/03/23/resource-binding-model-in-diligent-engine-2-0/
+    // Mutable variables can only be set once, so a new SRB is created when the texture is replaced.
+    m_SRB[TexIdx].Release();
+    m_pPSO->CreateShaderResourceBinding(&m_SRB[TexIdx], true);
+    m_SRB[TexIdx]->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(pTextureSRV);
+
+    // The texture array is rebuilt on the next update, after all textures loaded in the same frame have been set
+    m_bTextureArrayDirty = true;
+    // Cached command lists reference the old SRB
+    m_CachedCmdLists.clear();
+}
+
+void Tutorial06_Multithreading::UpdateTextureArray()
+{
+    // Source textures are transitioned while the array is updated, so the worker
+    // threads must not verify their states at the same time
+    DiscardNextFrame();
+
+    // Textures can only be copied into the array when all of them have the same description, which is the
+    // case when all of them are placeholders or all of them are loaded. Otherwise, the previous array is kept.
+    const auto& FirstDesc = m_TextureSRV[0]->GetTexture()->GetDesc();
+    for (int tex = 1; tex < NumTextures; ++tex)
+    {
+        const auto& Desc = m_TextureSRV[tex]->GetTexture()->GetDesc();
+        if (Desc.Width != FirstDesc.Width || Desc.Height != FirstDesc.Height || Desc.MipLevels != FirstDesc.MipLevels || Desc.Format != FirstDesc.Format)
+            return;
+    }
+
+    auto TexArrDesc      = FirstDesc;
+    TexArrDesc.Name      = "Cube texture array";
+    TexArrDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    TexArrDesc.ArraySize = NumTextures;
+    TexArrDesc.Usage     = USAGE_DEFAULT;
+    TexArrDesc.BindFlags = BIND_SHADER_RESOURCE;
+    TexArrDesc.MiscFlags = MISC_TEXTURE_FLAG_NONE;
+
+    RefCntAutoPtr<ITexture> pTexArray;
+    m_pDevice->CreateTexture(TexArrDesc, nullptr, &pTexArray);
+    if (!pTexArray)
+    {
+        LOG_ERROR_MESSAGE("Failed to create cube texture array");
+        return;
     }
 
-    // Set texture SRV in the SRB
+    std::vector<StateTransitionDesc> Barriers;
     for (int tex = 0; tex < NumTextures; ++tex)
     {
-        // Create one Shader Resource Binding for every texture
-        // http://diligentgraphics.com/2016/03/23/resource-binding-model-in-diligent-engine-2-0/
-        m_pPSO->CreateShaderResourceBinding(&m_SRB[tex], true);
-        m_SRB[tex]->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureSRV[tex]);
+        auto* pSrcTex = m_TextureSRV[tex]->GetTexture();
+        for (Uint32 mip = 0; mip < TexArrDesc.MipLevels; ++mip)
+        {
+            CopyTextureAttribs CopyAttribs(pSrcTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                           pTexArray, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            CopyAttribs.SrcMipLevel = mip;
+            CopyAttribs.DstMipLevel = mip;
+            CopyAttribs.DstSlice    = tex;
+            m_pImmediateContext->CopyTexture(CopyAttribs);
+        }
+
+        // Per-draw mode verifies that the textures are in shader resource state
+        if (std::none_of(Barriers.begin(), Barriers.end(), [pSrcTex](const StateTransitionDesc& Barrier) { return Barrier.pTexture == pSrcTex; }))
+            Barriers.emplace_back(pSrcTex, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
     }
+    Barriers.emplace_back(pTexArray, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
+    m_pImmediateContext->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
+
+    m_TextureArraySRV = pTexArray->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    m_InstancedSRB.Release();
+    m_pInstancedPSO->CreateShaderResourceBinding(&m_InstancedSRB, true);
+    m_InstancedSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureArraySRV);
 }
 
 void Tutorial06_Multithreading::UpdateUI()
@@ -125,18 +393,67 @@ void Tutorial06_Multithreading::UpdateUI()
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Settings", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
     {
-        if (ImGui::SliderInt("Grid Size", &m_GridSize, 1, 32))
+        if (ImGui::SliderInt("Grid Size", &m_GridSize, 1, MaxGridSize))
         {
-            PopulateInstanceData();
+            StartInstanceGeneration();
         }
+
+        const char* RenderModes[] = {"Per-draw", "Instanced", "Cached"};
+        static_assert(_countof(RenderModes) == static_cast<size_t>(RenderMode::NumModes), "Not all render modes are named");
+        ImGui::Combo("Render mode", reinterpret_cast<int*>(&m_RenderMode), RenderModes, _countof(RenderModes));
         {
-            ImGuiScopedDisabler Disable(m_MaxThreads == 0);
+            ImGuiScopedDisabler Disable(m_MaxThreads == 0 || m_RenderMode == RenderMode::Instanced);
             if (ImGui::SliderInt("Worker Threads", &m_NumWorkerThreads, 0, m_MaxThreads))
             {
-                StopWorkerThreads();
-                StartWorkerThreads(m_NumWorkerThreads);
+                DiscardNextFrame();
+                SetNumWorkerThreads(m_NumWorkerThreads);
+                // Start measuring the modes that record commands with the new number of threads
+                m_SubmitTime[static_cast<size_t>(RenderMode::PerDraw)] = 0;
+                m_SubmitTime[static_cast<size_t>(RenderMode::Cached)]  = 0;
+                m_CachedCmdLists.clear();
             }
         }
+        if (ImGui::Checkbox("Sort by texture", &m_bSortInstances))
+        {
+            // The instances are generated from the same seed, so only their order changes
+            StartInstanceGeneration();
+            m_SubmitTime[static_cast<size_t>(RenderMode::PerDraw)] = 0;
+        }
+        {
+            ImGuiScopedDisabler Disable(m_MaxThreads == 0 || m_RenderMode != RenderMode::PerDraw);
+            if (ImGui::Checkbox("Record next frame early", &m_bRecordNextFrame))
+                m_SubmitTime[static_cast<size_t>(RenderMode::PerDraw)] = 0;
+        }
+
+        // The last measured time of every mode is kept, so that switching between
+        // the modes compares them side by side on the same grid
+        ImGui::Text("CPU submit time:");
+        for (size_t mode = 0; mode < _countof(RenderModes); ++mode)
+        {
+            if (m_SubmitTime[mode] > 0)
+                ImGui::Text("  %-10s %.3f ms", RenderModes[mode], m_SubmitTime[mode] * 1000.0);
+            else if (mode == static_cast<size_t>(RenderMode::Cached) && !m_bCanReuseCommandLists)
+                ImGui::TextDisabled("  %-10s not supported", RenderModes[mode]);
+            else
+                ImGui::TextDisabled("  %-10s not measured", RenderModes[mode]);
+        }
+        // Cached command lists are only recorded when the grid changes, so the time of the last
+        // recording is shown next to the smoothed time of replaying the lists
+        if (m_CachedRecordTime > 0)
+            ImGui::Text("  %-10s %.3f ms", "Recording", m_CachedRecordTime * 1000.0);
+        else
+            ImGui::TextDisabled("  %-10s not measured", "Recording");
+        // Cached mode falls back to recording the command lists every frame, so no replay time is measured
+        if (m_RenderMode == RenderMode::Cached && !m_bCanReuseCommandLists)
+            ImGui::TextDisabled("Command lists are recorded every frame:\nthis backend cannot execute them again");
+        ImGui::Text("SRB switches: %u", m_LastFrameSRBSwitches);
+
+        if (!m_WorkerIdleFraction.empty())
+        {
+            ImGui::Text("Worker thread idle time:");
+            for (size_t i = 0; i < m_WorkerIdleFraction.size(); ++i)
+                ImGui::Text("  Worker %-2u %3.0f%%", static_cast<Uint32>(1 + i), m_WorkerIdleFraction[i] * 100.f);
+        }
     }
 
     ImGui::End();
@@ -150,12 +467,17 @@ void Tutorial06_Multithreading::Initialize(IEngineFactory*  pEngineFactory,
 {
     SampleBase::Initialize(pEngineFactory, pDevice, ppContexts, NumDeferredCtx, pSwapChain);
 
-    m_MaxThreads       = static_cast<int>(m_pDeferredContexts.size());
+    m_MaxThreads       = static_cast<int>(GetMaxWorkerThreads());
     m_NumWorkerThreads = std::min(4, m_MaxThreads);
 
+    // Only D3D11 command lists can be executed more than once. Other backends release
+    // the recorded commands when the list is executed, so the lists are recorded every frame.
+    m_bCanReuseCommandLists = pDevice->GetDeviceCaps().DevType == RENDER_DEVICE_TYPE_D3D11;
+
     std::vector<StateTransitionDesc> Barriers;
 
     CreatePipelineState(Barriers);
+    CreateInstancedPipelineState(Barriers);
 
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
@@ -163,184 +485,326 @@ void Tutorial06_Multithreading::Initialize(IEngineFactory*  pEngineFactory,
     // Explicitly transition vertex and index buffers to required states
     Barriers.emplace_back(m_CubeVertexBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true);
     Barriers.emplace_back(m_CubeIndexBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, true);
-    LoadTextures(Barriers);
+    LoadTextures();
 
     // Execute all barriers
     m_pImmediateContext->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
 
-    PopulateInstanceData();
+    // Instances are generated by the job system
+    SetNumWorkerThreads(m_NumWorkerThreads);
 
-    StartWorkerThreads(m_NumWorkerThreads);
+    StartInstanceGeneration();
+    FinishInstanceGeneration();
 }
 
-void Tutorial06_Multithreading::PopulateInstanceData()
+void Tutorial06_Multithreading::StartInstanceGeneration()
 {
-    m_InstanceData.resize(m_GridSize * m_GridSize * m_GridSize);
-    // Populate instance data buffer
-    float fGridSize = static_cast<float>(m_GridSize);
-
-    std::mt19937 gen; // Standard mersenne_twister_engine. Use default seed
-                      // to generate consistent distribution.
+    // The job system runs one job at a time. The commands of the next frame recorded by the worker threads
+    // use the current instances, which do not change until the new ones are ready, so they are kept.
+    // If the instances of the previous grid are still being generated, they are discarded.
+    WaitForCommandLists();
+
+    const Uint32 NumInstances = static_cast<Uint32>(m_GridSize * m_GridSize * m_GridSize);
+    m_PendingInstanceData.resize(NumInstances);
+    m_PendingInstanceAttribs.resize(NumInstances);
+    m_PendingGridSize       = static_cast<Uint32>(m_GridSize);
+    m_bSortPendingInstances = m_bSortInstances;
+    m_bGeneratingInstances  = true;
+    m_NumGeneratedChunks.store(0);
+    m_bPendingInstancesReady.store(false);
+
+    // Instances are generated by the job system threads. Random numbers are derived from the instance
+    // index, so the grid is the same for any number of threads and does not change between runs.
+    static constexpr Uint32 GenerateChunkSize = 512;
+
+    const Uint32 NumChunks = (NumInstances + GenerateChunkSize - 1) / GenerateChunkSize;
+    m_pJobSystem->ParallelForAsync(NumInstances, GenerateChunkSize, [this, NumChunks](Uint32 First, Uint32 Last, Uint32 ThreadIdx) {
+        {
+            CPU_PROFILER_SCOPE("GenerateInstances");
+            GenerateInstances(First, Last);
+        }
+        if (m_NumGeneratedChunks.fetch_add(1) + 1 < NumChunks)
+            return;
 
-    std::uniform_real_distribution<float> scale_distr(0.3f, 1.0f);
-    std::uniform_real_distribution<float> offset_distr(-0.15f, +0.15f);
-    std::uniform_real_distribution<float> rot_distr(-PI_F, +PI_F);
-    std::uniform_int_distribution<Int32>  tex_distr(0, NumTextures - 1);
+        // All chunks have been generated
+        if (m_bSortPendingInstances)
+            SortInstanceData();
 
-    float BaseScale = 0.6f / fGridSize;
-    int   instId    = 0;
-    for (int x = 0; x < m_GridSize; ++x)
-    {
-        for (int y = 0; y < m_GridSize; ++y)
+        // Instanced and cached modes read all instances from the buffer, so it is only updated when the grid changes
+        for (size_t inst = 0; inst < m_PendingInstanceData.size(); ++inst)
         {
-            for (int z = 0; z < m_GridSize; ++z)
-            {
-                // Add random offset from central position in the grid
-                float xOffset = 2.f * (x + 0.5f + offset_distr(gen)) / fGridSize - 1.f;
-                float yOffset = 2.f * (y + 0.5f + offset_distr(gen)) / fGridSize - 1.f;
-                float zOffset = 2.f * (z + 0.5f + offset_distr(gen)) / fGridSize - 1.f;
-                // Random scale
-                float scale = BaseScale * scale_distr(gen);
-                // Random rotation
-                float4x4 rotation = float4x4::RotationX(rot_distr(gen)) * float4x4::RotationY(rot_distr(gen)) * float4x4::RotationZ(rot_distr(gen));
-                // Combine rotation, scale and translation
-                float4x4 matrix   = rotation * float4x4::Scale(scale, scale, scale) * float4x4::Translation(xOffset, yOffset, zOffset);
-                auto&    CurrInst = m_InstanceData[instId++];
-                CurrInst.Matrix   = matrix;
-                // Texture array index
-                CurrInst.TextureInd = tex_distr(gen);
-            }
+            m_PendingInstanceAttribs[inst].Matrix     = m_PendingInstanceData[inst].Matrix;
+            m_PendingInstanceAttribs[inst].TextureInd = static_cast<float>(m_PendingInstanceData[inst].TextureInd);
         }
-    }
+        m_bPendingInstancesReady.store(true);
+    });
 }
 
-void Tutorial06_Multithreading::StartWorkerThreads(size_t NumThreads)
+void Tutorial06_Multithreading::FinishInstanceGeneration()
 {
-    m_WorkerThreads.resize(NumThreads);
-    for (Uint32 t = 0; t < m_WorkerThreads.size(); ++t)
-    {
-        m_WorkerThreads[t] = std::thread(WorkerThreadFunc, this, t);
-    }
-    m_CmdLists.resize(NumThreads);
+    VERIFY_EXPR(m_bGeneratingInstances);
+    // The main thread generates the remaining chunks along with the worker threads
+    WaitForCommandLists();
+    VERIFY_EXPR(m_bPendingInstancesReady.load());
+    m_bGeneratingInstances = false;
+
+    // The commands recorded for the next frame use the previous instances
+    DiscardNextFrame();
+    m_CachedCmdLists.clear();
+
+    m_InstanceData.swap(m_PendingInstanceData);
+    m_pImmediateContext->UpdateBuffer(m_InstanceBuffer, 0, static_cast<Uint32>(sizeof(InstanceAttribs) * m_PendingInstanceAttribs.size()), m_PendingInstanceAttribs.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    StateTransitionDesc Barrier{m_InstanceBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true};
+    m_pImmediateContext->TransitionResourceStates(1, &Barrier);
 }
 
-void Tutorial06_Multithreading::StopWorkerThreads()
+void Tutorial06_Multithreading::GenerateInstances(Uint32 StartInst, Uint32 EndInst)
 {
-    m_RenderSubsetSignal.Trigger(true, -1);
-
-    for (auto& thread : m_WorkerThreads)
+    const Uint32 GridSize  = m_PendingGridSize;
+    const float  fGridSize = static_cast<float>(m_PendingGridSize);
+    const float  BaseScale = 0.6f / fGridSize;
+    for (Uint32 inst = StartInst; inst < EndInst; ++inst)
     {
-        thread.join();
+        // Instances are laid out in x, y, z order
+        const Uint32 x = inst / (GridSize * GridSize);
+        const Uint32 y = (inst / GridSize) % GridSize;
+        const Uint32 z = inst % GridSize;
+
+        InstanceRandom Rand{inst};
+        // Add random offset from central position in the grid
+        float3 Offset;
+        Offset.x = 2.f * (x + 0.5f + Rand(-0.15f, +0.15f)) / fGridSize - 1.f;
+        Offset.y = 2.f * (y + 0.5f + Rand(-0.15f, +0.15f)) / fGridSize - 1.f;
+        Offset.z = 2.f * (z + 0.5f + Rand(-0.15f, +0.15f)) / fGridSize - 1.f;
+        // Random scale
+        float Scale = BaseScale * Rand(0.3f, 1.0f);
+        // Random rotation
+        const float AngleX = Rand(-PI_F, +PI_F);
+        const float AngleY = Rand(-PI_F, +PI_F);
+        const float AngleZ = Rand(-PI_F, +PI_F);
+        float4x4    RotationXY, Rotation;
+        MultiplyRotations(float4x4::RotationX(AngleX), float4x4::RotationY(AngleY), RotationXY);
+        MultiplyRotations(RotationXY, float4x4::RotationZ(AngleZ), Rotation);
+
+        auto& CurrInst = m_PendingInstanceData[inst];
+        // Combine rotation, scale and translation
+        ComposeInstanceMatrix(Rotation, Scale, Offset, CurrInst.Matrix);
+        // Texture array index
+        CurrInst.TextureInd = static_cast<int>(Rand(Uint32{NumTextures}));
     }
-    m_RenderSubsetSignal.Reset();
-    m_WorkerThreads.clear();
-    m_CmdLists.clear();
 }
 
-void Tutorial06_Multithreading::WorkerThreadFunc(Tutorial06_Multithreading* pThis, Uint32 ThreadNum)
+void Tutorial06_Multithreading::SortInstanceData()
 {
-    // Every thread should use its own deferred context
-    IDeviceContext* pDeferredCtx     = pThis->m_pDeferredContexts[ThreadNum];
-    const int       NumWorkerThreads = static_cast<int>(pThis->m_WorkerThreads.size());
-    for (;;)
+    // Instances are sorted by the SRB index with a counting sort, so the instances that use the same SRB
+    // keep their relative order. Every subset is a contiguous range of the sorted instances, so it switches
+    // the SRB at most NumTextures times.
+    Uint32 TextureStart[NumTextures] = {};
+    for (const auto& Inst : m_PendingInstanceData)
     {
-        // Wait for the signal
-        auto SignaledValue = pThis->m_RenderSubsetSignal.Wait(true, NumWorkerThreads);
-        if (SignaledValue < 0)
-            return;
-
-        // Render current subset using the deferred context
-        pThis->RenderSubset(pDeferredCtx, 1 + ThreadNum);
-
-        // Finish command list
-        RefCntAutoPtr<ICommandList> pCmdList;
-        pDeferredCtx->FinishCommandList(&pCmdList);
-        pThis->m_CmdLists[ThreadNum] = pCmdList;
-
-        {
-            std::lock_guard<std::mutex> Lock(pThis->m_NumThreadsCompletedMtx);
-            // Increment the number of completed threads
-            ++pThis->m_NumThreadsCompleted;
-            if (pThis->m_NumThreadsCompleted == NumWorkerThreads)
-                pThis->m_ExecuteCommandListsSignal.Trigger();
-        }
-
-        pThis->m_GotoNextFrameSignal.Wait(true, NumWorkerThreads);
-
-        // Call FinishFrame() to release dynamic resources allocated by deferred contexts
-        // IMPORTANT: we must wait until the command lists are submitted for execution
-        // because FinishFrame() invalidates all dynamic resources.
-        pDeferredCtx->FinishFrame();
-
-        ++pThis->m_NumThreadsReady;
-        // We must wait until all threads reach this point, because
-        // m_GotoNextFrameSignal must be unsignaled before we proceed to
-        // RenderSubsetSignal to avoid one thread going through the loop twice in
-        // a row.
-        while (pThis->m_NumThreadsReady < NumWorkerThreads)
-            std::this_thread::yield();
-        VERIFY_EXPR(!pThis->m_GotoNextFrameSignal.IsTriggered());
+        if (Inst.TextureInd + 1 < NumTextures)
+            ++TextureStart[Inst.TextureInd + 1];
     }
+    for (int tex = 1; tex < NumTextures; ++tex)
+        TextureStart[tex] += TextureStart[tex - 1];
+
+    std::vector<InstanceData> SortedInstances(m_PendingInstanceData.size());
+    for (const auto& Inst : m_PendingInstanceData)
+        SortedInstances[TextureStart[Inst.TextureInd]++] = Inst;
+    m_PendingInstanceData.swap(SortedInstances);
 }
 
-void Tutorial06_Multithreading::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
+void Tutorial06_Multithreading::SetSubsetState(IDeviceContext* pCtx)
 {
     // Deferred contexts start in default state. We must bind everything to the context.
     // Render targets are set and transitioned to correct states by the main thread, here we only verify the states.
     auto* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
     pCtx->SetRenderTargets(1, &pRTV, m_pSwapChain->GetDepthBufferDSV(), RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
-    {
-        // Map the buffer and write current world-view-projection matrix
-
-        // Since this is a dynamic buffer, it must be mapped in every context before
-        // it can be used even though the matrices are the same.
-        MapHelper<float4x4> CBConstants(pCtx, m_VSConstants, MAP_WRITE, MAP_FLAG_DISCARD);
-        CBConstants[0] = m_ViewProjMatrix.Transpose();
-        CBConstants[1] = m_RotationMatrix.Transpose();
-    }
-
     // Bind vertex and index buffers. This must be done for every context
     Uint32   offsets[] = {0, 0};
     IBuffer* pBuffs[]  = {m_CubeVertexBuffer};
     pCtx->SetVertexBuffers(0, _countof(pBuffs), pBuffs, offsets, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
     pCtx->SetIndexBuffer(m_CubeIndexBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
 
+    // Set the pipeline state
+    pCtx->SetPipelineState(m_pPSO);
+}
+
+void Tutorial06_Multithreading::RenderSubset(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 StartInst, Uint32 EndInst)
+{
+    SetSubsetState(pCtx);
+
     DrawIndexedAttribs DrawAttrs;     // This is an indexed draw call
     DrawAttrs.IndexType  = VT_UINT32; // Index type
     DrawAttrs.NumIndices = 36;
     DrawAttrs.Flags      = DRAW_FLAG_VERIFY_ALL;
 
-    // Set the pipeline state
-    pCtx->SetPipelineState(m_pPSO);
-    Uint32 NumSubsets   = Uint32{1} + static_cast<Uint32>(m_WorkerThreads.size());
-    Uint32 NumInstances = static_cast<Uint32>(m_InstanceData.size());
-    Uint32 SusbsetSize  = NumInstances / NumSubsets;
-    Uint32 StartInst    = SusbsetSize * Subset;
-    Uint32 EndInst      = (Subset < NumSubsets - 1) ? SusbsetSize * (Subset + 1) : NumInstances;
-    for (size_t inst = StartInst; inst < EndInst; ++inst)
+    // Every command list starts with a fresh copy of the ring buffer
+    m_pInstanceDataBuffer->Discard(CtxIdx);
+
+    IBuffer* pInstanceBuffer = m_pInstanceDataBuffer->GetBuffer();
+
+    IShaderResourceBinding* pCurrSRB       = nullptr;
+    Uint32                  NumSRBSwitches = 0;
+    for (Uint32 inst = StartInst; inst < EndInst;)
     {
-        const auto& CurrInstData = m_InstanceData[inst];
-        // Shader resources have been explicitly transitioned to correct states, so
-        // RESOURCE_STATE_TRANSITION_MODE_TRANSITION mode is not needed.
-        // Instead, we use RESOURCE_STATE_TRANSITION_MODE_VERIFY mode to
-        // verify that all resources are in correct states. This mode only has effect
-        // in debug and development builds.
-        pCtx->CommitShaderResources(m_SRB[CurrInstData.TextureInd], RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        // Write transform matrices of the next batch of instances to the ring buffer. Every matrix
+        // is allocated by bumping the offset in the mapped buffer, so there is one map per batch
+        // rather than one map per draw call. Every map discards the buffer, which is the only mode
+        // D3D11.0 deferred contexts support.
+        Uint32 InstanceOffsets[MaxInstanceBatchSize];
+        Uint32 BatchSize = 0;
+        while (BatchSize < MaxInstanceBatchSize && inst + BatchSize < EndInst)
+        {
+            auto* pInstMatrix = static_cast<float4x4*>(m_pInstanceDataBuffer->Allocate(pCtx, CtxIdx, sizeof(float4x4), InstanceOffsets[BatchSize]));
+            if (pInstMatrix == nullptr)
+                break;
+            *pInstMatrix = m_InstanceData[inst + BatchSize].Matrix;
+            ++BatchSize;
+        }
+        // The buffer must be unmapped before it is used by draw commands
+        m_pInstanceDataBuffer->Unmap(CtxIdx);
 
+        if (BatchSize == 0)
         {
-            // Map the buffer and write current world-view-projection matrix
-            MapHelper<float4x4> InstData(pCtx, m_InstanceConstants, MAP_WRITE, MAP_FLAG_DISCARD);
-            if (InstData == nullptr)
+            if (m_pInstanceDataBuffer->GetAllocatedSize(CtxIdx) == 0)
             {
-                LOG_ERROR_MESSAGE("Failed to map instance data buffer");
+                LOG_ERROR_MESSAGE("Failed to allocate instance data");
                 break;
             }
-            *InstData = CurrInstData.Matrix.Transpose();
+            // The ring buffer is full or has been unmapped. Draw commands that use the previous batch
+            // have already been recorded, so the buffer can be discarded.
+            m_pInstanceDataBuffer->Discard(CtxIdx);
+            continue;
+        }
+
+        for (Uint32 i = 0; i < BatchSize; ++i, ++inst)
+        {
+            const auto& CurrInstData = m_InstanceData[inst];
+
+            // Committing the SRB that is already bound is redundant
+            auto* pSRB = m_SRB[CurrInstData.TextureInd].RawPtr();
+            if (pSRB != pCurrSRB)
+            {
+                // Shader resources have been explicitly transitioned to correct states, so
+                // RESOURCE_STATE_TRANSITION_MODE_TRANSITION mode is not needed.
+                // Instead, we use RESOURCE_STATE_TRANSITION_MODE_VERIFY mode to
+                // verify that all resources are in correct states. This mode only has effect
+                // in debug and development builds.
+                pCtx->CommitShaderResources(pSRB, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+                pCurrSRB = pSRB;
+                ++NumSRBSwitches;
+            }
+
+            // Bind the instance matrix by its offset in the ring buffer
+            pCtx->SetVertexBuffers(1, 1, &pInstanceBuffer, &InstanceOffsets[i], RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_NONE);
+
+            pCtx->DrawIndexed(DrawAttrs);
+        }
+    }
+
+    m_NumSRBSwitches.fetch_add(NumSRBSwitches);
+}
+
+void Tutorial06_Multithreading::RecordCachedSubset(IDeviceContext* pCtx, Uint32 StartInst, Uint32 EndInst)
+{
+    // Cached command lists are executed again in later frames, so they must not reference data that
+    // changes between frames: instance matrices are read from the instance buffer that is only updated
+    // when the grid changes, rather than from the ring buffer that is discarded every frame.
+    SetSubsetState(pCtx);
+
+    DrawIndexedAttribs DrawAttrs;
+    DrawAttrs.IndexType  = VT_UINT32;
+    DrawAttrs.NumIndices = 36;
+    DrawAttrs.Flags      = DRAW_FLAG_VERIFY_ALL;
+
+    IShaderResourceBinding* pCurrSRB       = nullptr;
+    Uint32                  NumSRBSwitches = 0;
+    for (Uint32 inst = StartInst; inst < EndInst; ++inst)
+    {
+        auto* pSRB = m_SRB[m_InstanceData[inst].TextureInd].RawPtr();
+        if (pSRB != pCurrSRB)
+        {
+            pCtx->CommitShaderResources(pSRB, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+            pCurrSRB = pSRB;
+            ++NumSRBSwitches;
         }
 
+        // The per-draw pipeline only reads the matrix from the instance attributes
+        Uint32 Offset = static_cast<Uint32>(sizeof(InstanceAttribs) * inst);
+        pCtx->SetVertexBuffers(1, 1, &m_InstanceBuffer, &Offset, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_NONE);
+
         pCtx->DrawIndexed(DrawAttrs);
     }
+
+    m_NumSRBSwitches.fetch_add(NumSRBSwitches);
+}
+
+bool Tutorial06_Multithreading::RenderCached()
+{
+    if (m_pDeferredContexts.empty())
+    {
+        // Without deferred contexts there is nothing to cache, so the commands are recorded directly
+        m_NumSRBSwitches = 0;
+        RecordCachedSubset(m_pImmediateContext, 0, static_cast<Uint32>(m_InstanceData.size()));
+        m_LastFrameSRBSwitches = m_NumSRBSwitches;
+        return true;
+    }
+
+    // Command lists reference the back buffer they were recorded with
+    auto* pRTV     = m_pSwapChain->GetCurrentBackBufferRTV();
+    bool  Recorded = false;
+    if (m_CachedCmdLists.empty() || m_pCachedRTV != pRTV)
+    {
+        m_NumSRBSwitches = 0;
+        RecordCommandLists(static_cast<Uint32>(m_InstanceData.size()),
+                           [this](IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 First, Uint32 Last) {
+                               RecordCachedSubset(pCtx, First, Last);
+                           },
+                           m_CachedCmdLists);
+        m_LastFrameSRBSwitches = m_NumSRBSwitches;
+        m_pCachedRTV           = pRTV;
+        Recorded               = true;
+    }
+
+    {
+        CPU_PROFILER_SCOPE("ExecuteCommandLists");
+        for (auto& pCmdList : m_CachedCmdLists)
+            m_pImmediateContext->ExecuteCommandList(pCmdList);
+    }
+
+    if (Recorded)
+        FinishWorkerContextFrames();
+
+    // Other backends release the recorded commands when the list is executed
+    if (!m_bCanReuseCommandLists)
+        m_CachedCmdLists.clear();
+
+    return Recorded;
+}
+
+void Tutorial06_Multithreading::RenderInstanced()
+{
+    if (!m_InstancedSRB)
+        return;
+
+    // Bind vertex, instance and index buffers
+    Uint32   offsets[] = {0, 0};
+    IBuffer* pBuffs[]  = {m_CubeVertexBuffer, m_InstanceBuffer};
+    m_pImmediateContext->SetVertexBuffers(0, _countof(pBuffs), pBuffs, offsets, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
+    m_pImmediateContext->SetIndexBuffer(m_CubeIndexBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+    m_pImmediateContext->SetPipelineState(m_pInstancedPSO);
+    // Texture index is read from the instance data, so a single SRB is committed for all cubes
+    m_pImmediateContext->CommitShaderResources(m_InstancedSRB, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+    DrawIndexedAttribs DrawAttrs;
+    DrawAttrs.IndexType    = VT_UINT32;
+    DrawAttrs.NumIndices   = 36;
+    DrawAttrs.NumInstances = static_cast<Uint32>(m_InstanceData.size());
+    DrawAttrs.Flags        = DRAW_FLAG_VERIFY_ALL;
+    m_pImmediateContext->DrawIndexed(DrawAttrs);
 }
 
 // Render a frame
@@ -353,37 +817,176 @@ void Tutorial06_Multithreading::Render()
     m_pImmediateContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
     m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 
-    if (!m_WorkerThreads.empty())
-    {
-        m_NumThreadsCompleted = 0;
-        m_RenderSubsetSignal.Trigger(true);
-    }
+    Timer SubmitTimer;
+
+    // Instanced mode does not use the job system, so it keeps rendering the current instances until the new
+    // ones are ready. Other modes record commands with the job system, which must finish the instances first.
+    if (m_bGeneratingInstances && (m_bPendingInstancesReady.load() || m_RenderMode != RenderMode::Instanced))
+        FinishInstanceGeneration();
 
-    RenderSubset(m_pImmediateContext, 0);
+    // Commands of this frame may have been recorded by the worker threads while the frame was updated.
+    // They are only used when nothing they depend on has changed since the recording started.
+    // Nothing is recorded while the instances are being generated.
+    if (!m_bGeneratingInstances)
+        WaitForCommandLists();
+    if (m_RenderMode != RenderMode::PerDraw || m_pNextFrameRTV != pRTV)
+        DiscardNextFrame();
 
-    if (!m_WorkerThreads.empty())
     {
-        m_ExecuteCommandListsSignal.Wait(true, 1);
+        // Update the constants that are shared by all contexts and by the cached command lists
+        float4x4 Constants[] = {m_ViewProjMatrix.Transpose(), m_RotationMatrix.Transpose()};
+        m_pImmediateContext->UpdateBuffer(m_VSConstants, 0, sizeof(Constants), Constants, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        // Deferred contexts verify that the buffer is in constant buffer state
+        StateTransitionDesc Barrier{m_VSConstants, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_CONSTANT_BUFFER, true};
+        m_pImmediateContext->TransitionResourceStates(1, &Barrier);
+    }
 
-        for (auto& cmdList : m_CmdLists)
+    bool Recorded = true;
+    if (m_RenderMode == RenderMode::Instanced)
+    {
+        RenderInstanced();
+        m_LastFrameSRBSwitches = 1;
+    }
+    else if (m_RenderMode == RenderMode::Cached)
+    {
+        Recorded = RenderCached();
+    }
+    else if (!m_NextFrameCmdLists.empty())
+    {
         {
-            m_pImmediateContext->ExecuteCommandList(cmdList);
-            // Release command lists now to release all outstanding references
-            // In d3d11 mode, command lists hold references to the swap chain's back buffer
-            // that cause swap chain resize to fail
-            cmdList.Release();
+            CPU_PROFILER_SCOPE("ExecuteCommandLists");
+            for (auto& pCmdList : m_NextFrameCmdLists)
+                m_pImmediateContext->ExecuteCommandList(pCmdList);
         }
+        m_NextFrameCmdLists.clear();
+        m_pNextFrameRTV = nullptr;
+        FinishWorkerContextFrames();
+        m_LastFrameSRBSwitches = m_NumSRBSwitches;
+    }
+    else
+    {
+        m_NumSRBSwitches = 0;
+        // Instances are split into chunks that are recorded by the job system threads
+        RecordCommandsInParallel(static_cast<Uint32>(m_InstanceData.size()),
+                                 [this](IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 First, Uint32 Last) {
+                                     RenderSubset(pCtx, CtxIdx, First, Last);
+                                 });
+        m_LastFrameSRBSwitches = m_NumSRBSwitches;
+    }
 
-        m_NumThreadsReady = 0;
-        m_GotoNextFrameSignal.Trigger(true);
+    const auto CurrSubmitTime = SubmitTimer.GetElapsedTime();
+    if (m_RenderMode == RenderMode::Cached && Recorded)
+    {
+        // Only the frames that replay the command lists are included in the submit time of the cached mode
+        m_CachedRecordTime = CurrSubmitTime;
+        return;
     }
+
+    // Smooth the time over several dozen frames to make the numbers readable
+    auto& SubmitTime = m_SubmitTime[static_cast<size_t>(m_RenderMode)];
+    SubmitTime       = SubmitTime > 0 ? SubmitTime + (CurrSubmitTime - SubmitTime) * 0.05 : CurrSubmitTime;
+}
+
+void Tutorial06_Multithreading::PreWindowResize()
+{
+    // Cached command lists hold references to the back buffer that cause swap chain resize to fail
+    m_CachedCmdLists.clear();
+    DiscardNextFrame();
+}
+
+void Tutorial06_Multithreading::PostPresent()
+{
+    // Only the per-draw mode records new command lists every frame
+    if (!m_bRecordNextFrame || m_RenderMode != RenderMode::PerDraw || m_pDeferredContexts.empty() || m_pJobSystem->GetNumWorkerThreads() == 0)
+        return;
+
+    // The job system is busy generating the instances of the new grid
+    if (m_bGeneratingInstances)
+        return;
+
+    // The worker threads record the commands of the next frame while the main thread updates it. The commands do not
+    // depend on the camera, which is read from the constant buffer updated in Render(). Everything else the commands
+    // use is only modified after DiscardNextFrame() has waited for the recording and released the command lists.
+    auto* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
+    auto* pDSV = m_pSwapChain->GetDepthBufferDSV();
+
+    // Render targets are transitioned here rather than when they are cleared, since the worker threads verify their states
+    // clang-format off
+    StateTransitionDesc Barriers[] =
+    {
+        {pRTV->GetTexture(), RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_RENDER_TARGET, true},
+        {pDSV->GetTexture(), RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_DEPTH_WRITE,   true}
+    };
+    // clang-format on
+    m_pImmediateContext->TransitionResourceStates(_countof(Barriers), Barriers);
+
+    m_NumSRBSwitches = 0;
+    m_pNextFrameRTV  = pRTV;
+    BeginRecordCommandLists(static_cast<Uint32>(m_InstanceData.size()),
+                            [this](IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 First, Uint32 Last) {
+                                RenderSubset(pCtx, CtxIdx, First, Last);
+                            },
+                            m_NextFrameCmdLists);
+}
+
+void Tutorial06_Multithreading::DiscardNextFrame()
+{
+    // The job system runs one job at a time, so no commands are being recorded while the instances are generated
+    if (!m_bGeneratingInstances)
+        WaitForCommandLists();
+    m_pNextFrameRTV = nullptr;
+    if (m_NextFrameCmdLists.empty())
+        return;
+
+    m_NextFrameCmdLists.clear();
+    // Release dynamic resources allocated by the contexts that recorded the command lists
+    FinishWorkerContextFrames();
+}
+
+void Tutorial06_Multithreading::UpdateIdleTimes()
+{
+    const auto NumWorkers = m_pJobSystem ? m_pJobSystem->GetNumWorkerThreads() : 0;
+    const auto CurrTime   = m_IdleTimer.GetElapsedTime();
+    if (m_pJobSystem.get() != m_pIdleTimesJobSystem)
+    {
+        // The job system has been recreated with a different number of threads
+        m_pIdleTimesJobSystem = m_pJobSystem.get();
+        m_WorkerIdleTime.assign(NumWorkers, 0);
+        m_WorkerIdleFraction.assign(NumWorkers, 0);
+        for (Uint32 i = 0; i < NumWorkers; ++i)
+            m_WorkerIdleTime[i] = m_pJobSystem->GetIdleTime(1 + i);
+        m_LastIdleSampleTime = CurrTime;
+        return;
+    }
+
+    const auto SampleTime = CurrTime - m_LastIdleSampleTime;
+    if (SampleTime <= 0)
+        return;
+
+    for (Uint32 i = 0; i < NumWorkers; ++i)
+    {
+        const auto IdleTime = m_pJobSystem->GetIdleTime(1 + i);
+        const auto Fraction = static_cast<float>(std::min((IdleTime - m_WorkerIdleTime[i]) / SampleTime, 1.0));
+        // Smooth the fractions in the same way as the submit times
+        auto& IdleFraction  = m_WorkerIdleFraction[i];
+        IdleFraction        = IdleFraction + (Fraction - IdleFraction) * 0.05f;
+        m_WorkerIdleTime[i] = IdleTime;
+    }
+    m_LastIdleSampleTime = CurrTime;
 }
 
 void Tutorial06_Multithreading::Update(double CurrTime, double ElapsedTime)
 {
     SampleBase::Update(CurrTime, ElapsedTime);
+    UpdateIdleTimes();
     UpdateUI();
 
+    if (m_bTextureArrayDirty)
+    {
+        m_bTextureArrayDirty = false;
+        UpdateTextureArray();
+    }
+
     const bool IsGL = m_pDevice->GetDeviceCaps().IsGLDevice();
 
     // Set the cube view matrix
@@ -28,12 +28,12 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <vector>
-#include <thread>
-#include <mutex>
 #include "SampleBase.hpp"
 #include "BasicMath.hpp"
-#include "ThreadSignal.hpp"
+#include "DynamicRingBuffer.hpp"
+#include "Timer.hpp"
 
 namespace Diligent
 {
@@ -41,7 +41,8 @@ namespace Diligent
 class Tutorial06_Multithreading final : public SampleBase
 {
 public:
-    ~Tutorial06_Multithreading() override;
+    ~Tutorial06_Multithreading();
+
     virtual void GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
                                                 EngineCreateInfo&  Attribs,
                                                 SwapChainDesc&     SCDesc) override final;
@@ -54,37 +55,92 @@ public:
     virtual void Render() override final;
     virtual void Update(double CurrTime, double ElapsedTime) override final;
 
+    virtual void PreWindowResize() override final;
+    virtual void PostPresent() override final;
+
     virtual const Char* GetSampleName() const override final { return "Tutorial06: Multithreaded rendering"; }
 
 private:
     void CreatePipelineState(std::vector<StateTransitionDesc>& Barriers);
-    void LoadTextures(std::vector<StateTransitionDesc>& Barriers);
+    void CreateInstancedPipelineState(std::vector<StateTransitionDesc>& Barriers);
+    void LoadTextures();
+    void SetTexture(int TexIdx, ITextureView* pTextureSRV);
+    void UpdateTextureArray();
     void UpdateUI();
-    void PopulateInstanceData();
-
-    void StartWorkerThreads(size_t NumThreads);
-    void StopWorkerThreads();
-
-    void RenderSubset(IDeviceContext* pCtx, Uint32 Subset);
-
-    static void WorkerThreadFunc(Tutorial06_Multithreading* pThis, Uint32 ThreadNum);
-
-    ThreadingTools::Signal   m_RenderSubsetSignal;
-    ThreadingTools::Signal   m_ExecuteCommandListsSignal;
-    ThreadingTools::Signal   m_GotoNextFrameSignal;
-    std::mutex               m_NumThreadsCompletedMtx;
-    std::atomic_int          m_NumThreadsCompleted;
-    std::atomic_int          m_NumThreadsReady;
-    std::vector<std::thread> m_WorkerThreads;
-
-    std::vector<RefCntAutoPtr<ICommandList>> m_CmdLists;
+    // Starts generating the instances of the current grid into the pending buffers
+    void StartInstanceGeneration();
+    // Waits until the pending instances are generated and makes them current
+    void FinishInstanceGeneration();
+    void GenerateInstances(Uint32 StartInst, Uint32 EndInst);
+    void SortInstanceData();
+
+    void SetSubsetState(IDeviceContext* pCtx);
+    void RenderSubset(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 StartInst, Uint32 EndInst);
+    void RecordCachedSubset(IDeviceContext* pCtx, Uint32 StartInst, Uint32 EndInst);
+    void RenderInstanced();
+    // Returns true if the command lists have been recorded in this frame
+    bool RenderCached();
+    // Waits for the command lists of the next frame recorded after the last present and releases them
+    void DiscardNextFrame();
+    void UpdateIdleTimes();
 
     RefCntAutoPtr<IPipelineState> m_pPSO;
     RefCntAutoPtr<IBuffer>        m_CubeVertexBuffer;
     RefCntAutoPtr<IBuffer>        m_CubeIndexBuffer;
-    RefCntAutoPtr<IBuffer>        m_InstanceConstants;
     RefCntAutoPtr<IBuffer>        m_VSConstants;
 
+    enum class RenderMode : int
+    {
+        // Every cube is rendered by its own draw call recorded by the job system threads
+        PerDraw,
+        // All cubes are rendered by instanced draw calls from the instance buffer
+        Instanced,
+        // Command lists are recorded once in the same way as in per-draw mode and executed again
+        // in every frame until the grid, the number of threads or a texture changes
+        Cached,
+        NumModes
+    } m_RenderMode = RenderMode::PerDraw;
+
+    // Instanced mode reads instance matrices and texture indices from a vertex buffer
+    // that is only updated when the grid changes, and samples the textures from an array
+    static constexpr int MaxGridSize = 32;
+
+    RefCntAutoPtr<IPipelineState>         m_pInstancedPSO;
+    RefCntAutoPtr<IShaderResourceBinding> m_InstancedSRB;
+    RefCntAutoPtr<IBuffer>                m_InstanceBuffer;
+    RefCntAutoPtr<ITextureView>           m_TextureArraySRV;
+    bool                                  m_bTextureArrayDirty = true;
+
+    // Smoothed CPU time, in seconds, spent recording and submitting the cubes in every mode
+    double m_SubmitTime[static_cast<size_t>(RenderMode::NumModes)] = {};
+
+    std::vector<RefCntAutoPtr<ICommandList>> m_CachedCmdLists;
+    ITextureView*                            m_pCachedRTV            = nullptr;
+    bool                                     m_bCanReuseCommandLists = false;
+    // CPU time, in seconds, of the last frame that recorded the cached command lists
+    double m_CachedRecordTime = 0;
+
+    // In per-draw mode, the worker threads start recording the next frame right after the present,
+    // while the main thread updates the frame. The commands are discarded if the data they use changes.
+    bool                                     m_bRecordNextFrame = true;
+    std::vector<RefCntAutoPtr<ICommandList>> m_NextFrameCmdLists;
+    ITextureView*                            m_pNextFrameRTV = nullptr;
+
+    // Idle time, in seconds, of every worker thread at the last sample and its smoothed fraction of the frame time
+    Timer               m_IdleTimer;
+    double              m_LastIdleSampleTime  = 0;
+    const JobSystem*    m_pIdleTimesJobSystem = nullptr;
+    std::vector<double> m_WorkerIdleTime;
+    std::vector<float>  m_WorkerIdleFraction;
+
+    // The number of instance matrices that fit into the ring buffer of every context
+    static constexpr Uint32 InstanceRingBufferSize = 1024;
+    // The number of instance matrices written to the ring buffer between map and unmap. The ring buffer
+    // is mapped once per discard, so a batch fills the whole buffer.
+    static constexpr Uint32 MaxInstanceBatchSize = InstanceRingBufferSize;
+
+    std::unique_ptr<DynamicRingBuffer> m_pInstanceDataBuffer;
+
     static constexpr int NumTextures = 4;
 
     RefCntAutoPtr<IShaderResourceBinding> m_SRB[NumTextures];
@@ -103,6 +159,32 @@ private:
         int      TextureInd;
     };
     std::vector<InstanceData> m_InstanceData;
+
+    // Layout of the instance buffer used in instanced mode
+    struct InstanceAttribs
+    {
+        float4x4 Matrix;
+        float    TextureInd;
+    };
+
+    // When the grid changes, the job system generates the new instances in the background while the frames keep
+    // rendering the current ones. The worker thread that generates the last chunk sorts the instances and prepares
+    // the instance buffer data. The instances are made current by the first frame that finds them ready, or by
+    // the first frame that needs the job system to record commands.
+    std::vector<InstanceData>    m_PendingInstanceData;
+    std::vector<InstanceAttribs> m_PendingInstanceAttribs;
+    Uint32                       m_PendingGridSize       = 0;
+    bool                         m_bSortPendingInstances = false;
+    bool                         m_bGeneratingInstances  = false;
+    std::atomic<Uint32>          m_NumGeneratedChunks{0};
+    std::atomic<bool>            m_bPendingInstancesReady{false};
+
+    // When enabled, instances are sorted by texture so that consecutive draw calls
+    // use the same SRB and redundant CommitShaderResources() calls are skipped
+    bool m_bSortInstances = true;
+
+    std::atomic<Uint32> m_NumSRBSwitches{0};
+    Uint32              m_LastFrameSRBSwitches = 0;
 };
 
 } // namespace Diligent
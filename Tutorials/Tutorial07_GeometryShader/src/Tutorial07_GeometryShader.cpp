@@ -31,6 +31,7 @@
 #include "TextureUtilities.h"
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
+#include "AssetArchive.hpp"
 
 #ifdef HLSL2GLSL_CONVERTER_SUPPORTED
 #    include "HLSL2GLSLConverterImpl.hpp"
@@ -57,7 +58,7 @@ struct Constants
 } // namespace
 
 
-static RefCntAutoPtr<IShader> CreateShader(IRenderDevice*          pDevice,
+static RefCntAutoPtr<IShader> CreateShader(ShaderCache*            pShaderCache,
                                            const ShaderCreateInfo& ShaderCI,
                                            bool                    ConvertToGLSL)
 {
@@ -90,13 +91,13 @@ static RefCntAutoPtr<IShader> CreateShader(IRenderDevice*          pDevice,
         ConvertedShaderCI.Source                     = ConvertedSource.c_str();
         ConvertedShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_GLSL;
 
-        pDevice->CreateShader(ConvertedShaderCI, &pShader);
+        pShaderCache->CreateShader(ConvertedShaderCI, &pShader);
     }
 #endif
 
     if (!pShader)
     {
-        pDevice->CreateShader(ShaderCI, &pShader);
+        pShaderCache->CreateShader(ShaderCI, &pShader);
     }
     return pShader;
 }
@@ -141,7 +142,7 @@ void Tutorial07_GeometryShader::CreatePipelineState()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
 
     // For geometry shader, glslang currently produces SPIRV that is incompatible with other
@@ -155,7 +156,7 @@ void Tutorial07_GeometryShader::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = "cube.vsh";
-        pVS                      = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pVS                      = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // Create a geometry shader
@@ -165,7 +166,7 @@ void Tutorial07_GeometryShader::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube GS";
         ShaderCI.FilePath        = "cube.gsh";
-        pGS                      = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pGS                      = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // Create a pixel shader
@@ -175,7 +176,7 @@ void Tutorial07_GeometryShader::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = "cube.psh";
-        pPS                      = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pPS                      = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // clang-format off
@@ -270,8 +271,15 @@ void Tutorial07_GeometryShader::Initialize(IEngineFactory*  pEngineFactory,
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
     m_CubeIndexBuffer  = TexturedCube::CreateIndexBuffer(pDevice);
-    m_TextureSRV       = TexturedCube::LoadTexture(pDevice, "DGLogo.png")->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-    m_SRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureSRV);
+    // Load the texture in the background. Mutable variables can only be set once, so a new SRB
+    // is created when the placeholder texture is replaced with the loaded one.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_TextureSRV = pTextureSRV;
+        m_SRB.Release();
+        m_pPSO->CreateShaderResourceBinding(&m_SRB, true);
+        // Set cube texture SRV in the SRB
+        m_SRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_TextureSRV);
+    });
 }
 
 // Render a frame
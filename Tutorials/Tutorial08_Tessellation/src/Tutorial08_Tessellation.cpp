@@ -29,8 +29,10 @@
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
 #include "ShaderMacroHelper.hpp"
 #include "imgui.h"
+#include "AssetArchive.hpp"
 #ifdef HLSL2GLSL_CONVERTER_SUPPORTED
 #    include "HLSL2GLSLConverterImpl.hpp"
 #endif
@@ -70,7 +72,7 @@ struct GlobalConstants
 } // namespace
 
 
-static RefCntAutoPtr<IShader> CreateShader(IRenderDevice*          pDevice,
+static RefCntAutoPtr<IShader> CreateShader(ShaderCache*            pShaderCache,
                                            const ShaderCreateInfo& ShaderCI,
                                            bool                    ConvertToGLSL)
 {
@@ -103,13 +105,13 @@ static RefCntAutoPtr<IShader> CreateShader(IRenderDevice*          pDevice,
         ConvertedShaderCI.Source                     = ConvertedSource.c_str();
         ConvertedShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_GLSL;
 
-        pDevice->CreateShader(ConvertedShaderCI, &pShader);
+        pShaderCache->CreateShader(ConvertedShaderCI, &pShader);
     }
 #endif
 
     if (!pShader)
     {
-        pDevice->CreateShader(ShaderCI, &pShader);
+        pShaderCache->CreateShader(ShaderCI, &pShader);
     }
 
     return pShader;
@@ -163,7 +165,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -173,7 +175,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
         ShaderCI.Desc.Name       = "Terrain VS";
         ShaderCI.FilePath        = "terrain.vsh";
 
-        pVS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pVS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
 
@@ -186,7 +188,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
         ShaderCI.Desc.Name       = "Terrain GS";
         ShaderCI.FilePath        = "terrain.gsh";
 
-        pGS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pGS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // Create a hull shader
@@ -199,7 +201,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
         MacroHelper.AddShaderMacro("BLOCK_SIZE", m_BlockSize);
         ShaderCI.Macros = MacroHelper;
 
-        pHS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pHS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // Create a domain shader
@@ -211,7 +213,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
         ShaderCI.FilePath        = "terrain.dsh";
         ShaderCI.Macros          = nullptr;
 
-        pDS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pDS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
     }
 
     // Create a pixel shader
@@ -222,7 +224,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
         ShaderCI.Desc.Name       = "Terrain PS";
         ShaderCI.FilePath        = "terrain.psh";
 
-        pPS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+        pPS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
 
         if (bWireframeSupported)
         {
@@ -230,7 +232,7 @@ void Tutorial08_Tessellation::CreatePipelineStates()
             ShaderCI.Desc.Name  = "Wireframe Terrain PS";
             ShaderCI.FilePath   = "terrain_wire.psh";
 
-            pWirePS = CreateShader(m_pDevice, ShaderCI, ConvertToGLSL);
+            pWirePS = CreateShader(m_pShaderCache, ShaderCI, ConvertToGLSL);
         }
     }
 
@@ -305,7 +307,7 @@ void Tutorial08_Tessellation::LoadTextures()
         loadInfo.IsSRGB = false;
         loadInfo.Name   = "Terrain height map";
         RefCntAutoPtr<ITexture> HeightMap;
-        CreateTextureFromFile("ps_height_1k.png", loadInfo, m_pDevice, &HeightMap);
+        CreateTextureFromFilePreferCooked("ps_height_1k.png", loadInfo, m_pDevice, &HeightMap);
         const auto HMDesc = HeightMap->GetDesc();
         m_HeightMapWidth  = HMDesc.Width;
         m_HeightMapHeight = HMDesc.Height;
@@ -318,7 +320,7 @@ void Tutorial08_Tessellation::LoadTextures()
         loadInfo.IsSRGB = true;
         loadInfo.Name   = "Terrain color map";
         RefCntAutoPtr<ITexture> ColorMap;
-        CreateTextureFromFile("ps_texture_2k.png", loadInfo, m_pDevice, &ColorMap);
+        CreateTextureFromFilePreferCooked("ps_texture_2k.png", loadInfo, m_pDevice, &ColorMap);
         // Get shader resource view from the texture
         m_ColorMapSRV = ColorMap->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
     }
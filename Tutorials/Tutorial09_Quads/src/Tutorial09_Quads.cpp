@@ -29,13 +29,16 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <thread>
 
 #include "Tutorial09_Quads.hpp"
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -45,17 +48,13 @@ SampleBase* CreateSample()
     return new Tutorial09_Quads();
 }
 
-Tutorial09_Quads::~Tutorial09_Quads()
-{
-    StopWorkerThreads();
-}
-
 void Tutorial09_Quads::GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
                                                       EngineCreateInfo&  Attribs,
                                                       SwapChainDesc&     SCDesc)
 {
     SampleBase::GetEngineInitializationAttribs(DeviceType, Attribs, SCDesc);
-    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency() - 1, 2u);
+    // Every job system thread, including the main thread, records commands into its own deferred context
+    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency(), 2u);
 #if D3D12_SUPPORTED
     if (DeviceType == RENDER_DEVICE_TYPE_D3D12)
     {
@@ -128,7 +127,7 @@ void Tutorial09_Quads::CreatePipelineStates(std::vector<StateTransitionDesc>& Ba
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS, pVSBatched;
@@ -137,10 +136,10 @@ void Tutorial09_Quads::CreatePipelineStates(std::vector<StateTransitionDesc>& Ba
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Quad VS";
         ShaderCI.FilePath        = "quad.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
         ShaderCI.Desc.Name = "Quad VS Batched";
         ShaderCI.FilePath  = "quad_batch.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVSBatched);
+        m_pShaderCache->CreateShader(ShaderCI, &pVSBatched);
 
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
@@ -157,12 +156,12 @@ void Tutorial09_Quads::CreatePipelineStates(std::vector<StateTransitionDesc>& Ba
         ShaderCI.Desc.Name       = "Quad PS";
         ShaderCI.FilePath        = "quad.psh";
 
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
 
         ShaderCI.Desc.Name = "Quad PS Batched";
         ShaderCI.FilePath  = "quad_batch.psh";
 
-        m_pDevice->CreateShader(ShaderCI, &pPSBatched);
+        m_pShaderCache->CreateShader(ShaderCI, &pPSBatched);
     }
 
     PSODesc.GraphicsPipeline.pVS = pVS;
@@ -257,7 +256,7 @@ void Tutorial09_Quads::LoadTextures(std::vector<StateTransitionDesc>& Barriers)
         std::stringstream FileNameSS;
         FileNameSS << "DGLogo" << tex << ".png";
         auto FileName = FileNameSS.str();
-        CreateTextureFromFile(FileName.c_str(), loadInfo, m_pDevice, &SrcTex);
+        CreateTextureFromFilePreferCooked(FileName.c_str(), loadInfo, m_pDevice, &SrcTex);
         // Get shader resource view from the texture
         m_TextureSRV[tex] = SrcTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
 
@@ -321,8 +320,7 @@ void Tutorial09_Quads::UpdateUI()
             ImGuiScopedDisabler Disable(m_MaxThreads == 0);
             if (ImGui::SliderInt("Worker Threads", &m_NumWorkerThreads, 0, m_MaxThreads))
             {
-                StopWorkerThreads();
-                StartWorkerThreads(m_NumWorkerThreads);
+                SetNumWorkerThreads(m_NumWorkerThreads);
             }
         }
     }
@@ -338,7 +336,7 @@ void Tutorial09_Quads::Initialize(IEngineFactory*  pEngineFactory,
 {
     SampleBase::Initialize(pEngineFactory, pDevice, ppContexts, NumDeferredCtx, pSwapChain);
 
-    m_MaxThreads       = static_cast<int>(m_pDeferredContexts.size());
+    m_MaxThreads       = static_cast<int>(GetMaxWorkerThreads());
     m_NumWorkerThreads = std::min(7, m_MaxThreads);
 
     std::vector<StateTransitionDesc> Barriers;
@@ -351,12 +349,13 @@ void Tutorial09_Quads::Initialize(IEngineFactory*  pEngineFactory,
     if (m_BatchSize > 1)
         CreateInstanceBuffer();
 
-    StartWorkerThreads(m_NumWorkerThreads);
+    SetNumWorkerThreads(m_NumWorkerThreads);
 }
 
 void Tutorial09_Quads::InitializeQuads()
 {
-    m_Quads.resize(m_NumQuads);
+    auto& Quads = m_Quads[0];
+    Quads.resize(m_NumQuads);
 
     std::mt19937 gen; // Standard mersenne_twister_engine. Use default seed
                       // to generate consistent distribution.
@@ -371,7 +370,7 @@ void Tutorial09_Quads::InitializeQuads()
 
     for (int quad = 0; quad < m_NumQuads; ++quad)
     {
-        auto& CurrInst     = m_Quads[quad];
+        auto& CurrInst     = Quads[quad];
         CurrInst.Size      = scale_distr(gen);
         CurrInst.Angle     = angle_distr(gen);
         CurrInst.Pos.x     = pos_distr(gen);
@@ -383,17 +382,25 @@ void Tutorial09_Quads::InitializeQuads()
         CurrInst.TextureInd = tex_distr(gen);
         CurrInst.StateInd   = state_distr(gen);
     }
+
+    for (Uint32 i = 1; i < FramePipeline::NumSnapshots; ++i)
+        m_Quads[i] = Quads;
 }
 
-void Tutorial09_Quads::UpdateQuads(float elapsedTime)
+void Tutorial09_Quads::UpdateQuads(float elapsedTime, Uint32 SnapshotIdx)
 {
     std::mt19937 gen; // Standard mersenne_twister_engine. Use default seed
                       // to generate consistent distribution.
 
+    const auto& PrevQuads = m_Quads[(SnapshotIdx + FramePipeline::NumSnapshots - 1) % FramePipeline::NumSnapshots];
+    auto&       Quads     = m_Quads[SnapshotIdx];
+    VERIFY_EXPR(PrevQuads.size() == Quads.size());
+
     std::uniform_real_distribution<float> rot_distr(-PI_F * 0.5f, +PI_F * 0.5f);
-    for (int quad = 0; quad < m_NumQuads; ++quad)
+    for (size_t quad = 0; quad < Quads.size(); ++quad)
     {
-        auto& CurrInst = m_Quads[quad];
+        auto& CurrInst = Quads[quad];
+        CurrInst       = PrevQuads[quad];
         CurrInst.Angle += CurrInst.RotSpeed * elapsedTime;
         if (std::abs(CurrInst.Pos.x + CurrInst.MoveDir.x * elapsedTime) > 0.95)
         {
@@ -410,82 +417,8 @@ void Tutorial09_Quads::UpdateQuads(float elapsedTime)
     }
 }
 
-void Tutorial09_Quads::StartWorkerThreads(size_t NumThreads)
-{
-    m_WorkerThreads.resize(NumThreads);
-    for (Uint32 t = 0; t < m_WorkerThreads.size(); ++t)
-    {
-        m_WorkerThreads[t] = std::thread(WorkerThreadFunc, this, t);
-    }
-    m_CmdLists.resize(NumThreads);
-}
-
-void Tutorial09_Quads::StopWorkerThreads()
-{
-    m_RenderSubsetSignal.Trigger(true, -1);
-
-    for (auto& thread : m_WorkerThreads)
-    {
-        thread.join();
-    }
-    m_RenderSubsetSignal.Reset();
-    m_WorkerThreads.clear();
-    m_CmdLists.clear();
-}
-
-void Tutorial09_Quads::WorkerThreadFunc(Tutorial09_Quads* pThis, Uint32 ThreadNum)
-{
-    // Every thread should use its own deferred context
-    IDeviceContext* pDeferredCtx = pThis->m_pDeferredContexts[ThreadNum];
-
-    const int NumWorkerThreads = static_cast<int>(pThis->m_WorkerThreads.size());
-    VERIFY_EXPR(NumWorkerThreads > 0);
-    for (;;)
-    {
-        // Wait for the signal
-        auto SignaledValue = pThis->m_RenderSubsetSignal.Wait(true, NumWorkerThreads);
-        if (SignaledValue < 0)
-            return;
-
-        // Render current subset using the deferred context
-        if (pThis->m_BatchSize > 1)
-            pThis->RenderSubset<true>(pDeferredCtx, 1 + ThreadNum);
-        else
-            pThis->RenderSubset<false>(pDeferredCtx, 1 + ThreadNum);
-
-        // Finish command list
-        RefCntAutoPtr<ICommandList> pCmdList;
-        pDeferredCtx->FinishCommandList(&pCmdList);
-        pThis->m_CmdLists[ThreadNum] = pCmdList;
-
-        {
-            std::lock_guard<std::mutex> Lock{pThis->m_NumThreadsCompletedMtx};
-            // Increment the number of completed threads
-            ++pThis->m_NumThreadsCompleted;
-            if (pThis->m_NumThreadsCompleted == NumWorkerThreads)
-                pThis->m_ExecuteCommandListsSignal.Trigger();
-        }
-
-        pThis->m_GotoNextFrameSignal.Wait(true, NumWorkerThreads);
-
-        // Call FinishFrame() to release dynamic resources allocated by deferred contexts
-        // IMPORTANT: we must wait until the command lists are submitted for execution
-        // because FinishFrame() invalidates all dynamic resources
-        pDeferredCtx->FinishFrame();
-
-        ++pThis->m_NumThreadsReady;
-        // We must wait until all threads reach this point, because
-        // m_GotoNextFrameSignal must be unsignaled before we proceed to
-        // RenderSubsetSignal to avoid one thread go through the loop twice in
-        // a row
-        while (pThis->m_NumThreadsReady < NumWorkerThreads)
-            std::this_thread::yield();
-        VERIFY_EXPR(!pThis->m_GotoNextFrameSignal.IsTriggered());
-    }
-}
-
 template <bool UseBatch>
-void Tutorial09_Quads::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
+void Tutorial09_Quads::RenderSubset(IDeviceContext* pCtx, Uint32 StartBatch, Uint32 EndBatch)
 {
     // Deferred contexts start in default state. We must bind everything to the context
     // Render targets are set and transitioned to correct states by the main thread, here we only verify states
@@ -502,19 +435,15 @@ void Tutorial09_Quads::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
     DrawAttrs.Flags       = DRAW_FLAG_VERIFY_ALL;
     DrawAttrs.NumVertices = 4;
 
-    Uint32       NumSubsets   = Uint32{1} + static_cast<Uint32>(m_WorkerThreads.size());
-    const Uint32 TotalQuads   = static_cast<Uint32>(m_Quads.size());
-    const Uint32 TotalBatches = (TotalQuads + m_BatchSize - 1) / m_BatchSize;
-    const Uint32 SusbsetSize  = TotalBatches / NumSubsets;
-    const Uint32 StartBatch   = SusbsetSize * Subset;
-    const Uint32 EndBatch     = (Subset < NumSubsets - 1) ? SusbsetSize * (Subset + 1) : TotalBatches;
+    const auto&  Quads      = m_Quads[m_RenderSnapshotIdx];
+    const Uint32 TotalQuads = static_cast<Uint32>(Quads.size());
     for (Uint32 batch = StartBatch; batch < EndBatch; ++batch)
     {
         const Uint32 StartInst = batch * m_BatchSize;
-        const Uint32 EndInst   = std::min(StartInst + static_cast<Uint32>(m_BatchSize), static_cast<Uint32>(m_NumQuads));
+        const Uint32 EndInst   = std::min(StartInst + static_cast<Uint32>(m_BatchSize), TotalQuads);
 
         // Set the pipeline state
-        auto StateInd = m_Quads[StartInst].StateInd;
+        auto StateInd = Quads[StartInst].StateInd;
         pCtx->SetPipelineState(m_pPSO[UseBatch ? 1 : 0][StateInd]);
 
         MapHelper<InstanceData> BatchData;
@@ -526,7 +455,7 @@ void Tutorial09_Quads::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
 
         for (Uint32 inst = StartInst; inst < EndInst; ++inst)
         {
-            const auto& CurrInstData = m_Quads[inst];
+            const auto& CurrInstData = Quads[inst];
             // Shader resources have been explicitly transitioned to correct states, so
             // RESOURCE_STATE_TRANSITION_MODE_TRANSITION mode is not needed.
             // Instead, we use RESOURCE_STATE_TRANSITION_MODE_VERIFY mode to
@@ -594,33 +523,16 @@ void Tutorial09_Quads::Render()
     m_pImmediateContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
     m_pImmediateContext->ClearDepthStencil(pDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 
-    if (!m_WorkerThreads.empty())
-    {
-        m_NumThreadsCompleted = 0;
-        m_RenderSubsetSignal.Trigger(true);
-    }
-
-    if (m_BatchSize > 1)
-        RenderSubset<true>(m_pImmediateContext, 0);
-    else
-        RenderSubset<false>(m_pImmediateContext, 0);
-
-    if (!m_WorkerThreads.empty())
-    {
-        m_ExecuteCommandListsSignal.Wait(true, 1);
-
-        for (auto& cmdList : m_CmdLists)
-        {
-            m_pImmediateContext->ExecuteCommandList(cmdList);
-            // Release command lists now to release all outstanding references
-            // In d3d11 mode, command lists hold references to the swap chain's back buffer
-            // that cause swap chain resize to fail
-            cmdList.Release();
-        }
-
-        m_NumThreadsReady = 0;
-        m_GotoNextFrameSignal.Trigger(true);
-    }
+    const Uint32 TotalQuads   = static_cast<Uint32>(m_Quads[m_RenderSnapshotIdx].size());
+    const Uint32 TotalBatches = (TotalQuads + m_BatchSize - 1) / m_BatchSize;
+    // Batches are split into chunks that are recorded by the job system threads
+    RecordCommandsInParallel(TotalBatches,
+                             [this](IDeviceContext* pCtx, Uint32 /*CtxIdx*/, Uint32 StartBatch, Uint32 EndBatch) {
+                                 if (m_BatchSize > 1)
+                                     RenderSubset<true>(pCtx, StartBatch, EndBatch);
+                                 else
+                                     RenderSubset<false>(pCtx, StartBatch, EndBatch);
+                             });
 }
 
 void Tutorial09_Quads::CreateInstanceBuffer()
@@ -643,8 +555,11 @@ void Tutorial09_Quads::Update(double CurrTime, double ElapsedTime)
 {
     SampleBase::Update(CurrTime, ElapsedTime);
     UpdateUI();
+}
 
-    UpdateQuads(static_cast<float>(ElapsedTime));
+void Tutorial09_Quads::UpdateSimulation(double CurrTime, double ElapsedTime, Uint32 SnapshotIdx)
+{
+    UpdateQuads(static_cast<float>(ElapsedTime), SnapshotIdx);
 }
 
 } // namespace Diligent
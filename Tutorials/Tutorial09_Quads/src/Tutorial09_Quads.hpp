@@ -27,13 +27,9 @@
 
 #pragma once
 
-#include <atomic>
 #include <vector>
-#include <thread>
-#include <mutex>
 #include "SampleBase.hpp"
 #include "BasicMath.hpp"
-#include "ThreadSignal.hpp"
 
 namespace Diligent
 {
@@ -41,7 +37,6 @@ namespace Diligent
 class Tutorial09_Quads final : public SampleBase
 {
 public:
-    ~Tutorial09_Quads() override;
     virtual void GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
                                                 EngineCreateInfo&  Attribs,
                                                 SwapChainDesc&     SCDesc) override final;
@@ -55,6 +50,10 @@ public:
     virtual void Render() override final;
     virtual void Update(double CurrTime, double ElapsedTime) override final;
 
+    virtual bool SupportsPipelinedUpdate() const override final { return true; }
+    virtual void UpdateSimulation(double CurrTime, double ElapsedTime, Uint32 SnapshotIdx) override final;
+    virtual void SetRenderSnapshot(Uint32 SnapshotIdx) override final { m_RenderSnapshotIdx = SnapshotIdx; }
+
     virtual const Char* GetSampleName() const override final { return "Tutorial09: Quads"; }
 
 private:
@@ -64,24 +63,9 @@ private:
 
     void InitializeQuads();
     void CreateInstanceBuffer();
-    void UpdateQuads(float elapsedTime);
-    void StartWorkerThreads(size_t NumThreads);
-    void StopWorkerThreads();
+    void UpdateQuads(float elapsedTime, Uint32 SnapshotIdx);
     template <bool UseBatch>
-    void RenderSubset(IDeviceContext* pCtx, Uint32 Subset);
-
-    static void WorkerThreadFunc(Tutorial09_Quads* pThis, Uint32 ThreadNum);
-
-    ThreadingTools::Signal m_RenderSubsetSignal;
-    ThreadingTools::Signal m_ExecuteCommandListsSignal;
-    ThreadingTools::Signal m_GotoNextFrameSignal;
-
-    std::mutex      m_NumThreadsCompletedMtx;
-    std::atomic_int m_NumThreadsCompleted;
-    std::atomic_int m_NumThreadsReady;
-
-    std::vector<std::thread>                 m_WorkerThreads;
-    std::vector<RefCntAutoPtr<ICommandList>> m_CmdLists;
+    void RenderSubset(IDeviceContext* pCtx, Uint32 StartBatch, Uint32 EndBatch);
 
     static constexpr int          NumStates = 5;
     RefCntAutoPtr<IPipelineState> m_pPSO[2][NumStates];
@@ -110,7 +94,10 @@ private:
         int    TextureInd;
         int    StateInd;
     };
-    std::vector<QuadData> m_Quads;
+    // Every simulation step reads quads from the previous snapshot and writes them to the
+    // next one, while the render thread reads the snapshot selected by SetRenderSnapshot()
+    std::vector<QuadData> m_Quads[FramePipeline::NumSnapshots];
+    Uint32                m_RenderSnapshotIdx = 0;
 
     struct InstanceData
     {
@@ -29,13 +29,16 @@
 #include <string>
 #include <math.h>
 #include <algorithm>
+#include <thread>
 
 #include "Tutorial10_DataStreaming.hpp"
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -125,17 +128,13 @@ SampleBase* CreateSample()
     return new Tutorial10_DataStreaming();
 }
 
-Tutorial10_DataStreaming::~Tutorial10_DataStreaming()
-{
-    StopWorkerThreads();
-}
-
 void Tutorial10_DataStreaming::GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
                                                               EngineCreateInfo&  Attribs,
                                                               SwapChainDesc&     SCDesc)
 {
     SampleBase::GetEngineInitializationAttribs(DeviceType, Attribs, SCDesc);
-    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency() - 1, 2u);
+    // Every job system thread, including the main thread, records commands into its own deferred context
+    Attribs.NumDeferredContexts = std::max(std::thread::hardware_concurrency(), 2u);
 #if D3D12_SUPPORTED
     if (DeviceType == RENDER_DEVICE_TYPE_D3D12)
     {
@@ -209,7 +208,7 @@ void Tutorial10_DataStreaming::CreatePipelineStates(std::vector<StateTransitionD
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS, pVSBatched;
@@ -218,11 +217,11 @@ void Tutorial10_DataStreaming::CreatePipelineStates(std::vector<StateTransitionD
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Polygon VS";
         ShaderCI.FilePath        = "polygon.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
 
         ShaderCI.Desc.Name = "Polygon VS Batched";
         ShaderCI.FilePath  = "polygon_batch.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVSBatched);
+        m_pShaderCache->CreateShader(ShaderCI, &pVSBatched);
 
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
@@ -238,11 +237,11 @@ void Tutorial10_DataStreaming::CreatePipelineStates(std::vector<StateTransitionD
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Polygon PS";
         ShaderCI.FilePath        = "polygon.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
 
         ShaderCI.Desc.Name = "Polygon PS Batched";
         ShaderCI.FilePath  = "polygon_batch.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPSBatched);
+        m_pShaderCache->CreateShader(ShaderCI, &pPSBatched);
     }
 
     // clang-format off
@@ -346,7 +345,7 @@ void Tutorial10_DataStreaming::LoadTextures(std::vector<StateTransitionDesc>& Ba
         std::stringstream       FileNameSS;
         FileNameSS << "DGLogo" << tex << ".png";
         auto FileName = FileNameSS.str();
-        CreateTextureFromFile(FileName.c_str(), loadInfo, m_pDevice, &SrcTex);
+        CreateTextureFromFilePreferCooked(FileName.c_str(), loadInfo, m_pDevice, &SrcTex);
         // Get shader resource view from the texture
         m_TextureSRV[tex] = SrcTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
 
@@ -410,8 +409,7 @@ void Tutorial10_DataStreaming::UpdateUI()
             ImGuiScopedDisabler Disable(m_MaxThreads == 0);
             if (ImGui::SliderInt("Worker Threads", &m_NumWorkerThreads, 0, m_MaxThreads))
             {
-                StopWorkerThreads();
-                StartWorkerThreads(m_NumWorkerThreads);
+                SetNumWorkerThreads(m_NumWorkerThreads);
             }
         }
         if (m_pDevice->GetDeviceCaps().DevType == RENDER_DEVICE_TYPE_D3D12 ||
@@ -432,7 +430,7 @@ void Tutorial10_DataStreaming::Initialize(IEngineFactory*  pEngineFactory,
 {
     SampleBase::Initialize(pEngineFactory, pDevice, ppContexts, NumDeferredCtx, pSwapChain);
 
-    m_MaxThreads       = static_cast<int>(m_pDeferredContexts.size());
+    m_MaxThreads       = static_cast<int>(GetMaxWorkerThreads());
     m_NumWorkerThreads = std::min(4, m_MaxThreads);
 
     std::vector<StateTransitionDesc> Barriers;
@@ -454,7 +452,7 @@ void Tutorial10_DataStreaming::Initialize(IEngineFactory*  pEngineFactory,
     if (m_BatchSize > 1)
         CreateInstanceBuffer();
 
-    StartWorkerThreads(m_NumWorkerThreads);
+    SetNumWorkerThreads(m_NumWorkerThreads);
 }
 
 void Tutorial10_DataStreaming::InitializePolygonGeometry()
@@ -555,81 +553,8 @@ void Tutorial10_DataStreaming::UpdatePolygons(float elapsedTime)
     }
 }
 
-void Tutorial10_DataStreaming::StartWorkerThreads(size_t NumThreads)
-{
-    m_WorkerThreads.resize(NumThreads);
-    for (Uint32 t = 0; t < m_WorkerThreads.size(); ++t)
-    {
-        m_WorkerThreads[t] = std::thread(WorkerThreadFunc, this, t);
-    }
-    m_CmdLists.resize(NumThreads);
-}
-
-void Tutorial10_DataStreaming::StopWorkerThreads()
-{
-    m_RenderSubsetSignal.Trigger(true, -1);
-
-    for (auto& thread : m_WorkerThreads)
-    {
-        thread.join();
-    }
-    m_RenderSubsetSignal.Reset();
-    m_WorkerThreads.clear();
-    m_CmdLists.clear();
-}
-
-void Tutorial10_DataStreaming::WorkerThreadFunc(Tutorial10_DataStreaming* pThis, Uint32 ThreadNum)
-{
-    // Every thread should use its own deferred context
-    IDeviceContext* pDeferredCtx     = pThis->m_pDeferredContexts[ThreadNum];
-    const int       NumWorkerThreads = static_cast<int>(pThis->m_WorkerThreads.size());
-    VERIFY_EXPR(NumWorkerThreads > 0);
-    for (;;)
-    {
-        // Wait for the signal
-        auto SignaledValue = pThis->m_RenderSubsetSignal.Wait(true, NumWorkerThreads);
-        if (SignaledValue < 0)
-            return;
-
-        // Render current subset using the deferred context
-        if (pThis->m_BatchSize > 1)
-            pThis->RenderSubset<true>(pDeferredCtx, 1 + ThreadNum);
-        else
-            pThis->RenderSubset<false>(pDeferredCtx, 1 + ThreadNum);
-
-        // Finish command list
-        RefCntAutoPtr<ICommandList> pCmdList;
-        pDeferredCtx->FinishCommandList(&pCmdList);
-        pThis->m_CmdLists[ThreadNum] = pCmdList;
-
-        {
-            std::lock_guard<std::mutex> Lock{pThis->m_NumThreadsCompletedMtx};
-            // Increment the number of completed threads
-            ++pThis->m_NumThreadsCompleted;
-            if (pThis->m_NumThreadsCompleted == NumWorkerThreads)
-                pThis->m_ExecuteCommandListsSignal.Trigger();
-        }
-
-        pThis->m_GotoNextFrameSignal.Wait(true, NumWorkerThreads);
-
-        // Call FinishFrame() to release dynamic resources allocated by deferred contexts
-        // IMPORTANT: we must wait until the command lists are submitted for execution
-        // because FinishFrame() invalidates all dynamic resources
-        pDeferredCtx->FinishFrame();
-
-        ++pThis->m_NumThreadsReady;
-        // We must wait until all threads reach this point, because
-        // m_GotoNextFrameSignal must be unsignaled before we proceed to
-        // RenderSubsetSignal to avoid one thread go through the loop twice in
-        // a row
-        while (pThis->m_NumThreadsReady < NumWorkerThreads)
-            std::this_thread::yield();
-        VERIFY_EXPR(!pThis->m_GotoNextFrameSignal.IsTriggered());
-    }
-}
-
 template <bool UseBatch>
-void Tutorial10_DataStreaming::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
+void Tutorial10_DataStreaming::RenderSubset(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 StartBatch, Uint32 EndBatch)
 {
     // Deferred contexts start in default state. We must bind everything to the context
     // Render targets are set and transitioned to correct states by the main thread, here we only verify states
@@ -640,23 +565,18 @@ void Tutorial10_DataStreaming::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
     DrawAttrs.IndexType = VT_UINT32;
     DrawAttrs.Flags     = DRAW_FLAG_VERIFY_ALL;
 
-    Uint32       NumSubsets    = Uint32{1} + static_cast<Uint32>(m_WorkerThreads.size());
     const Uint32 TotalPolygons = static_cast<Uint32>(m_Polygons.size());
-    const Uint32 TotalBatches  = (TotalPolygons + m_BatchSize - 1) / m_BatchSize;
-    const Uint32 SusbsetSize   = TotalBatches / NumSubsets;
-    const Uint32 StartBatch    = SusbsetSize * Subset;
-    const Uint32 EndBatch      = (Subset < NumSubsets - 1) ? SusbsetSize * (Subset + 1) : TotalBatches;
     for (Uint32 batch = StartBatch; batch < EndBatch; ++batch)
     {
         const Uint32 StartInst = batch * m_BatchSize;
-        const Uint32 EndInst   = std::min(StartInst + static_cast<Uint32>(m_BatchSize), static_cast<Uint32>(m_NumPolygons));
+        const Uint32 EndInst   = std::min(StartInst + static_cast<Uint32>(m_BatchSize), TotalPolygons);
 
         // Set pipeline state
         auto StateInd = m_Polygons[StartInst].StateInd;
         pCtx->SetPipelineState(m_pPSO[UseBatch ? 1 : 0][StateInd]);
 
         const auto& PolygonGeo = m_PolygonGeo[m_Polygons[StartInst].NumVerts];
-        auto        Offsets    = WritePolygon(PolygonGeo, pCtx, Subset);
+        auto        Offsets    = WritePolygon(PolygonGeo, pCtx, CtxIdx);
         Uint32      offsets[]  = {Offsets.first, 0};
         IBuffer*    pBuffs[]   = {m_StreamingVB->GetBuffer(), m_BatchDataBuffer};
         pCtx->SetVertexBuffers(0, UseBatch ? 2 : 1, pBuffs, offsets, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
@@ -731,8 +651,8 @@ void Tutorial10_DataStreaming::RenderSubset(IDeviceContext* pCtx, Uint32 Subset)
         pCtx->DrawIndexed(DrawAttrs);
     }
 
-    m_StreamingVB->Flush(Subset);
-    m_StreamingIB->Flush(Subset);
+    m_StreamingVB->Flush(CtxIdx);
+    m_StreamingIB->Flush(CtxIdx);
 }
 
 // Render a frame
@@ -748,33 +668,16 @@ void Tutorial10_DataStreaming::Render()
     m_StreamingIB->AllowPersistentMapping(m_bAllowPersistentMap);
     m_StreamingVB->AllowPersistentMapping(m_bAllowPersistentMap);
 
-    if (!m_WorkerThreads.empty())
-    {
-        m_NumThreadsCompleted = 0;
-        m_RenderSubsetSignal.Trigger(true);
-    }
-
-    if (m_BatchSize > 1)
-        RenderSubset<true>(m_pImmediateContext, 0);
-    else
-        RenderSubset<false>(m_pImmediateContext, 0);
-
-    if (!m_WorkerThreads.empty())
-    {
-        m_ExecuteCommandListsSignal.Wait(true, 1);
-
-        for (auto& cmdList : m_CmdLists)
-        {
-            m_pImmediateContext->ExecuteCommandList(cmdList);
-            // Release command lists now to release all outstanding references
-            // In d3d11 mode, command lists hold references to the swap chain's back buffer
-            // that cause swap chain resize to fail
-            cmdList.Release();
-        }
-
-        m_NumThreadsReady = 0;
-        m_GotoNextFrameSignal.Trigger(true);
-    }
+    const Uint32 TotalPolygons = static_cast<Uint32>(m_Polygons.size());
+    const Uint32 TotalBatches  = (TotalPolygons + m_BatchSize - 1) / m_BatchSize;
+    // Batches are split into chunks that are recorded by the job system threads
+    RecordCommandsInParallel(TotalBatches,
+                             [this](IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 StartBatch, Uint32 EndBatch) {
+                                 if (m_BatchSize > 1)
+                                     RenderSubset<true>(pCtx, CtxIdx, StartBatch, EndBatch);
+                                 else
+                                     RenderSubset<false>(pCtx, CtxIdx, StartBatch, EndBatch);
+                             });
 }
 
 void Tutorial10_DataStreaming::CreateInstanceBuffer()
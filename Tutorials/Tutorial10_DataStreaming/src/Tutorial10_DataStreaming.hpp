@@ -27,14 +27,10 @@
 
 #pragma once
 
-#include <atomic>
 #include <memory>
 #include <vector>
-#include <thread>
-#include <mutex>
 #include "SampleBase.hpp"
 #include "BasicMath.hpp"
-#include "ThreadSignal.hpp"
 
 namespace Diligent
 {
@@ -42,7 +38,6 @@ namespace Diligent
 class Tutorial10_DataStreaming final : public SampleBase
 {
 public:
-    ~Tutorial10_DataStreaming() override;
     virtual void GetEngineInitializationAttribs(RENDER_DEVICE_TYPE DeviceType,
                                                 EngineCreateInfo&  Attribs,
                                                 SwapChainDesc&     SCDesc) override final;
@@ -67,25 +62,9 @@ private:
     void InitializePolygonGeometry();
     void CreateInstanceBuffer();
     void UpdatePolygons(float elapsedTime);
-    void StartWorkerThreads(size_t NumThreads);
-    void StopWorkerThreads();
 
     template <bool UseBatch>
-    void RenderSubset(IDeviceContext* pCtx, Uint32 Subset);
-
-    static void WorkerThreadFunc(Tutorial10_DataStreaming* pThis, Uint32 ThreadNum);
-
-    ThreadingTools::Signal m_RenderSubsetSignal;
-    ThreadingTools::Signal m_ExecuteCommandListsSignal;
-    ThreadingTools::Signal m_GotoNextFrameSignal;
-
-    std::mutex      m_NumThreadsCompletedMtx;
-    std::atomic_int m_NumThreadsCompleted;
-    std::atomic_int m_NumThreadsReady;
-
-    std::vector<std::thread> m_WorkerThreads;
-
-    std::vector<RefCntAutoPtr<ICommandList>> m_CmdLists;
+    void RenderSubset(IDeviceContext* pCtx, Uint32 CtxIdx, Uint32 StartBatch, Uint32 EndBatch);
 
     static constexpr const int    NumStates = 5;
     RefCntAutoPtr<IPipelineState> m_pPSO[2][NumStates];
@@ -32,6 +32,8 @@
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -142,7 +144,7 @@ void Tutorial11_ResourceUpdates::CreatePipelineStates()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -151,7 +153,7 @@ void Tutorial11_ResourceUpdates::CreatePipelineStates()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = "cube.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
         CreateUniformBuffer(m_pDevice, sizeof(float4x4), "VS constants CB", &m_VSConstants);
@@ -164,7 +166,7 @@ void Tutorial11_ResourceUpdates::CreatePipelineStates()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = "cube.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     // clang-format off
@@ -302,7 +304,7 @@ void Tutorial11_ResourceUpdates::LoadTextures()
         }
 
         auto& Tex = m_Textures[i];
-        CreateTextureFromFile(FileName.c_str(), loadInfo, m_pDevice, &Tex);
+        CreateTextureFromFilePreferCooked(FileName.c_str(), loadInfo, m_pDevice, &Tex);
         // Get shader resource view from the texture
         auto TextureSRV = Tex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
 
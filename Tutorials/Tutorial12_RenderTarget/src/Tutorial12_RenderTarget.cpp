@@ -31,6 +31,7 @@
 #include "TextureUtilities.h"
 #include "CommonlyUsedStates.h"
 #include "../../Common/src/TexturedCube.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -54,9 +55,10 @@ void Tutorial12_RenderTarget::CreateCubePSO()
 {
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     m_pCubePSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                                   m_pShaderCache,
                                                    RenderTargetFormat,
                                                    DepthBufferFormat,
                                                    pShaderSourceFactory,
@@ -111,7 +113,7 @@ void Tutorial12_RenderTarget::CreateRenderTargetPSO()
     // In this tutorial, we will load shaders from file. To be able to do that,
     // we need to create a shader source stream factory
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
 
     // Create a vertex shader
@@ -121,7 +123,7 @@ void Tutorial12_RenderTarget::CreateRenderTargetPSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Render Target VS";
         ShaderCI.FilePath        = "rendertarget.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pRTVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pRTVS);
     }
 
     // Create a pixel shader
@@ -132,7 +134,7 @@ void Tutorial12_RenderTarget::CreateRenderTargetPSO()
         ShaderCI.Desc.Name       = "Render Target PS";
         ShaderCI.FilePath        = "rendertarget.psh";
 
-        m_pDevice->CreateShader(ShaderCI, &pRTPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pRTPS);
 
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
@@ -194,16 +196,27 @@ void Tutorial12_RenderTarget::Initialize(IEngineFactory*  pEngineFactory,
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
     m_CubeIndexBuffer  = TexturedCube::CreateIndexBuffer(pDevice);
-    m_CubeTextureSRV   = TexturedCube::LoadTexture(pDevice, "DGLogo.png")->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-    // Set cube texture SRV in the SRB
-    m_pCubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_CubeTextureSRV);
+    // Load the texture in the background. Mutable variables can only be set once, so a new SRB
+    // is created when the placeholder texture is replaced with the loaded one.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_CubeTextureSRV = pTextureSRV;
+        m_pCubeSRB.Release();
+        m_pCubePSO->CreateShaderResourceBinding(&m_pCubeSRB, true);
+        // Set cube texture SRV in the SRB
+        m_pCubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_CubeTextureSRV);
+    });
 }
 
 void Tutorial12_RenderTarget::WindowResize(Uint32 Width, Uint32 Height)
 {
-    // Create window-size offscreen render target
-    RefCntAutoPtr<ITexture> pRTColor;
-    TextureDesc             RTColorDesc;
+    // Return the render targets to the pool, so that they are reused if the size has not changed.
+    // Render targets of the old size are released by the pool once they are unused.
+    m_pColorRTV.Release();
+    m_pDepthDSV.Release();
+    m_pRTSRB.Release();
+
+    // Allocate window-size offscreen render target from the pool
+    TextureDesc RTColorDesc;
     RTColorDesc.Name      = "Offscreen render target";
     RTColorDesc.Type      = RESOURCE_DIM_TEX_2D;
     RTColorDesc.Width     = m_pSwapChain->GetDesc().Width;
@@ -218,28 +231,26 @@ void Tutorial12_RenderTarget::WindowResize(Uint32 Width, Uint32 Height)
     RTColorDesc.ClearValue.Color[1] = 0.350f;
     RTColorDesc.ClearValue.Color[2] = 0.350f;
     RTColorDesc.ClearValue.Color[3] = 1.f;
-    m_pDevice->CreateTexture(RTColorDesc, nullptr, &pRTColor);
+    auto pRTColor                   = m_pRenderTargetPool->Acquire(RTColorDesc);
     // Store the render target view
     m_pColorRTV = pRTColor->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
 
 
-    // Create window-size depth buffer
-    RefCntAutoPtr<ITexture> pRTDepth;
-    TextureDesc             RTDepthDesc = RTColorDesc;
-    RTDepthDesc.Name                    = "Offscreen depth buffer";
-    RTDepthDesc.Format                  = DepthBufferFormat;
+    // Allocate window-size depth buffer
+    TextureDesc RTDepthDesc = RTColorDesc;
+    RTDepthDesc.Name        = "Offscreen depth buffer";
+    RTDepthDesc.Format      = DepthBufferFormat;
     // Define optimal clear value
     RTDepthDesc.ClearValue.Format               = RTDepthDesc.Format;
     RTDepthDesc.ClearValue.DepthStencil.Depth   = 1;
     RTDepthDesc.ClearValue.DepthStencil.Stencil = 0;
     // The depth buffer can be bound as a shader resource and as a depth-stencil buffer
     RTDepthDesc.BindFlags = BIND_SHADER_RESOURCE | BIND_DEPTH_STENCIL;
-    m_pDevice->CreateTexture(RTDepthDesc, nullptr, &pRTDepth);
+    auto pRTDepth         = m_pRenderTargetPool->Acquire(RTDepthDesc);
     // Store the depth-stencil view
     m_pDepthDSV = pRTDepth->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
 
-    // We need to release and create a new SRB that references new off-screen render target SRV
-    m_pRTSRB.Release();
+    // We need to create a new SRB that references new off-screen render target SRV
     m_pRTPSO->CreateShaderResourceBinding(&m_pRTSRB, true);
 
     // Set render target color texture SRV in the SRB
@@ -35,6 +35,7 @@
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
 #include "imGuIZMO.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -48,7 +49,7 @@ void Tutorial13_ShadowMap::CreateCubePSO()
 {
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     // clang-format off
     // Define vertex shader input layout
@@ -64,6 +65,7 @@ void Tutorial13_ShadowMap::CreateCubePSO()
     // clang-format on
 
     m_pCubePSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                                   m_pShaderCache,
                                                    m_pSwapChain->GetDesc().ColorBufferFormat,
                                                    m_pSwapChain->GetDesc().DepthBufferFormat,
                                                    pShaderSourceFactory,
@@ -116,7 +118,7 @@ void Tutorial13_ShadowMap::CreateCubePSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube Shadow VS";
         ShaderCI.FilePath        = "cube_shadow.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pShadowVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pShadowVS);
     }
     PSODesc.GraphicsPipeline.pVS = pShadowVS;
 
@@ -173,7 +175,7 @@ void Tutorial13_ShadowMap::CreatePlanePSO()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create plane vertex shader
     RefCntAutoPtr<IShader> pPlaneVS;
@@ -182,7 +184,7 @@ void Tutorial13_ShadowMap::CreatePlanePSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Plane VS";
         ShaderCI.FilePath        = "plane.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pPlaneVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPlaneVS);
     }
 
     // Create plane pixel shader
@@ -192,7 +194,7 @@ void Tutorial13_ShadowMap::CreatePlanePSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Plane PS";
         ShaderCI.FilePath        = "plane.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPlanePS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPlanePS);
     }
 
     PSODesc.GraphicsPipeline.pVS = pPlaneVS;
@@ -268,7 +270,7 @@ void Tutorial13_ShadowMap::CreateShadowMapVisPSO()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create shadow map visualization vertex shader
     RefCntAutoPtr<IShader> pShadowMapVisVS;
@@ -277,7 +279,7 @@ void Tutorial13_ShadowMap::CreateShadowMapVisPSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Shadow Map Vis VS";
         ShaderCI.FilePath        = "shadow_map_vis.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pShadowMapVisVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pShadowMapVisVS);
     }
 
     // Create shadow map visualization pixel shader
@@ -287,7 +289,7 @@ void Tutorial13_ShadowMap::CreateShadowMapVisPSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Shadow Map Vis PS";
         ShaderCI.FilePath        = "shadow_map_vis.psh";
-        m_pDevice->CreateShader(ShaderCI, &pShadowMapVisPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pShadowMapVisPS);
     }
 
     PSODesc.GraphicsPipeline.pVS = pShadowMapVisVS;
@@ -435,11 +437,14 @@ void Tutorial13_ShadowMap::Initialize(IEngineFactory*  pEngineFactory,
     // Explicitly transition vertex and index buffers to required states
     Barriers.emplace_back(m_CubeVertexBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true);
     Barriers.emplace_back(m_CubeIndexBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, true);
-    // Load texture
-    auto CubeTexture = TexturedCube::LoadTexture(pDevice, "DGLogo.png");
-    m_CubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(CubeTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
-    // Transition the texture to shader resource state
-    Barriers.emplace_back(CubeTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, true);
+    // Load the texture in the background. The texture loader transitions both the placeholder and the loaded
+    // texture to shader resource state. Mutable variables can only be set once, so a new SRB is created
+    // when the placeholder texture is replaced with the loaded one.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_CubeSRB.Release();
+        m_pCubePSO->CreateShaderResourceBinding(&m_CubeSRB, true);
+        m_CubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(pTextureSRV);
+    });
 
     CreateShadowMap();
 
@@ -32,6 +32,7 @@
 #include "MapHelper.hpp"
 #include "imgui.h"
 #include "ShaderMacroHelper.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -100,7 +101,7 @@ void Tutorial14_ComputeShader::CreateRenderParticlePSO()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create particle vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -109,7 +110,7 @@ void Tutorial14_ComputeShader::CreateRenderParticlePSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Particle VS";
         ShaderCI.FilePath        = "particle.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
     }
 
     // Create particle pixel shader
@@ -119,7 +120,7 @@ void Tutorial14_ComputeShader::CreateRenderParticlePSO()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Particle PS";
         ShaderCI.FilePath        = "particle.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
     }
 
     PSODesc.GraphicsPipeline.pVS = pVS;
@@ -155,7 +156,7 @@ void Tutorial14_ComputeShader::CreateUpdateParticlePSO()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
 
     ShaderMacroHelper Macros;
@@ -169,7 +170,7 @@ void Tutorial14_ComputeShader::CreateUpdateParticlePSO()
         ShaderCI.Desc.Name       = "Reset particle lists CS";
         ShaderCI.FilePath        = "reset_particle_lists.csh";
         ShaderCI.Macros          = Macros;
-        m_pDevice->CreateShader(ShaderCI, &pResetParticleListsCS);
+        m_pShaderCache->CreateShader(ShaderCI, &pResetParticleListsCS);
     }
 
     RefCntAutoPtr<IShader> pMoveParticlesCS;
@@ -179,7 +180,7 @@ void Tutorial14_ComputeShader::CreateUpdateParticlePSO()
         ShaderCI.Desc.Name       = "Move particles CS";
         ShaderCI.FilePath        = "move_particles.csh";
         ShaderCI.Macros          = Macros;
-        m_pDevice->CreateShader(ShaderCI, &pMoveParticlesCS);
+        m_pShaderCache->CreateShader(ShaderCI, &pMoveParticlesCS);
     }
 
     RefCntAutoPtr<IShader> pCollideParticlesCS;
@@ -189,7 +190,7 @@ void Tutorial14_ComputeShader::CreateUpdateParticlePSO()
         ShaderCI.Desc.Name       = "Collide particles CS";
         ShaderCI.FilePath        = "collide_particles.csh";
         ShaderCI.Macros          = Macros;
-        m_pDevice->CreateShader(ShaderCI, &pCollideParticlesCS);
+        m_pShaderCache->CreateShader(ShaderCI, &pCollideParticlesCS);
     }
 
     RefCntAutoPtr<IShader> pUpdatedSpeedCS;
@@ -200,7 +201,7 @@ void Tutorial14_ComputeShader::CreateUpdateParticlePSO()
         ShaderCI.FilePath        = "collide_particles.csh";
         Macros.AddShaderMacro("UPDATE_SPEED", 1);
         ShaderCI.Macros = Macros;
-        m_pDevice->CreateShader(ShaderCI, &pUpdatedSpeedCS);
+        m_pShaderCache->CreateShader(ShaderCI, &pUpdatedSpeedCS);
     }
 
     PipelineStateDesc PSODesc;
@@ -32,9 +32,11 @@
 #include "MapHelper.hpp"
 #include "GraphicsUtilities.h"
 #include "TextureUtilities.h"
+#include "CookedTextures.hpp"
 #include "ShaderMacroHelper.hpp"
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -93,7 +95,7 @@ void Tutorial16_BindlessResources::CreatePipelineState()
 
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
     ShaderCI.pShaderSourceStreamFactory = pShaderSourceFactory;
     // Create a vertex shader
     RefCntAutoPtr<IShader> pVS;
@@ -102,7 +104,7 @@ void Tutorial16_BindlessResources::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube VS";
         ShaderCI.FilePath        = "cube.vsh";
-        m_pDevice->CreateShader(ShaderCI, &pVS);
+        m_pShaderCache->CreateShader(ShaderCI, &pVS);
         // Create dynamic uniform buffer that will store our transformation matrix
         // Dynamic buffers can be frequently updated by the CPU
         CreateUniformBuffer(m_pDevice, sizeof(float4x4) * 2, "VS constants CB", &m_VSConstants);
@@ -117,7 +119,7 @@ void Tutorial16_BindlessResources::CreatePipelineState()
         ShaderCI.EntryPoint      = "main";
         ShaderCI.Desc.Name       = "Cube PS";
         ShaderCI.FilePath        = "cube.psh";
-        m_pDevice->CreateShader(ShaderCI, &pPS);
+        m_pShaderCache->CreateShader(ShaderCI, &pPS);
 
         if (m_pDevice->GetDeviceCaps().Features.BindlessResources)
         {
@@ -125,7 +127,7 @@ void Tutorial16_BindlessResources::CreatePipelineState()
             Macros.AddShaderMacro("BINDLESS", 1);
             Macros.AddShaderMacro("NUM_TEXTURES", NumTextures);
             ShaderCI.Macros = Macros;
-            m_pDevice->CreateShader(ShaderCI, &pBindlessPS);
+            m_pShaderCache->CreateShader(ShaderCI, &pBindlessPS);
             ShaderCI.Macros = nullptr;
         }
     }
@@ -425,7 +427,7 @@ void Tutorial16_BindlessResources::LoadTextures()
         std::stringstream FileNameSS;
         FileNameSS << "DGLogo" << tex << ".png";
         auto FileName = FileNameSS.str();
-        CreateTextureFromFile(FileName.c_str(), loadInfo, m_pDevice, &pTex[tex]);
+        CreateTextureFromFilePreferCooked(FileName.c_str(), loadInfo, m_pDevice, &pTex[tex]);
 
         // Get shader resource view from the texture
         auto* pTextureSRV = pTex[tex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
@@ -34,6 +34,7 @@
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
 #include "ImGuiUtils.hpp"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -47,9 +48,10 @@ void Tutorial17_MSAA::CreateCubePSO()
 {
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     m_pCubePSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                                   m_pShaderCache,
                                                    m_pSwapChain->GetDesc().ColorBufferFormat,
                                                    DepthBufferFormat,
                                                    pShaderSourceFactory,
@@ -90,7 +92,7 @@ void Tutorial17_MSAA::UpdateUI()
         if (ImGui::Combo("Sample count", &m_SampleCount, ComboItems.data(), NumItems))
         {
             CreateCubePSO();
-            CreateMSAARenderTarget();
+            ReleaseMSAARenderTarget();
         }
 
         ImGui::Checkbox("Rotate gird", &m_bRotateGrid);
@@ -126,23 +128,39 @@ void Tutorial17_MSAA::Initialize(IEngineFactory*  pEngineFactory,
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
     m_CubeIndexBuffer  = TexturedCube::CreateIndexBuffer(pDevice);
-    m_CubeTextureSRV   = TexturedCube::LoadTexture(pDevice, "DGLogo.png")->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+
+    // Load the texture in the background. CreateCubePSO() binds the placeholder texture, and a new SRB
+    // is created when it is replaced with the loaded one, since mutable variables can only be set once.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_CubeTextureSRV = pTextureSRV;
+        if (!m_pCubePSO)
+            return;
+        m_pCubeSRB.Release();
+        m_pCubePSO->CreateShaderResourceBinding(&m_pCubeSRB, true);
+        m_pCubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_CubeTextureSRV);
+    });
 
     CreateCubePSO();
 }
 
 void Tutorial17_MSAA::WindowResize(Uint32 Width, Uint32 Height)
 {
-    CreateMSAARenderTarget();
+    // Window may be resized many times between frames, so the render target of the
+    // new size is only allocated when the next frame is rendered
+    ReleaseMSAARenderTarget();
 }
 
-void Tutorial17_MSAA::CreateMSAARenderTarget()
+void Tutorial17_MSAA::ReleaseMSAARenderTarget()
 {
-    if (m_SampleCount == 1)
-        return;
+    // Textures are returned to the render target pool when the last view is released
+    m_pMSColorRTV.Release();
+    m_pMSDepthDSV.Release();
+}
 
+void Tutorial17_MSAA::CreateMSAARenderTarget()
+{
     const auto& SCDesc = m_pSwapChain->GetDesc();
-    // Create window-size multi-sampled offscreen render target
+    // Allocate window-size multi-sampled offscreen render target from the pool
     TextureDesc ColorDesc;
     ColorDesc.Name           = "Multisampled render target";
     ColorDesc.Type           = RESOURCE_DIM_TEX_2D;
@@ -168,11 +186,9 @@ void Tutorial17_MSAA::CreateMSAARenderTarget()
     ColorDesc.ClearValue.Color[1] = 0.125f;
     ColorDesc.ClearValue.Color[2] = 0.125f;
     ColorDesc.ClearValue.Color[3] = 1.f;
-    RefCntAutoPtr<ITexture> pColor;
-    m_pDevice->CreateTexture(ColorDesc, nullptr, &pColor);
+    auto pColor                   = m_pRenderTargetPool->Acquire(ColorDesc);
 
     // Store the render target view
-    m_pMSColorRTV.Release();
     if (NeedsSRGBConversion)
     {
         TextureViewDesc RTVDesc;
@@ -186,7 +202,7 @@ void Tutorial17_MSAA::CreateMSAARenderTarget()
     }
 
 
-    // Create window-size multi-sampled depth buffer
+    // Allocate window-size multi-sampled depth buffer from the pool
     TextureDesc DepthDesc = ColorDesc;
     DepthDesc.Name        = "Multisampled depth buffer";
     DepthDesc.Format      = DepthBufferFormat;
@@ -196,8 +212,7 @@ void Tutorial17_MSAA::CreateMSAARenderTarget()
     DepthDesc.ClearValue.DepthStencil.Depth   = 1;
     DepthDesc.ClearValue.DepthStencil.Stencil = 0;
 
-    RefCntAutoPtr<ITexture> pDepth;
-    m_pDevice->CreateTexture(DepthDesc, nullptr, &pDepth);
+    auto pDepth = m_pRenderTargetPool->Acquire(DepthDesc);
     // Store the depth-stencil view
     m_pMSDepthDSV = pDepth->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL);
 }
@@ -211,6 +226,9 @@ void Tutorial17_MSAA::Render()
     ITextureView* pDSV = nullptr;
     if (m_SampleCount > 1)
     {
+        if (!m_pMSColorRTV)
+            CreateMSAARenderTarget();
+
         // Set off-screen multi-sampled render target and depth-stencil buffer
         pRTV = m_pMSColorRTV;
         pDSV = m_pMSDepthDSV;
@@ -53,6 +53,7 @@ private:
     void CreateCubePSO();
     void UpdateUI();
     void CreateMSAARenderTarget();
+    void ReleaseMSAARenderTarget();
 
     static constexpr TEXTURE_FORMAT DepthBufferFormat = TEX_FORMAT_D32_FLOAT;
 
@@ -64,7 +65,7 @@ private:
     RefCntAutoPtr<IBuffer>                m_CubeVSConstants;
     RefCntAutoPtr<ITextureView>           m_CubeTextureSRV;
 
-    // Offscreen multi-sampled render target and depth-stencil
+    // Offscreen multi-sampled render target and depth-stencil allocated from the render target pool
     RefCntAutoPtr<ITextureView> m_pMSColorRTV;
     RefCntAutoPtr<ITextureView> m_pMSDepthDSV;
 
@@ -34,6 +34,7 @@
 #include "CommonlyUsedStates.h"
 #include "../../Common/src/TexturedCube.hpp"
 #include "imgui.h"
+#include "AssetArchive.hpp"
 
 namespace Diligent
 {
@@ -47,9 +48,10 @@ void Tutorial18_Queries::CreateCubePSO()
 {
     // Create a shader source stream factory to load shaders from files.
     RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pEngineFactory->CreateDefaultShaderSourceStreamFactory(nullptr, &pShaderSourceFactory);
+    CreateAssetShaderSourceStreamFactory(m_pEngineFactory, nullptr, &pShaderSourceFactory);
 
     m_pCubePSO = TexturedCube::CreatePipelineState(m_pDevice,
+                                                   m_pShaderCache,
                                                    m_pSwapChain->GetDesc().ColorBufferFormat,
                                                    m_pSwapChain->GetDesc().DepthBufferFormat,
                                                    pShaderSourceFactory,
@@ -83,9 +85,15 @@ void Tutorial18_Queries::Initialize(IEngineFactory*  pEngineFactory,
     // Load textured cube
     m_CubeVertexBuffer = TexturedCube::CreateVertexBuffer(pDevice);
     m_CubeIndexBuffer  = TexturedCube::CreateIndexBuffer(pDevice);
-    m_CubeTextureSRV   = TexturedCube::LoadTexture(pDevice, "DGLogo.png")->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-    // Set cube texture SRV in the SRB
-    m_pCubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_CubeTextureSRV);
+    // Load the texture in the background. Mutable variables can only be set once, so a new SRB
+    // is created when the placeholder texture is replaced with the loaded one.
+    TexturedCube::LoadTexture(m_pTextureLoader, "DGLogo.png", [this](ITextureView* pTextureSRV) {
+        m_CubeTextureSRV = pTextureSRV;
+        m_pCubeSRB.Release();
+        m_pCubePSO->CreateShaderResourceBinding(&m_pCubeSRB, true);
+        // Set cube texture SRV in the SRB
+        m_pCubeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_CubeTextureSRV);
+    });
 
     // Check query support
     const auto& Features = pDevice->GetDeviceCaps().Features;